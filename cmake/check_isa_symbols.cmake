@@ -0,0 +1,23 @@
+# Fails if an object of an ISA-specific translation unit defines a weak
+# symbol. The linker may pick such a symbol (an inline function or template
+# instance, e.g. std::exp(float) at -O0) for every caller, including
+# baseline code on CPUs without the ISA.
+#
+# cmake -DNM=<nm> -DOBJECTS=<a;b;...> -P check_isa_symbols.cmake
+foreach(object ${OBJECTS})
+  if(NOT object MATCHES "/kernels/cpu/x86/")
+    continue()
+  endif()
+  execute_process(
+    COMMAND ${NM} --defined-only -C ${object}
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${object}")
+  endif()
+  string(REGEX MATCHALL "[^\n]* [VWu] [^\n]*" weak "${symbols}")
+  if(weak)
+    list(JOIN weak "\n  " lines)
+    message(FATAL_ERROR "${object} exports weak symbols:\n  ${lines}")
+  endif()
+endforeach()
@@ -0,0 +1,50 @@
+#pragma once
+#include "core/graph.h"
+#include <functional>
+
+namespace infini {
+
+/**
+ * @brief The ops of a graph with their kernels and arguments resolved once,
+ * made by NativeCpuRuntimeObj::compile and run by NativeCpuRuntimeObj::run.
+ *
+ * Each step holds the closure Kernel::prepare returned for its op, so a run
+ * does no kernel lookup and no shape or pointer derivation. The data
+ * pointers are bound when the plan is compiled: the graph must have been
+ * allocated by dataMalloc before, and must be compiled again if it is
+ * allocated again or its shapes change. The plan keeps the graph alive and
+ * never changes, so several threads may run it, though not at the same time
+ * on the same tensors.
+ *
+ * The steps also record which of them must finish before each can start:
+ * the producers of its inputs, and the steps that came before it in the
+ * graph and touch memory it writes or write memory it reads, as dataMalloc
+ * reuses the buffers of dead tensors in graph order. Steps without such a
+ * chain between them may run concurrently.
+ */
+class ExecutionPlan {
+  public:
+    struct Step {
+        std::function<void()> fn;
+        Operator op;
+        // Name of the kernel, for the profiler.
+        const string *kernel;
+        // Steps this one waits for, and the later ones waiting for it.
+        int numPredecessors;
+        vector<int> successors;
+    };
+
+  private:
+    Graph graph;
+    vector<Step> steps;
+
+  public:
+    ExecutionPlan(Graph graph, vector<Step> steps)
+        : graph(std::move(graph)), steps(std::move(steps)) {}
+
+    const Graph &getGraph() const { return graph; }
+    const vector<Step> &getSteps() const { return steps; }
+    size_t size() const { return steps.size(); }
+};
+
+} // namespace infini
@@ -55,7 +55,26 @@ namespace infini
 
         void shape_infer();
 
-        void dataMalloc();
+        /**
+         * @brief Plan and allocate the memory of all tensors. With `inPlace`,
+         * element-wise ops (see canRunInPlace in graph.cc) write their output
+         * over an input of the same shape and size that dies at them. With
+         * `reuse` false no buffer is handed on to a later tensor once its
+         * readers are done, so that ops on independent branches share no
+         * memory and can run concurrently (NativeCpuRuntimeObj::setThreads),
+         * at the cost of a higher peak. Graph inputs already bound to memory
+         * by setDataBlob keep it, and the memory of graph inputs is never
+         * handed on to another tensor, so that each run reads the values
+         * the caller set.
+         */
+        void dataMalloc(bool inPlace = true, bool reuse = true);
+
+        /**
+         * @brief A copy of the graph with new tensors of the same shapes and
+         * types, in the same order, and clones of the ops. The copy holds no
+         * data and is allocated on its own.
+         */
+        Graph clone() const;
 
         /**
          * @brief Add an operator and create its outputs. Output tensor arguments
@@ -112,6 +131,14 @@ namespace infini
          */
         void addOperatorAndConnect(const Operator &op);
 
+        /**
+         * @brief Replace chains of Float32 element-wise and unary ops, whose
+         * intermediate results have the shape of the final one and no other
+         * readers, by FusedElementWise ops, linked to the predecessors and
+         * successors of the chains. Part of optimize().
+         */
+        void fuseElementWise();
+
         /**
          * @brief If the nodes is sorted in topological order.
          */
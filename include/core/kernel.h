@@ -21,6 +21,19 @@ namespace infini
          */
         virtual void compute(const Operator &op,
                              const RuntimeObj *context) const = 0;
+
+        /**
+         * @brief Resolves what compute() derives from op on every call, such
+         * as its shapes, strides and data pointers, and returns a closure
+         * that runs op with them. The closure stays valid as long as the
+         * tensors of op keep their shapes and memory. By default it just
+         * calls compute().
+         */
+        virtual std::function<void()> prepare(const Operator &op,
+                                              const RuntimeObj *context) const
+        {
+            return [this, op, context] { compute(op, context); };
+        }
     };
 
     class KernelRegistry
@@ -26,6 +26,28 @@ namespace infini
             Relu,
             Sub,
             Transpose,
+            Erf,
+            Exp,
+            Gelu,
+            Sigmoid,
+            Silu,
+            Tanh,
+            FusedElementWise,
+            QuantizeLinear,
+            DequantizeLinear,
+            ReduceSum,
+            ReduceMean,
+            ReduceMax,
+            ReduceMin,
+            Softmax,
+            LayerNormalization,
+            RMSNormalization,
+            Conv,
+            MaxPool,
+            AveragePool,
+            GlobalAveragePool,
+            Gather,
+            EmbeddingBag,
 
         } type;
 
@@ -0,0 +1,84 @@
+#pragma once
+#include "core/execution_plan.h"
+#include "core/runtime.h"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+
+namespace infini {
+
+/**
+ * @brief Runs requests through a graph asynchronously, several of them at
+ * once, for streaming inference.
+ *
+ * A request gives the values of the request inputs of the graph and gets the
+ * values of its outputs back, through a future or a callback. The pipeline
+ * keeps `depth` slots, each with its own activation buffers and compiled
+ * plan: the graph itself and depth - 1 clones of it, which share the memory
+ * of the other graph inputs (the weights). A request takes a free slot and
+ * runs on the thread pool of the runtime (NativeCpuRuntimeObj::runAsync),
+ * so request N + 1 starts on the early ops while request N finishes the late
+ * ones; requests beyond `depth` wait in a queue and start in order as slots
+ * free up. Outputs are copied out before the slot is handed on.
+ *
+ * The graph must have been allocated by dataMalloc and must not be run
+ * otherwise while the pipeline lives. The destructor waits for every
+ * request submitted.
+ */
+class Pipeline {
+  public:
+    // The bytes of a tensor, as laid out in its buffer.
+    using Buffer = vector<uint8_t>;
+    // Called on a worker of the pool once a request is done, with its
+    // outputs or the exception it failed with. It must not wait for other
+    // requests.
+    using Callback =
+        std::function<void(vector<Buffer> outputs, std::exception_ptr error)>;
+
+  private:
+    struct Slot {
+        Graph graph;
+        TensorVec inputs, outputs;
+        ExecutionPlan plan;
+    };
+    struct Request {
+        vector<Buffer> inputs;
+        Callback done;
+    };
+
+    Ref<NativeCpuRuntimeObj> runtime;
+    vector<Slot> slots;
+    std::mutex mutex;
+    std::condition_variable idle;
+    vector<int> freeSlots;
+    std::deque<Request> queue;
+    // Requests submitted whose callback has not returned yet.
+    int outstanding = 0;
+
+    void start(int slot, Request request);
+    void finish(int slot, Callback done, std::exception_ptr error);
+
+  public:
+    /**
+     * @param inputs The graph inputs set by each request, in the order of
+     * the buffers of submit(); the others keep their values.
+     * @param depth Requests in flight at most, at least 1.
+     */
+    Pipeline(Ref<NativeCpuRuntimeObj> runtime, Graph graph, TensorVec inputs,
+             int depth = 2);
+    ~Pipeline();
+    Pipeline(const Pipeline &) = delete;
+    Pipeline &operator=(const Pipeline &) = delete;
+
+    int getDepth() const { return slots.size(); }
+    // The tensors whose values a request gets back, in order.
+    const TensorVec &getOutputs() const { return slots[0].outputs; }
+
+    void submit(vector<Buffer> inputs, Callback done);
+    std::future<vector<Buffer>> submit(vector<Buffer> inputs);
+    // Blocks until every request submitted so far is done.
+    void wait();
+};
+
+} // namespace infini
@@ -0,0 +1,93 @@
+#pragma once
+#include "core/operator.h"
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace infini {
+
+/**
+ * @brief Per-operator timings of the runs a runtime makes while the profiler
+ * is attached (NativeCpuRuntimeObj::setProfiler).
+ *
+ * Every kernel call is kept as an event for the Chrome trace, up to a cap,
+ * and folded into the statistics of its operator: call count, wall time
+ * percentiles, bytes of the inputs and outputs and an estimate of the
+ * floating point operations. Runs of the same graph land in the same
+ * entries, so the statistics cover as many runs as were profiled; their
+ * memory does not grow with the runs, as the percentiles come from a
+ * bounded sample of the calls. record() may be called from several threads
+ * at once.
+ */
+class Profiler {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct OpStats {
+        // As in the trace, e.g. "Conv[12]".
+        string name;
+        string kernel;
+        vector<Shape> inputs, outputs;
+        size_t bytes;
+        double flops;
+        size_t calls = 0;
+        // Wall time of the calls in microseconds.
+        double totalTime = 0;
+        // Wall times of at most maxSamples calls, each call as likely to be
+        // kept as the others (reservoir sampling). All of them while there
+        // are no more calls than that.
+        vector<double> samples;
+        static constexpr size_t maxSamples = 4096;
+
+        void add(double time);
+        double total() const { return totalTime; }
+        // The nearest-rank percentile of the samples, p in [0, 100].
+        double percentile(double p) const;
+
+      private:
+        std::minstd_rand rng;
+    };
+
+  private:
+    struct Event {
+        UidBaseType guid;
+        double start, duration;
+        int thread;
+    };
+
+    mutable std::mutex mutex;
+    const Clock::time_point epoch = Clock::now();
+    const size_t maxEvents;
+    vector<Event> events;
+    size_t droppedEvents = 0;
+    std::map<UidBaseType, OpStats> stats;
+    std::map<std::thread::id, int> threads;
+
+  public:
+    /**
+     * @param maxEvents Trace events kept; later calls still count in the
+     * statistics.
+     */
+    explicit Profiler(size_t maxEvents = 1 << 20) : maxEvents(maxEvents) {}
+
+    void record(const Operator &op, const string &kernel,
+                Clock::time_point start, Clock::time_point end);
+    void clear();
+
+    // Statistics of every operator, the largest total time first.
+    vector<OpStats> getStats() const;
+    size_t getNumEvents() const;
+
+    // A table of getStats(), one operator per line.
+    string summary() const;
+    // The events in the Chrome trace event format, for chrome://tracing or
+    // Perfetto.
+    string chromeTrace() const;
+    void dumpChromeTrace(const string &path) const;
+
+    // Floating point operations of one call of op, roughly.
+    static double estimateFlops(const Operator &op);
+};
+
+} // namespace infini
@@ -2,6 +2,7 @@
 #include "core/common.h"
 #include "core/op_type.h"
 #include "core/ref.h"
+#include <exception>
 
 namespace infini
 {
@@ -10,6 +11,10 @@ namespace infini
   class GraphObj;
   class RuntimeObj;
   class BlobObj;
+  class Profiler;
+  class ExecutionPlan;
+  class ThreadPool;
+  struct ThreadPoolConfig;
 
   using Tensor = Ref<TensorObj>;
   using Operator = Ref<OperatorObj>;
@@ -51,8 +56,21 @@ namespace infini
 
   class NativeCpuRuntimeObj : public RuntimeObj
   {
+    // Times every kernel call of run() while set.
+    Ref<Profiler> profiler;
+    // Runs the ops of run() when they may overlap and the parallelFor
+    // loops of the kernels.
+    Ref<ThreadPool> pool;
+    // Ops that run() keeps in flight at once and threads of a parallelFor,
+    // see setThreads.
+    int interOp = 1;
+    int intraOp = 0;
+
+    void runConcurrently(const ExecutionPlan &plan) const;
+
   public:
-    NativeCpuRuntimeObj() : RuntimeObj(Device::CPU) {}
+    NativeCpuRuntimeObj();
+    ~NativeCpuRuntimeObj();
 
     static Ref<NativeCpuRuntimeObj> &getInstance()
     {
@@ -63,7 +81,53 @@ namespace infini
     void dealloc(void *ptr) override;
     void run(const Graph &graph) const override;
     void *alloc(size_t size) override;
+
+    /**
+     * @brief Looks up the kernel of every op of an allocated graph and lets
+     * it resolve its arguments, see ExecutionPlan.
+     */
+    ExecutionPlan compile(const Graph &graph) const;
+    void run(const ExecutionPlan &plan) const;
+
+    /**
+     * @brief Starts a run of the plan on the thread pool and returns at
+     * once. Steps are released as their predecessors finish, up to
+     * max(1, interOp) of them in flight (see setThreads), and `done` is
+     * called on the worker that finishes the last one, with the first
+     * exception a kernel threw or nullptr. The plan must outlive the run;
+     * `done` must not wait for other runs of the runtime.
+     */
+    void runAsync(const ExecutionPlan &plan,
+                  std::function<void(std::exception_ptr)> done) const;
     string toString() const override;
+
+    /**
+     * @brief Attaches a profiler to the runtime, or detaches it with
+     * nullptr. Profiling is off by default and costs nothing then.
+     */
+    void setProfiler(Ref<Profiler> p) { profiler = std::move(p); }
+    const Ref<Profiler> &getProfiler() const { return profiler; }
+
+    /**
+     * @brief Gives the runtime a thread pool of its own, e.g. one pinned to
+     * CPUs apart from the others. By default every runtime runs on
+     * ThreadPool::getDefault(), a worker per hardware thread but one for the
+     * whole process, so that several runtimes do not start more threads
+     * than there are CPUs. Not to be called while the runtime runs.
+     */
+    void setThreadPool(const ThreadPoolConfig &config);
+    ThreadPool &getThreadPool() const { return *pool; }
+
+    /**
+     * @brief Splits the threads between ops and kernels. With interOp > 1,
+     * run() hands every op whose predecessors have finished to the pool and
+     * keeps up to interOp of them in flight. A parallelFor of a kernel uses
+     * up to intraOp threads, 0 for all. With interOp <= 1, the default, ops
+     * run one after the other on the calling thread. The setting is the
+     * runtime's own, even on a pool shared with other runtimes.
+     */
+    void setThreads(int interOp, int intraOp = 0);
+    int getInterOpThreads() const { return interOp; }
   };
 
 } // namespace infini
@@ -48,6 +48,8 @@ namespace infini
             std::function<void(void *, size_t, DataType)> const &generator) const;
 
         void setDataBlob(const Blob &blob);
+        const Blob &getDataBlob() const { return data; }
+        bool hasData() const { return data != nullptr; }
 
         void printData() const;
         bool equalData(const Tensor &rhs, double relativeError = 1e-6) const;
@@ -0,0 +1,152 @@
+#pragma once
+#include "core/common.h"
+#include "core/ref.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace infini {
+
+struct ThreadPoolConfig {
+    // Worker threads, besides the thread that calls run() or parallelFor,
+    // which takes part as well. 0 for one less than the hardware threads.
+    int numThreads = 0;
+    // CPUs the workers are pinned to, worker i to cpus[i % cpus.size()].
+    // Empty leaves them to the scheduler of the OS.
+    vector<int> cpus;
+    // How long an idle worker polls for new tasks before it sleeps, which
+    // saves the wakeup of back-to-back kernels.
+    int spinMicroseconds = 100;
+};
+
+/**
+ * @brief A fixed set of worker threads running submitted tasks, shared by
+ * the ops (the inter-op scheduler of NativeCpuRuntimeObj) and the loops of
+ * the kernels (parallelFor).
+ *
+ * Every worker has its own deque. A task submitted by a worker goes to the
+ * back of its deque and is the next one it runs, which keeps the data a task
+ * hands on to its successor in that worker's cache; tasks from other threads
+ * are dealt round-robin. A worker whose deque is empty steals from the front
+ * of the others', then spins for a while and finally sleeps.
+ */
+class ThreadPool {
+  public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Makes `pool` the pool of the calling thread (see current()) for
+     * the lifetime of the scope. A parallelFor called there uses up to
+     * `parallelism` threads, 0 for as many as the pool allows, so that
+     * callers sharing a pool can each have their own limit.
+     */
+    class Scope {
+        ThreadPool *saved;
+        int savedParallelism;
+
+      public:
+        explicit Scope(ThreadPool *pool, int parallelism = 0);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    const ThreadPoolConfig config;
+    vector<std::unique_ptr<Queue>> queues;
+    vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    // Tasks in the queues and workers asleep, so that submit() only takes
+    // the lock when a worker needs waking.
+    std::atomic<size_t> queued{0};
+    std::atomic<int> sleepers{0};
+    std::atomic<size_t> next{0};
+    std::atomic<int> parallelism{0};
+    bool stop = false;
+
+    bool pop(int index, Task &task);
+    void work(int index, const std::function<void(int)> &init);
+
+  public:
+    /**
+     * @param init Called by each worker with its index before it takes any
+     * task, e.g. to set up thread-local state.
+     */
+    explicit ThreadPool(ThreadPoolConfig config = {},
+                        std::function<void(int)> init = nullptr);
+    explicit ThreadPool(int numThreads,
+                        std::function<void(int)> init = nullptr)
+        : ThreadPool(ThreadPoolConfig{numThreads}, std::move(init)) {}
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    // Runs the tasks still queued, then joins the workers.
+    ~ThreadPool();
+
+    int size() const { return threads.size(); }
+    const ThreadPoolConfig &getConfig() const { return config; }
+    void submit(Task task);
+    // The index of the calling thread among the workers, or -1.
+    int currentWorker() const;
+
+    // Threads a parallelFor uses at most, the calling one included; 0 for
+    // all of them.
+    void setParallelism(int n) { parallelism = n; }
+    int getParallelism() const;
+
+    // The pool the calling thread works for or was given by a Scope, or
+    // nullptr.
+    static ThreadPool *current();
+    // The pool of the process, with the default config, started on first
+    // use.
+    static const Ref<ThreadPool> &getDefault();
+};
+
+namespace detail {
+void parallelFor(size_t n, size_t grain,
+                 void (*call)(const void *, size_t, size_t), const void *fn);
+} // namespace detail
+
+/**
+ * @brief Calls fn(begin, end) on the chunks [0, grain), [grain, 2 * grain),
+ * ... of [0, n) on the threads of ThreadPool::current(), the calling thread
+ * included, and returns when all of them are done. Chunks run inline, in
+ * order, when there is only one, no pool, or when the caller is itself
+ * inside a parallelFor. The first exception thrown by fn is rethrown.
+ */
+template <typename Fn> void parallelFor(size_t n, size_t grain, Fn &&fn) {
+    using F = std::remove_reference_t<Fn>;
+    detail::parallelFor(
+        n, std::max<size_t>(grain, 1),
+        [](const void *f, size_t begin, size_t end) {
+            (*static_cast<F *>(const_cast<void *>(f)))(begin, end);
+        },
+        &fn);
+}
+
+/**
+ * @brief The number of threads a parallelFor called here would use at most,
+ * for kernels that split their work by thread.
+ */
+int parallelThreads();
+
+/**
+ * @brief A grain that deals n iterations evenly to the threads of a
+ * parallelFor called here, like a static OpenMP schedule, or keeps them in
+ * one chunk unless `parallel`.
+ */
+inline size_t evenGrain(size_t n, bool parallel = true) {
+    const size_t threads = parallel ? parallelThreads() : 1;
+    return std::max<size_t>(1, (n + threads - 1) / threads);
+}
+
+} // namespace infini
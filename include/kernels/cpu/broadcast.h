@@ -0,0 +1,85 @@
+#pragma once
+#include "core/tensor.h"
+#include <algorithm>
+
+namespace infini {
+
+/**
+ * @brief Iteration plan of a two-input broadcast over an output of shape C.
+ *
+ * Output dims of size 1 are dropped and adjacent dims that broadcast the same
+ * way in both inputs are merged, so e.g. [2,3,4] + [1,1,4] becomes [6,4] with
+ * B repeating along the outer dim. The output is then walked in runs along
+ * the innermost collapsed dim, advancing the input offsets incrementally.
+ * Walking the plan does not allocate.
+ */
+struct BroadcastPlan {
+    static constexpr int MaxRank = 8;
+
+    // How the inputs behave along the innermost collapsed dim, i.e. which
+    // loop each run needs.
+    enum class Kind {
+        SameShape, // A single contiguous run over both inputs.
+        ScalarA,   // A single run; A has only one element.
+        ScalarB,   // A single run; B has only one element.
+        Row,       // Runs are contiguous in both inputs, one of them repeats
+                   // along an outer dim.
+        ColumnA,   // A is constant within each run, B is contiguous.
+        ColumnB,   // B is constant within each run, A is contiguous.
+    };
+
+    Kind kind;
+    int rank;
+    size_t size;
+    size_t dims[MaxRank];
+    // Element strides of each input per collapsed dim, 0 where it broadcasts.
+    size_t strideA[MaxRank], strideB[MaxRank];
+
+    // Shapes are right-aligned as in numpy broadcasting.
+    BroadcastPlan(const Shape &a, const Shape &b, const Shape &c);
+
+    /**
+     * @brief Calls `fn(offsetC, offsetA, offsetB, len)` for each run of the
+     * output elements in [begin, end). Runs never cross the innermost dim,
+     * so within a run the inputs advance as described by `kind`.
+     */
+    template <typename Fn>
+    void forEachRun(size_t begin, size_t end, Fn &&fn) const {
+        if (begin >= end)
+            return;
+        size_t index[MaxRank];
+        size_t offA = 0, offB = 0, rest = begin;
+        for (int d = rank - 1; d >= 0; --d) {
+            index[d] = rest % dims[d];
+            rest /= dims[d];
+            offA += index[d] * strideA[d];
+            offB += index[d] * strideB[d];
+        }
+        const int last = rank - 1;
+        const size_t inner = dims[last];
+        for (size_t pos = begin; pos < end;) {
+            size_t len = std::min(inner - index[last], end - pos);
+            fn(pos, offA, offB, len);
+            pos += len;
+            index[last] += len;
+            offA += len * strideA[last];
+            offB += len * strideB[last];
+            if (index[last] < inner)
+                break;
+            offA -= inner * strideA[last];
+            offB -= inner * strideB[last];
+            index[last] = 0;
+            for (int d = last - 1; d >= 0; --d) {
+                offA += strideA[d];
+                offB += strideB[d];
+                if (++index[d] < dims[d])
+                    break;
+                offA -= dims[d] * strideA[d];
+                offB -= dims[d] * strideB[d];
+                index[d] = 0;
+            }
+        }
+    }
+};
+
+} // namespace infini
@@ -0,0 +1,136 @@
+#pragma once
+#include "core/common.h"
+#include "core/op_type.h"
+#include <cmath>
+#include <cstdint>
+
+namespace infini {
+
+/**
+ * @brief Micro-kernel of the packed GEMM. Computes an `mr` x `nr` tile of C
+ * from a packed A panel (`kc` columns of `mr` rows) and a packed B panel (`kc`
+ * rows of `nr` columns). When `accumulate` is false the tile is overwritten,
+ * otherwise the product is added to it.
+ */
+template <typename T>
+using GemmMicroKernel = void (*)(int kc, const T *packA, const T *packB, T *C,
+                                 int ldc, bool accumulate);
+
+template <typename T> struct GemmMicroKernelDesc {
+    int mr, nr;
+    GemmMicroKernel<T> kernel;
+};
+
+// Portable micro-kernel, written so that the compiler can vectorize it.
+template <typename T, int MR, int NR>
+void gemmMicroKernelScalar(int kc, const T *a, const T *b, T *C, int ldc,
+                           bool accumulate) {
+    T acc[MR][NR] = {};
+    for (int p = 0; p < kc; ++p, a += MR, b += NR)
+        for (int i = 0; i < MR; ++i)
+            for (int j = 0; j < NR; ++j)
+                acc[i][j] += a[i] * b[j];
+    for (int i = 0; i < MR; ++i)
+        for (int j = 0; j < NR; ++j)
+            C[i * ldc + j] = accumulate ? C[i * ldc + j] + acc[i][j] : acc[i][j];
+}
+
+/**
+ * @brief Cache blocking parameters: a `kc` x `nr` sliver of packed B stays in
+ * L1, an `mc` x `kc` block of packed A stays in L2 and a `kc` x `nc` panel of
+ * packed B stays in L3.
+ */
+struct GemmBlocking {
+    int mc, kc, nc;
+};
+
+/**
+ * @brief Work applied to each tile of C right after its last k block, while
+ * the tile is still in L1: C = act(C + bias + residual).
+ */
+template <typename T> struct GemmEpilogue {
+    // n values added to every row of C, or nullptr.
+    const T *bias = nullptr;
+    // An m x n matrix with row stride `ldr` added to C, or nullptr.
+    const T *residual = nullptr;
+    int ldr = 0;
+    // Unknown for none, Relu, Clip to [min, max] or Gelu.
+    OpType act = OpType::Unknown;
+    float min = -INFINITY, max = INFINITY;
+};
+
+/**
+ * @brief Row-major C[m, n] = op(A)[m, k] * op(B)[k, n], followed by
+ * `epilogue` when it is given.
+ *
+ * `lda`, `ldb` and `ldc` are the row strides of A, B and C as they are stored,
+ * i.e. before the transposition requested by `transA` / `transB`. The call
+ * parallelizes itself with parallelFor; inside an enclosing parallelFor it
+ * runs on the calling thread only.
+ */
+template <typename T>
+void gemm(bool transA, bool transB, int m, int n, int k, const T *A, int lda,
+          const T *B, int ldb, T *C, int ldc,
+          const GemmEpilogue<T> *epilogue = nullptr);
+
+/**
+ * @brief gemm on Float16 or BFloat16 matrices, given the conversions of the
+ * type: A and B are converted to fp32 while they are packed, the products
+ * accumulate in an fp32 copy of C and C is rounded once at the end.
+ */
+void gemmHalf(bool transA, bool transB, int m, int n, int k,
+              const uint16_t *A, int lda, const uint16_t *B, int ldb,
+              uint16_t *C, int ldc,
+              void (*toF32)(const uint16_t *, float *, size_t),
+              void (*fromF32)(const float *, uint16_t *, size_t));
+
+/**
+ * @brief Micro-kernel of the int8 GEMM, in the layout of the VNNI dot
+ * products: each of the `kq` steps consumes 4 consecutive k values. packA
+ * holds, per step, 4 unsigned bytes for each of `mr` rows, packB 4 signed
+ * bytes for each of `nr` columns, and the tile accumulates their int32 dot
+ * products.
+ */
+using GemmU8S8MicroKernel = void (*)(int kq, const uint8_t *packA,
+                                     const int8_t *packB, int32_t *C, int ldc,
+                                     bool accumulate);
+
+struct GemmU8S8MicroKernelDesc {
+    int mr, nr;
+    GemmU8S8MicroKernel kernel;
+};
+
+// Portable int8 micro-kernel, written so that the compiler can vectorize it.
+template <int MR, int NR>
+void gemmU8S8MicroKernelScalar(int kq, const uint8_t *a, const int8_t *b,
+                               int32_t *C, int ldc, bool accumulate) {
+    int32_t acc[MR][NR] = {};
+    for (int q = 0; q < kq; ++q, a += 4 * MR, b += 4 * NR)
+        for (int i = 0; i < MR; ++i)
+            for (int j = 0; j < NR; ++j)
+                for (int p = 0; p < 4; ++p)
+                    acc[i][j] += int32_t(a[4 * i + p]) * b[4 * j + p];
+    for (int i = 0; i < MR; ++i)
+        for (int j = 0; j < NR; ++j)
+            C[i * ldc + j] = accumulate ? C[i * ldc + j] + acc[i][j] : acc[i][j];
+}
+
+/**
+ * @brief Int8 C[m, n] = op(A)[m, k] * op(B)[k, n] with exact int32
+ * accumulation; strides and transpositions as in gemm.
+ *
+ * The micro-kernels multiply unsigned by signed bytes, so the signed A of
+ * gemmS8 is shifted by +128 while it is packed and 128 * (column sums of B)
+ * is subtracted from C afterwards; gemmU8S8 takes an unsigned A as it is.
+ */
+void gemmS8(bool transA, bool transB, int m, int n, int k, const int8_t *A,
+            int lda, const int8_t *B, int ldb, int32_t *C, int ldc);
+void gemmU8S8(bool transA, bool transB, int m, int n, int k,
+              const uint8_t *A, int lda, const int8_t *B, int ldb, int32_t *C,
+              int ldc);
+
+template <typename T> const GemmMicroKernelDesc<T> &getGemmMicroKernel();
+
+template <typename T> const GemmBlocking &getGemmBlocking();
+
+} // namespace infini
@@ -0,0 +1,127 @@
+#pragma once
+#include "core/data_type.h"
+#include "kernels/cpu/gemm.h"
+#include "utils/cpu_features.h"
+
+namespace infini {
+
+// Contiguous loops shared by the CPU kernels. `n` is the element count;
+// outputs may alias inputs.
+template <typename T> struct BinaryKernels {
+    // c[i] = a[i] op b[i]
+    void (*vv)(const T *a, const T *b, T *c, size_t n);
+    // c[i] = a[i] op b
+    void (*vs)(const T *a, T b, T *c, size_t n);
+    // c[i] = b op a[i]
+    void (*sv)(const T *a, T b, T *c, size_t n);
+};
+using UnaryF32Kernel = void (*)(const float *x, float *y, size_t n);
+using ClipF32Kernel = void (*)(const float *x, float *y, size_t n, float lo,
+                               float hi);
+// Float16 and BFloat16 values are raw uint16_t bit patterns, see
+// utils/float16.h for the rounding rules every ISA has to follow.
+using F32ToU16Kernel = void (*)(const float *x, uint16_t *y, size_t n);
+using U16ToF32Kernel = void (*)(const uint16_t *x, float *y, size_t n);
+using F32ToI32Kernel = void (*)(const float *x, int32_t *y, size_t n);
+using I32ToF32Kernel = void (*)(const int32_t *x, float *y, size_t n);
+/**
+ * @brief Contiguous float reductions with one operator (sum, max or min; max
+ * and min propagate NaN).
+ */
+struct ReduceKernels {
+    // Folds x[0, n) into one value, the identity of the operator when n is 0.
+    float (*all)(const float *x, size_t n);
+    // acc[i] = acc[i] op x[i]
+    void (*accumulate)(float *acc, const float *x, size_t n);
+};
+/**
+ * @brief Softmax loops built on the online normalizer: a running max m and a
+ * sum s of e^(x - m) that is rescaled whenever m grows, so that the input is
+ * read once for the normalizer and once for the output.
+ */
+struct SoftmaxKernels {
+    // y = softmax(x) over one contiguous row of n elements.
+    void (*row)(const float *x, float *y, size_t n);
+    // Folds x[i] into (max[i], sum[i]), for softmax over a non-contiguous
+    // axis; max starts at the lowest finite float and sum at 0.
+    void (*foldColumns)(float *max, float *sum, const float *x, size_t n);
+    // y[i] = e^(x[i] - max[i]) * scale[i]
+    void (*scaleColumns)(const float *x, const float *max, const float *scale,
+                         float *y, size_t n);
+};
+// Row loops of LayerNormalization and RMSNormalization.
+struct NormKernels {
+    // Mean and biased variance of x[0, n), in one pass (Welford).
+    void (*meanVariance)(const float *x, size_t n, float *mean, float *var);
+    float (*sumSquares)(const float *x, size_t n);
+    // y[i] = (x[i] - shift) * scale * gamma[i] + beta[i]; beta may be null.
+    void (*normalize)(const float *x, float shift, float scale,
+                      const float *gamma, const float *beta, float *y,
+                      size_t n);
+};
+// Transposes a `rows` x `cols` block of 32-bit elements:
+// dst[j * ldd + i] = src[i * lds + j].
+using Transpose32Kernel = void (*)(const uint32_t *src, size_t lds,
+                                   uint32_t *dst, size_t ldd, size_t rows,
+                                   size_t cols);
+
+/**
+ * @brief Table of the ISA-specific inner loops used by the CPU kernels.
+ *
+ * The scalar table is always complete; each ISA level starts from the level
+ * below it and overrides the entries its translation unit implements
+ * (src/kernels/cpu/x86/simd_kernels_<isa>.cc, built with matching -m flags).
+ * Kernels pick up the table for the host once, when they are registered.
+ */
+struct SimdKernels {
+    CpuIsa isa;
+    GemmMicroKernelDesc<float> sgemm;
+    // Int8 GEMM; overridden by the VNNI units on hosts that have VNNI.
+    GemmU8S8MicroKernelDesc u8s8gemm;
+    BinaryKernels<float> add, sub, mul, div;
+    BinaryKernels<uint32_t> addU32, subU32, mulU32, divU32;
+    UnaryF32Kernel relu;
+    // Activations; the ISA levels use the approximations of
+    // kernels/cpu/simd_math.h, the scalar table uses libm.
+    UnaryF32Kernel exp, sigmoid, tanh, gelu, silu, erf;
+    ClipF32Kernel clip;
+    ReduceKernels reduceSum, reduceMax, reduceMin;
+    SoftmaxKernels softmax;
+    NormKernels norm;
+    F32ToU16Kernel f32ToF16, f32ToBf16;
+    U16ToF32Kernel f16ToF32, bf16ToF32;
+    // Truncates toward zero, saturates out of range values and maps NaN to 0.
+    F32ToI32Kernel f32ToI32;
+    I32ToF32Kernel i32ToF32;
+    Transpose32Kernel transpose32;
+    // memcpy with non-temporal stores for outputs that will not be read
+    // back from cache soon; the stores are fenced before returning.
+    void (*streamCopy)(void *dst, const void *src, size_t bytes);
+};
+
+/**
+ * @brief Both conversions of a 16-bit float type, for the kernels that store
+ * Float16 or BFloat16 and compute in fp32.
+ */
+struct HalfConversions {
+    U16ToF32Kernel toF32;
+    F32ToU16Kernel fromF32;
+};
+
+// The conversions of `dtype`, DataType::Float16 or DataType::BFloat16.
+HalfConversions getHalfConversions(const SimdKernels &table, DataType dtype);
+
+// Table for the best ISA level of the host (see CpuFeatures::getIsa).
+const SimdKernels &getSimdKernels();
+// Table for a given level, nullptr if it is not built in or not supported.
+const SimdKernels *getSimdKernels(CpuIsa isa);
+
+void fillSimdKernelsSse4(SimdKernels &table);
+void fillSimdKernelsAvx2(SimdKernels &table);
+void fillSimdKernelsAvx512(SimdKernels &table);
+// VNNI is an extension of the AVX2 and AVX-512 levels, filled in on top of
+// them when CPUID reports it.
+void fillSimdKernelsAvxVnni(SimdKernels &table);
+void fillSimdKernelsAvx512Vnni(SimdKernels &table);
+
+} // namespace infini
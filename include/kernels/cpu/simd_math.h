@@ -0,0 +1,463 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+// Vectorized float32 transcendental functions, reductions, softmax and
+// normalization loops, written once against a vector abstraction `O` and
+// included only by the ISA translation units in src/kernels/cpu/x86.
+// Everything here is in an anonymous namespace, so each of them gets its own
+// copy with internal linkage, the non-template members of the folds
+// included, and no ISA code can leak into a baseline caller (a Debug build
+// checks that the x86 objects export no weak symbol, see CMakeLists.txt).
+// For the same reason the loops call no std template or inline function
+// such as std::max, std::fill_n or std::exp: unoptimized builds emit those
+// as weak symbols that the linker may take from an ISA unit for every
+// caller. `O` provides:
+//
+//   V, I, M               float vector, int32 vector, comparison mask
+//   W                     lanes per vector
+//   load, store           unaligned float loads and stores
+//   set1, add, sub, mul, div, fma (a * b + c), min, max, abs
+//   copySign(mag, sgn)    mag with the sign bit of sgn
+//   highHalf(v)           v with the low 12 mantissa bits cleared
+//   lt(a, b)              a < b, false for NaN
+//   select(m, a, b)       m ? a : b per lane
+//   isNan(v)              v is NaN
+//   maskOr(a, b)          a | b on masks
+//   round(v)              round to nearest integral value
+//   toInt(v)              exact conversion of integral values
+//   halve(i)              i >> 1 (arithmetic)
+//   subInt(a, b)          a - b
+//   exp2Int(i)            2^i as float, for i in [-126, 127]
+//
+// Maximum errors, measured against double precision over a sweep of the
+// float range with the FMA and non-FMA variants (see test_nativecpu_unary.cc),
+// where the result is at least FLT_MIN, 2^-126:
+//   exp 1.5 ULP, tanh 1.5 ULP, sigmoid 2.5 ULP, silu 3 ULP, erf 3 ULP and
+//   gelu 7 ULP, the last bound by the Chebyshev fit of erfc.
+
+namespace infini {
+
+namespace {
+
+namespace simd_math {
+
+// Cephes expf of hi + lo, times `scale`: n = round((hi + lo) / ln2),
+// r = hi - n ln2 in two parts, plus lo, and a degree 6 polynomial for e^r.
+// lo carries the low part of an argument that is not a float; it is clamped
+// to [-8, 8] as it is only meant to be small next to hi. 2^n is applied in
+// two halves so that results down to the subnormals and up to overflow come
+// out right; a power of two `scale` is applied before them, for callers that
+// need e^x scaled out of the subnormals.
+template <typename O>
+typename O::V expSum(typename O::V hi, typename O::V lo, float scale) {
+    using V = typename O::V;
+    hi = O::min(O::set1(89.f), O::max(O::set1(-104.f), hi));
+    lo = O::min(O::set1(8.f), O::max(O::set1(-8.f), lo));
+    V n = O::round(O::mul(O::add(hi, lo), O::set1(1.44269504088896341f)));
+    V r = O::fma(n, O::set1(-0.693359375f), hi);
+    r = O::add(O::fma(n, O::set1(2.12194440e-4f), r), lo);
+    V p = O::set1(1.9875691500e-4f);
+    p = O::fma(p, r, O::set1(1.3981999507e-3f));
+    p = O::fma(p, r, O::set1(8.3334519073e-3f));
+    p = O::fma(p, r, O::set1(4.1665795894e-2f));
+    p = O::fma(p, r, O::set1(1.6666665459e-1f));
+    p = O::fma(p, r, O::set1(5.0000001201e-1f));
+    p = O::fma(p, O::mul(r, r), O::add(r, O::set1(1.f)));
+    if (scale != 1.f)
+        p = O::mul(p, O::set1(scale));
+    auto k = O::toInt(n);
+    auto k1 = O::halve(k);
+    return O::mul(O::mul(p, O::exp2Int(k1)), O::exp2Int(O::subInt(k, k1)));
+}
+
+template <typename O> typename O::V exp(typename O::V x) {
+    return expSum<O>(x, O::set1(0.f), 1.f);
+}
+
+// Both activations are evaluated through e = e^-|x|, which cannot overflow:
+// sigmoid(x) is 1 / (1 + e) for x >= 0 and e / (1 + e) below.
+template <typename O> typename O::V sigmoid(typename O::V x) {
+    using V = typename O::V;
+    V e = exp<O>(O::sub(O::set1(0.f), O::abs(x)));
+    V d = O::add(O::set1(1.f), e);
+    return O::select(O::lt(x, O::set1(0.f)), O::div(e, d),
+                     O::div(O::set1(1.f), d));
+}
+
+// For x < -87 e itself is subnormal while x * e is not, so the negative
+// branch works on e * 2^24 and scales the result back.
+template <typename O> typename O::V silu(typename O::V x) {
+    using V = typename O::V;
+    V es = expSum<O>(O::sub(O::set1(0.f), O::abs(x)), O::set1(0.f), 0x1p24f);
+    V d = O::fma(es, O::set1(0x1p-24f), O::set1(1.f));
+    V negative = O::mul(O::div(O::mul(x, es), d), O::set1(0x1p-24f));
+    return O::select(O::lt(x, O::set1(0.f)), negative, O::div(x, d));
+}
+
+// Cephes tanhf: an odd polynomial below 0.625, 1 - 2 / (e^2|x| + 1) above.
+template <typename O> typename O::V tanh(typename O::V x) {
+    using V = typename O::V;
+    V a = O::abs(x);
+    V z = O::mul(a, a);
+    V p = O::set1(-5.70498872745e-3f);
+    p = O::fma(p, z, O::set1(2.06390887954e-2f));
+    p = O::fma(p, z, O::set1(-5.37397155531e-2f));
+    p = O::fma(p, z, O::set1(1.33314422036e-1f));
+    p = O::fma(p, z, O::set1(-3.33332819422e-1f));
+    V small = O::fma(O::mul(p, z), a, a);
+    V e = exp<O>(O::add(a, a));
+    V large = O::sub(O::set1(1.f),
+                     O::div(O::set1(2.f), O::add(e, O::set1(1.f))));
+    return O::copySign(O::select(O::lt(a, O::set1(0.625f)), small, large), x);
+}
+
+// hi + lo = -s * v * v with hi exact: v is split into its upper 12 bits,
+// whose square is a float, and the rest. s has to be a power of two.
+template <typename O>
+void negSquare(typename O::V v, float s, typename O::V &hi,
+               typename O::V &lo) {
+    using V = typename O::V;
+    V vh = O::highHalf(v);
+    hi = O::mul(O::mul(vh, vh), O::set1(-s));
+    lo = O::mul(O::mul(O::sub(vh, v), O::add(v, vh)), O::set1(s));
+}
+
+// erf(a) and erfc(a) for a >= 0, given hi + lo = -a * a. Below 1 erf is the
+// Maclaurin series up to a^21; above, erfc comes from the Numerical Recipes
+// Chebyshev fit (relative error below 1.2e-7 everywhere), whose e^-a^2 factor
+// is taken from hi + lo so that it keeps its relative accuracy in the tail.
+template <typename O>
+void erfPair(typename O::V a, typename O::V hi, typename O::V lo,
+             typename O::V &erfA, typename O::V &erfcA) {
+    using V = typename O::V;
+    static constexpr float series[] = {
+        1.1283791671e+0f,  -3.7612638903e-1f, 1.1283791671e-1f,
+        -2.6866170645e-2f, 5.2239776254e-3f,  -8.5483270234e-4f,
+        1.2055332981e-4f,  -1.4925650358e-5f, 1.6462114365e-6f,
+        -1.6365844691e-7f, 1.4807192815e-8f};
+    V z = O::mul(a, a);
+    V s = O::set1(series[10]);
+    for (int i = 9; i >= 0; --i)
+        s = O::fma(s, z, O::set1(series[i]));
+    V small = O::mul(s, a);
+
+    static constexpr float chebyshev[] = {
+        -1.26551223f, 1.00002368f,  0.37409196f,  0.09678418f, -0.18628806f,
+        0.27886807f,  -1.13520398f, 1.48851587f, -0.82215223f, 0.17087277f};
+    V t = O::div(O::set1(1.f), O::fma(O::set1(0.5f), a, O::set1(1.f)));
+    V c = O::set1(chebyshev[9]);
+    for (int i = 8; i >= 0; --i)
+        c = O::fma(c, t, O::set1(chebyshev[i]));
+    V tail = O::mul(t, expSum<O>(hi, O::add(lo, c), 1.f));
+
+    erfA = O::select(O::lt(a, O::set1(1.f)), small,
+                     O::sub(O::set1(1.f), tail));
+    erfcA = O::select(O::lt(a, O::set1(0.5f)), O::sub(O::set1(1.f), small),
+                      tail);
+}
+
+template <typename O> typename O::V erf(typename O::V x) {
+    typename O::V a = O::abs(x), hi, lo, erfA, erfcA;
+    negSquare<O>(a, 1.f, hi, lo);
+    erfPair<O>(a, hi, lo, erfA, erfcA);
+    return O::copySign(erfA, x);
+}
+
+// Exact GELU, x * Phi(x) = x / 2 * erfc(-x / sqrt(2)). Going through erfc
+// keeps the relative accuracy for negative x, where 1 + erf would cancel;
+// -u^2 = -x^2 / 2 is split from x itself, as u is already rounded.
+template <typename O> typename O::V gelu(typename O::V x) {
+    using V = typename O::V;
+    V u = O::mul(x, O::set1(-0.70710678118654752f));
+    V hi, lo, erfA, erfcA;
+    negSquare<O>(x, 0.5f, hi, lo);
+    erfPair<O>(O::abs(u), hi, lo, erfA, erfcA);
+    // erfc(u) = erfc(|u|) for u >= 0 and 1 + erf(|u|) below.
+    V erfcU = O::select(O::lt(u, O::set1(0.f)),
+                        O::add(O::set1(1.f), erfA), erfcA);
+    return O::mul(O::mul(x, O::set1(0.5f)), erfcU);
+}
+
+// Runs `f` over whole vectors; the tail goes through a zero padded buffer so
+// that it takes the same code path.
+template <typename O, typename O::V (*f)(typename O::V)>
+void unaryLoop(const float *x, float *y, size_t n) {
+    size_t i = 0;
+    for (; i + O::W <= n; i += O::W)
+        O::store(y + i, f(O::load(x + i)));
+    if (i < n) {
+        float in[O::W] = {}, out[O::W];
+        std::memcpy(in, x + i, (n - i) * sizeof(float));
+        O::store(out, f(O::load(in)));
+        std::memcpy(y + i, out, (n - i) * sizeof(float));
+    }
+}
+
+// Operators of the reductions, on vectors and on scalars. Max and min
+// propagate NaN; the vector form takes `x` when acc op x or x is NaN, and a
+// NaN already in `acc` stays there.
+struct SumFold {
+    static constexpr float identity = 0.f;
+    template <typename O> static typename O::V apply(typename O::V acc,
+                                                     typename O::V x) {
+        return O::add(acc, x);
+    }
+    static float apply(float acc, float x) { return acc + x; }
+};
+struct MaxFold {
+    static constexpr float identity = -std::numeric_limits<float>::infinity();
+    template <typename O> static typename O::V apply(typename O::V acc,
+                                                     typename O::V x) {
+        return O::select(O::maskOr(O::lt(acc, x), O::isNan(x)), x, acc);
+    }
+    static float apply(float acc, float x) {
+        return acc < x || x != x ? x : acc;
+    }
+};
+struct MinFold {
+    static constexpr float identity = std::numeric_limits<float>::infinity();
+    template <typename O> static typename O::V apply(typename O::V acc,
+                                                     typename O::V x) {
+        return O::select(O::maskOr(O::lt(x, acc), O::isNan(x)), x, acc);
+    }
+    static float apply(float acc, float x) {
+        return x < acc || x != x ? x : acc;
+    }
+};
+
+// Folds x[0, n) with four vector accumulators, then their lanes and the tail
+// in a fixed order, so the result only depends on n and the ISA.
+template <typename O, typename F> float reduceAll(const float *x, size_t n) {
+    using V = typename O::V;
+    V a0 = O::set1(F::identity), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 4 * O::W <= n; i += 4 * O::W) {
+        a0 = F::template apply<O>(a0, O::load(x + i));
+        a1 = F::template apply<O>(a1, O::load(x + i + O::W));
+        a2 = F::template apply<O>(a2, O::load(x + i + 2 * O::W));
+        a3 = F::template apply<O>(a3, O::load(x + i + 3 * O::W));
+    }
+    for (; i + O::W <= n; i += O::W)
+        a0 = F::template apply<O>(a0, O::load(x + i));
+    a0 = F::template apply<O>(F::template apply<O>(a0, a1),
+                              F::template apply<O>(a2, a3));
+    float lanes[O::W];
+    O::store(lanes, a0);
+    float ret = F::identity;
+    for (size_t j = 0; j < O::W; ++j)
+        ret = F::apply(ret, lanes[j]);
+    for (; i < n; ++i)
+        ret = F::apply(ret, x[i]);
+    return ret;
+}
+
+// acc[i] = acc[i] op x[i]
+template <typename O, typename F>
+void reduceAccumulate(float *acc, const float *x, size_t n) {
+    size_t i = 0;
+    for (; i + O::W <= n; i += O::W)
+        O::store(acc + i, F::template apply<O>(O::load(acc + i),
+                                               O::load(x + i)));
+    for (; i < n; ++i)
+        acc[i] = F::apply(acc[i], x[i]);
+}
+
+// Online softmax normalizer: folds x into a running max m and a sum s of
+// e^(x - m), rescaling s whenever m grows. Both cases need e^-|x - m| only,
+// so each element costs one exp; a NaN x leaves m alone and turns s into
+// NaN. m starts at the lowest finite float rather than -inf, so masked -inf
+// inputs add e^-inf = 0 instead of NaN.
+constexpr float softmaxMaxInit = -std::numeric_limits<float>::max();
+// As a constant, so that no ISA unit emits a copy of infinity().
+constexpr float negInfinity = -std::numeric_limits<float>::infinity();
+
+template <typename O>
+void softmaxFold(typename O::V &m, typename O::V &s, typename O::V x) {
+    auto grows = O::lt(m, x);
+    auto e = exp<O>(O::select(grows, O::sub(m, x), O::sub(x, m)));
+    s = O::select(grows, O::fma(s, e, O::set1(1.f)), O::add(s, e));
+    m = O::select(grows, x, m);
+}
+
+// Loads the n < W values of a tail, padded with `pad`.
+template <typename O>
+typename O::V loadTail(const float *p, size_t n, float pad) {
+    float buf[O::W];
+    for (size_t j = 0; j < O::W; ++j)
+        buf[j] = pad;
+    std::memcpy(buf, p, n * sizeof(float));
+    return O::load(buf);
+}
+
+template <typename O> void storeTail(float *p, size_t n, typename O::V v) {
+    float buf[O::W];
+    O::store(buf, v);
+    std::memcpy(p, buf, n * sizeof(float));
+}
+
+// y = softmax(x) over one contiguous row, reading x twice: the online pass
+// keeps one (m, s) pair per lane, merged at the end, then y = e^(x - m) / s.
+// The tail is padded with -inf, which leaves (m, s) unchanged.
+template <typename O> void softmaxRow(const float *x, float *y, size_t n) {
+    using V = typename O::V;
+    V m = O::set1(softmaxMaxInit), s = O::set1(0.f);
+    size_t i = 0;
+    for (; i + O::W <= n; i += O::W)
+        softmaxFold<O>(m, s, O::load(x + i));
+    if (i < n)
+        softmaxFold<O>(m, s, loadTail<O>(x + i, n - i, negInfinity));
+    float ms[O::W], ss[O::W];
+    O::store(ms, m);
+    O::store(ss, s);
+    float max = softmaxMaxInit, sum = 0.f;
+    for (size_t j = 0; j < O::W; ++j)
+        max = max < ms[j] ? ms[j] : max;
+    for (size_t j = 0; j < O::W; ++j)
+        sum += ss[j] * expf(ms[j] - max);
+    const V vmax = O::set1(max), inv = O::set1(1.f / sum);
+    for (i = 0; i + O::W <= n; i += O::W)
+        O::store(y + i, O::mul(exp<O>(O::sub(O::load(x + i), vmax)), inv));
+    if (i < n)
+        storeTail<O>(y + i, n - i,
+                     O::mul(exp<O>(O::sub(loadTail<O>(x + i, n - i, 0.f),
+                                          vmax)),
+                            inv));
+}
+
+// Folds x[i] into (m[i], s[i]), for the columns of a softmax over an outer
+// axis; m and s start at softmaxMaxInit and 0.
+template <typename O>
+void softmaxFoldColumns(float *m, float *s, const float *x, size_t n) {
+    size_t i = 0;
+    for (; i + O::W <= n; i += O::W) {
+        auto vm = O::load(m + i), vs = O::load(s + i);
+        softmaxFold<O>(vm, vs, O::load(x + i));
+        O::store(m + i, vm);
+        O::store(s + i, vs);
+    }
+    if (i < n) {
+        const size_t k = n - i;
+        auto vm = loadTail<O>(m + i, k, softmaxMaxInit);
+        auto vs = loadTail<O>(s + i, k, 0.f);
+        softmaxFold<O>(vm, vs, loadTail<O>(x + i, k, 0.f));
+        storeTail<O>(m + i, k, vm);
+        storeTail<O>(s + i, k, vs);
+    }
+}
+
+// y[i] = e^(x[i] - m[i]) * r[i]
+template <typename O>
+void softmaxScaleColumns(const float *x, const float *m, const float *r,
+                         float *y, size_t n) {
+    size_t i = 0;
+    for (; i + O::W <= n; i += O::W)
+        O::store(y + i, O::mul(exp<O>(O::sub(O::load(x + i), O::load(m + i))),
+                               O::load(r + i)));
+    if (i < n) {
+        const size_t k = n - i;
+        storeTail<O>(
+            y + i, k,
+            O::mul(exp<O>(O::sub(loadTail<O>(x + i, k, 0.f),
+                                 loadTail<O>(m + i, k, 0.f))),
+                   loadTail<O>(r + i, k, 0.f)));
+    }
+}
+
+// Mean and biased variance of x[0, n) by Welford's algorithm, on x - x[0]
+// so that a mean far from 0 next to the spread loses no precision. Two sets
+// of per-lane accumulators see the same number of elements each, so their
+// lanes merge exactly into one (mean, M2) pair, which then takes in the tail
+// one element at a time.
+template <typename O>
+void meanVariance(const float *x, size_t n, float *mean, float *var) {
+    using V = typename O::V;
+    const float shift = n > 0 ? x[0] : 0.f;
+    const V vshift = O::set1(shift);
+    V m0 = O::set1(0.f), m1 = m0, q0 = m0, q1 = m0;
+    size_t i = 0, k = 0;
+    for (; i + 2 * O::W <= n; i += 2 * O::W) {
+        const V r = O::set1(1.f / float(++k));
+        V x0 = O::sub(O::load(x + i), vshift);
+        V x1 = O::sub(O::load(x + i + O::W), vshift);
+        V d0 = O::sub(x0, m0), d1 = O::sub(x1, m1);
+        m0 = O::fma(d0, r, m0);
+        m1 = O::fma(d1, r, m1);
+        q0 = O::fma(d0, O::sub(x0, m0), q0);
+        q1 = O::fma(d1, O::sub(x1, m1), q1);
+    }
+    float ms[2 * O::W], qs[2 * O::W];
+    O::store(ms, m0);
+    O::store(ms + O::W, m1);
+    O::store(qs, q0);
+    O::store(qs + O::W, q1);
+    float mu = 0.f, m2 = 0.f;
+    if (k > 0) {
+        for (size_t j = 0; j < 2 * O::W; ++j)
+            mu += ms[j];
+        mu /= float(2 * O::W);
+        float spread = 0.f;
+        for (size_t j = 0; j < 2 * O::W; ++j) {
+            m2 += qs[j];
+            spread += (ms[j] - mu) * (ms[j] - mu);
+        }
+        m2 += float(k) * spread;
+    }
+    for (size_t count = 2 * O::W * k; i < n; ++i) {
+        float v = x[i] - shift, d = v - mu;
+        mu += d / float(++count);
+        m2 += d * (v - mu);
+    }
+    *mean = shift + mu;
+    *var = n > 0 ? m2 / float(n) : 0.f;
+}
+
+template <typename O> float sumSquares(const float *x, size_t n) {
+    using V = typename O::V;
+    V a0 = O::set1(0.f), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 4 * O::W <= n; i += 4 * O::W) {
+        V x0 = O::load(x + i), x1 = O::load(x + i + O::W);
+        V x2 = O::load(x + i + 2 * O::W), x3 = O::load(x + i + 3 * O::W);
+        a0 = O::fma(x0, x0, a0);
+        a1 = O::fma(x1, x1, a1);
+        a2 = O::fma(x2, x2, a2);
+        a3 = O::fma(x3, x3, a3);
+    }
+    for (; i + O::W <= n; i += O::W) {
+        V x0 = O::load(x + i);
+        a0 = O::fma(x0, x0, a0);
+    }
+    float lanes[O::W];
+    O::store(lanes, O::add(O::add(a0, a1), O::add(a2, a3)));
+    float ret = 0.f;
+    for (size_t j = 0; j < O::W; ++j)
+        ret += lanes[j];
+    for (; i < n; ++i)
+        ret += x[i] * x[i];
+    return ret;
+}
+
+// y[i] = (x[i] - shift) * scale * gamma[i] + beta[i], beta may be null.
+template <typename O>
+void normalizeRow(const float *x, float shift, float scale,
+                  const float *gamma, const float *beta, float *y, size_t n) {
+    using V = typename O::V;
+    const V vshift = O::set1(shift), vscale = O::set1(scale);
+    size_t i = 0;
+    for (; i + O::W <= n; i += O::W) {
+        V v = O::mul(O::mul(O::sub(O::load(x + i), vshift), vscale),
+                     O::load(gamma + i));
+        O::store(y + i, beta ? O::add(v, O::load(beta + i)) : v);
+    }
+    for (; i < n; ++i)
+        y[i] = (x[i] - shift) * scale * gamma[i] + (beta ? beta[i] : 0.f);
+}
+
+} // namespace simd_math
+
+} // namespace
+
+} // namespace infini
@@ -0,0 +1,51 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief 2D convolution of an NCHW input with FCRS weights, as ONNX Conv with
+ * symmetric padding. The number of groups is C divided by the weight's
+ * second dimension; F has to be a multiple of it.
+ */
+class ConvObj : public OperatorObj {
+    int ph, pw;
+    int sh, sw;
+    int dh, dw;
+
+  public:
+    /**
+     * @brief Construct a new Conv object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input, [N, C, H, W].
+     * @param weight The weights, [F, C / groups, R, S].
+     * @param output The output, [N, F, OH, OW].
+     * @param ph Zero padding above and below.
+     * @param pw Zero padding left and right.
+     * @param sh Vertical stride.
+     * @param sw Horizontal stride.
+     * @param dh Vertical dilation.
+     * @param dw Horizontal dilation.
+     * @param bias F values added to the output channels, or nullptr.
+     */
+    ConvObj(GraphObj *graph, Tensor input, Tensor weight, Tensor output,
+            int ph = 0, int pw = 0, int sh = 1, int sw = 1, int dh = 1,
+            int dw = 1, Tensor bias = nullptr);
+    OP_CLONE(ConvObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    // nullptr without a bias.
+    Tensor getBias() const { return inputs.size() > 2 ? inputs[2] : nullptr; }
+    int getPh() const { return ph; }
+    int getPw() const { return pw; }
+    int getSh() const { return sh; }
+    int getSw() const { return sw; }
+    int getDh() const { return dh; }
+    int getDw() const { return dw; }
+    int getNumGroups() const;
+};
+} // namespace infini
@@ -0,0 +1,56 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief One step of a fused element-wise expression. Registers
+ * [0, numInputs) hold the inputs of the operator, broadcast to the output
+ * shape; each step writes `out` from `in0` (and `in1` for the binary ops).
+ * The output of the operator is the register written by the last step.
+ */
+struct FusedStep {
+    // Add, Sub, Mul, Div, Clip or one of the unary activations.
+    OpType type;
+    int out, in0, in1;
+    // Bounds of a Clip, -inf and inf when absent.
+    float min, max;
+};
+
+/**
+ * @brief A chain of Float32 element-wise and unary operators whose
+ * intermediate results all have the output shape, evaluated block by block
+ * in one pass over memory. Created by GraphObj::optimize.
+ */
+class FusedElementWiseObj : public OperatorObj {
+    vector<FusedStep> steps;
+    int numRegisters;
+
+  public:
+    /**
+     * @brief Construct a new FusedElementWise object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param inputs The distinct inputs of the expression.
+     * @param output The result of the last step.
+     * @param steps The expression, in evaluation order.
+     * @param numRegisters The number of registers the steps use, including
+     * the inputs.
+     */
+    FusedElementWiseObj(GraphObj *graph, TensorVec inputs, Tensor output,
+                        vector<FusedStep> steps, int numRegisters);
+    OP_CLONE(FusedElementWiseObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    const vector<FusedStep> &getSteps() const { return steps; }
+    int getNumRegisters() const { return numRegisters; }
+
+    /**
+     * @brief Whether `type` can be a step of a fused expression.
+     */
+    static bool canFuse(OpType type);
+};
+} // namespace infini
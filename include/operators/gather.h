@@ -0,0 +1,77 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief Picks slices of data along one axis, as ONNX Gather: the output is
+ * data.shape[:axis] + indices.shape + data.shape[axis + 1:]. Indices are
+ * Int32 or Int64, negative ones counting from the back of the axis.
+ */
+class GatherObj : public OperatorObj {
+    int axis;
+
+  public:
+    /**
+     * @brief Construct a new Gather object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param data The tensor to gather from, of any data type.
+     * @param indices The positions along the axis, Int32 or Int64.
+     * @param output The gathered tensor, of the data type of data.
+     * @param axis The axis to gather along, negative ones counting from the
+     * back.
+     */
+    GatherObj(GraphObj *graph, Tensor data, Tensor indices, Tensor output,
+              int axis = 0);
+    OP_CLONE(GatherObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 2; }
+    int numOutputs() const override { return 1; }
+    int getAxis() const { return axis; }
+};
+
+/**
+ * @brief Gathers rows of a [num, dim] Float32 table and reduces them bag by
+ * bag, as PyTorch EmbeddingBag: the output is [bags, dim] and no gathered
+ * row is ever written out. With offsets, indices is 1-D and bag b is
+ * indices[offsets[b] : offsets[b + 1]], the last bag running to the end;
+ * offsets[0] must be 0. Without, indices is [bags, len] and each row of it
+ * is one bag. Empty bags give zeros.
+ */
+class EmbeddingBagObj : public OperatorObj {
+  public:
+    enum class Mode { Sum, Mean, Max };
+
+  private:
+    Mode mode;
+
+  public:
+    /**
+     * @brief Construct a new EmbeddingBag object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param weight The [num, dim] Float32 table.
+     * @param indices The rows to gather, Int32 or Int64.
+     * @param offsets The start of each bag in indices, Int32 or Int64, or
+     * nullptr for bags of equal length.
+     * @param output The [bags, dim] reduced rows.
+     * @param mode How the rows of a bag are reduced.
+     */
+    EmbeddingBagObj(GraphObj *graph, Tensor weight, Tensor indices,
+                    Tensor offsets, Tensor output, Mode mode = Mode::Sum);
+    OP_CLONE(EmbeddingBagObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    Mode getMode() const { return mode; }
+    Tensor getOffsets() const {
+        return inputs.size() > 2 ? inputs[2] : nullptr;
+    }
+};
+} // namespace infini
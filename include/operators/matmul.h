@@ -1,5 +1,6 @@
 #pragma once
 #include "core/operator.h"
+#include <cmath>
 
 namespace infini
 {
@@ -15,6 +16,12 @@ namespace infini
         // oppsite to the column-major BLAS.
         bool transA, transB;
 
+        // Fused epilogue, C = act(A * B + bias + residual). The bias and the
+        // residual, when present, are the inputs after A and B in this order.
+        bool hasBias = false, hasResidual = false;
+        OpType act = OpType::Unknown;
+        float clipMin = -INFINITY, clipMax = INFINITY;
+
         // Auxiliary attributes which are not a part of operator attributes.
         int m, n, k;
 
@@ -44,6 +51,9 @@ namespace infini
 
         std::string toString() const override;
         optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+        // Int8 (or UInt8) A times Int8 B accumulates into Int32, otherwise C
+        // has the type of A.
+        vector<DataType> inferDataType(const TensorVec &inputs) const override;
 
         int numInputs() const override { return inputs.size(); }
         int numOutputs() const override { return 1; }
@@ -52,6 +62,31 @@ namespace infini
         bool getTransB() const { return transB; }
         void setTransA(bool transA) { this->transA = transA; }
         void setTransB(bool transB) { this->transB = transB; }
+        /**
+         * @brief Bias of the epilogue, n values broadcast over the rows of C
+         * (shape [n], or [1, ..., 1, n]), or nullptr.
+         */
+        Tensor getBias() const { return hasBias ? inputs[2] : nullptr; }
+        /**
+         * @brief Residual of the epilogue, a tensor of C's shape, or nullptr.
+         */
+        Tensor getResidual() const
+        {
+            return hasResidual ? inputs[2 + hasBias] : nullptr;
+        }
+        /**
+         * @brief Activation of the epilogue: Unknown for none, Relu, Clip
+         * (to [getClipMin(), getClipMax()]) or Gelu.
+         */
+        OpType getActivation() const { return act; }
+        float getClipMin() const { return clipMin; }
+        float getClipMax() const { return clipMax; }
+        // The epilogue is built in the order it is applied: bias, residual,
+        // then the activation. The caller connects the new inputs.
+        void setBias(Tensor bias);
+        void setResidual(Tensor residual);
+        void setActivation(OpType act, float min = -INFINITY,
+                           float max = INFINITY);
         int getM() const { return m; }
         int getN() const { return n; }
         int getK() const { return k; }
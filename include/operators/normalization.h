@@ -0,0 +1,77 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief Shared part of LayerNormalization and RMSNormalization: every row
+ * made of the dimensions [axis, rank) of x is normalized on its own, then
+ * multiplied by a scale (gamma) shaped like such a row, and for
+ * LayerNormalization shifted by an optional bias (beta) of the same shape.
+ * The scale and bias may leave out leading dimensions of size 1.
+ */
+class NormalizationObj : public OperatorObj {
+  protected:
+    int axis;
+    float eps;
+
+    NormalizationObj(OpType type, GraphObj *graph, TensorVec inputs, Tensor y,
+                     int axis, float eps);
+
+  public:
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    int getAxis() const { return axis; }
+    float getEps() const { return eps; }
+    Tensor getScale() const { return inputs[1]; }
+    // nullptr without a bias.
+    Tensor getBias() const { return inputs.size() > 2 ? inputs[2] : nullptr; }
+};
+
+/**
+ * @brief y = (x - mean) / sqrt(var + eps) * scale + bias, with the mean and
+ * the (biased) variance of each row, as ONNX LayerNormalization.
+ */
+class LayerNormObj : public NormalizationObj {
+  public:
+    /**
+     * @brief Construct a new LayerNormalization object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param x The input.
+     * @param scale The scale, shaped like a row.
+     * @param bias The bias, shaped like a row, or nullptr.
+     * @param y The output, shaped like x.
+     * @param axis The first normalized dimension, negative ones counting
+     * from the back.
+     * @param eps Added to the variance.
+     */
+    LayerNormObj(GraphObj *graph, Tensor x, Tensor scale, Tensor bias,
+                 Tensor y, int axis = -1, float eps = 1e-5f);
+    OP_CLONE(LayerNormObj);
+};
+
+/**
+ * @brief y = x / sqrt(mean(x^2) + eps) * scale over each row, as ONNX
+ * RMSNormalization.
+ */
+class RMSNormObj : public NormalizationObj {
+  public:
+    /**
+     * @brief Construct a new RMSNormalization object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param x The input.
+     * @param scale The scale, shaped like a row.
+     * @param y The output, shaped like x.
+     * @param axis The first normalized dimension, negative ones counting
+     * from the back.
+     * @param eps Added to the mean square.
+     */
+    RMSNormObj(GraphObj *graph, Tensor x, Tensor scale, Tensor y,
+               int axis = -1, float eps = 1e-5f);
+    OP_CLONE(RMSNormObj);
+};
+} // namespace infini
@@ -0,0 +1,80 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief Shared part of MaxPool and AveragePool on NCHW tensors: a kh x kw
+ * window, dilated by (dh, dw), slides with strides (sh, sw) over the input
+ * padded by (ph, pw) on both sides. With ceilMode the output size rounds up,
+ * as long as the last window still starts inside the input or the leading
+ * padding.
+ */
+class PoolingObj : public OperatorObj {
+  protected:
+    int kh, kw;
+    int dh, dw;
+    int ph, pw;
+    int sh, sw;
+    bool ceilMode;
+
+    PoolingObj(OpType type, GraphObj *graph, Tensor input, Tensor output,
+               int kh, int kw, int dh, int dw, int ph, int pw, int sh, int sw,
+               bool ceilMode);
+
+  public:
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    int getKh() const { return kh; }
+    int getKw() const { return kw; }
+    int getDh() const { return dh; }
+    int getDw() const { return dw; }
+    int getPh() const { return ph; }
+    int getPw() const { return pw; }
+    int getSh() const { return sh; }
+    int getSw() const { return sw; }
+    bool getCeilMode() const { return ceilMode; }
+};
+
+#define DEFINE_POOLING_OBJ(prefix, type)                                       \
+    class prefix##Obj : public PoolingObj {                                    \
+      public:                                                                  \
+        prefix##Obj(GraphObj *graph, Tensor input, Tensor output, int kh,      \
+                    int kw, int dh, int dw, int ph, int pw, int sh, int sw,    \
+                    bool ceilMode = false)                                     \
+            : PoolingObj(type, graph, input, output, kh, kw, dh, dw, ph, pw,   \
+                         sh, sw, ceilMode) {}                                  \
+        OP_CLONE(prefix##Obj);                                                 \
+    };
+
+// The maximum of each window; NaN propagates.
+DEFINE_POOLING_OBJ(MaxPool, OpType::MaxPool)
+// The mean of each window over the elements inside the input, padding
+// excluded (ONNX count_include_pad = 0).
+DEFINE_POOLING_OBJ(AvgPool, OpType::AveragePool)
+
+/**
+ * @brief The mean of every [H, W] plane of an NCHW tensor, as ONNX
+ * GlobalAveragePool: the output is [N, C, 1, 1].
+ */
+class GlobalAvgPoolObj : public OperatorObj {
+  public:
+    /**
+     * @brief Construct a new GlobalAveragePool object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input, [N, C, H, W].
+     * @param output The output, [N, C, 1, 1].
+     */
+    GlobalAvgPoolObj(GraphObj *graph, Tensor input, Tensor output);
+    OP_CLONE(GlobalAvgPoolObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+};
+} // namespace infini
@@ -0,0 +1,85 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief Shared part of QuantizeLinear and DequantizeLinear: the inputs are
+ * x, a Float32 scale and an optional zero point of the quantized type.
+ *
+ * The scale and the zero point hold either one value (a scalar or shape [1]),
+ * which quantizes the whole tensor, or one value per channel (shape [C], with
+ * C the size of dimension `axis` of x).
+ */
+class QuantizationObj : public OperatorObj {
+  protected:
+    int axis;
+
+    QuantizationObj(OpType type, GraphObj *graph, Tensor x, Tensor scale,
+                    Tensor zeroPoint, Tensor y, int axis);
+
+  public:
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    int getAxis() const { return axis; }
+    Tensor getScale() const { return inputs[1]; }
+    // nullptr for a zero point of 0.
+    Tensor getZeroPoint() const {
+        return inputs.size() > 2 ? inputs[2] : nullptr;
+    }
+    // Whether the scale has one value per channel of `axis`.
+    bool isPerChannel() const;
+};
+
+/**
+ * @brief y = saturate(round(x / scale) + zeroPoint), rounding half to even,
+ * as ONNX QuantizeLinear. x is Float32; y has the type of the zero point,
+ * Int8 or UInt8, and is Int8 when there is no zero point.
+ */
+class QuantizeLinearObj : public QuantizationObj {
+  public:
+    /**
+     * @brief Construct a new QuantizeLinear object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param x The Float32 input.
+     * @param scale One scale, or one per channel of `axis`.
+     * @param zeroPoint The zero point, shaped like the scale, or nullptr.
+     * @param y The quantized output.
+     * @param axis The channel dimension of per-channel quantization.
+     */
+    QuantizeLinearObj(GraphObj *graph, Tensor x, Tensor scale,
+                      Tensor zeroPoint, Tensor y, int axis = 1);
+    OP_CLONE(QuantizeLinearObj);
+
+    vector<DataType> inferDataType(const TensorVec &inputs) const override;
+};
+
+/**
+ * @brief y = (x - zeroPoint) * scale, as ONNX DequantizeLinear. x is Int8,
+ * UInt8 or Int32 and y is Float32. On the Int32 output of an Int8 MatMul,
+ * with scale = scaleA * scaleB, this is the requantization back to real
+ * values.
+ */
+class DequantizeLinearObj : public QuantizationObj {
+  public:
+    /**
+     * @brief Construct a new DequantizeLinear object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param x The quantized input.
+     * @param scale One scale, or one per channel of `axis`.
+     * @param zeroPoint The zero point, shaped like the scale and of the type
+     * of x, or nullptr.
+     * @param y The Float32 output.
+     * @param axis The channel dimension of per-channel quantization.
+     */
+    DequantizeLinearObj(GraphObj *graph, Tensor x, Tensor scale,
+                        Tensor zeroPoint, Tensor y, int axis = 1);
+    OP_CLONE(DequantizeLinearObj);
+
+    vector<DataType> inferDataType(const TensorVec &inputs) const override;
+};
+} // namespace infini
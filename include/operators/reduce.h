@@ -0,0 +1,53 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief Reduces a tensor over a set of axes with a sum, mean, max or min,
+ * as the ONNX Reduce* operators (with noop_with_empty_axes = 0).
+ */
+class ReduceObj : public OperatorObj {
+    // Sorted, without duplicates and in [0, rank).
+    vector<int> axes;
+    bool keepDims;
+
+  public:
+    /**
+     * @brief Construct a new Reduce object.
+     *
+     * @param type ReduceSum, ReduceMean, ReduceMax or ReduceMin.
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param output The output tensor.
+     * @param axes The axes to reduce, negative ones counting from the back;
+     * all of them if absent.
+     * @param keepDims Whether the reduced axes stay in the output with size 1.
+     */
+    ReduceObj(OpType type, GraphObj *graph, Tensor input, Tensor output,
+              const optional<vector<int>> &axes, bool keepDims = true);
+    OP_CLONE(ReduceObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    const vector<int> &getAxes() const { return axes; }
+    bool getKeepDims() const { return keepDims; }
+    bool isReduced(int axis) const;
+};
+
+#define DEFINE_REDUCE_OBJ(prefix, type)                                        \
+    class prefix##Obj : public ReduceObj {                                     \
+      public:                                                                  \
+        prefix##Obj(GraphObj *graph, Tensor input, Tensor output,              \
+                    const optional<vector<int>> &axes, bool keepDims = true)   \
+            : ReduceObj(type, graph, input, output, axes, keepDims) {}         \
+        OP_CLONE(prefix##Obj);                                                 \
+    };
+
+DEFINE_REDUCE_OBJ(ReduceSum, OpType::ReduceSum)
+DEFINE_REDUCE_OBJ(ReduceMean, OpType::ReduceMean)
+DEFINE_REDUCE_OBJ(ReduceMax, OpType::ReduceMax)
+DEFINE_REDUCE_OBJ(ReduceMin, OpType::ReduceMin)
+} // namespace infini
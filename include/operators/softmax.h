@@ -0,0 +1,31 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini {
+/**
+ * @brief y = exp(x) / sum(exp(x)) along one axis, as ONNX Softmax (opset 13).
+ */
+class SoftmaxObj : public OperatorObj {
+    int axis;
+
+  public:
+    /**
+     * @brief Construct a new Softmax object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param output The output tensor, shaped like the input.
+     * @param axis The axis to normalize along, negative ones counting from
+     * the back.
+     */
+    SoftmaxObj(GraphObj *graph, Tensor input, Tensor output, int axis = -1);
+    OP_CLONE(SoftmaxObj);
+
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    int getAxis() const { return axis; }
+};
+} // namespace infini
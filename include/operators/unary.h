@@ -101,4 +101,12 @@ namespace infini
   };
 
   DEFINE_UNARY_OBJ(Relu, OpType::Relu)
+  DEFINE_UNARY_OBJ(Sigmoid, OpType::Sigmoid)
+  DEFINE_UNARY_OBJ(Tanh, OpType::Tanh)
+  // Exact GELU, x * Phi(x), as ONNX Gelu with approximate = "none".
+  DEFINE_UNARY_OBJ(Gelu, OpType::Gelu)
+  // x * sigmoid(x), also known as Swish.
+  DEFINE_UNARY_OBJ(Silu, OpType::Silu)
+  DEFINE_UNARY_OBJ(Exp, OpType::Exp)
+  DEFINE_UNARY_OBJ(Erf, OpType::Erf)
 }; // namespace infini
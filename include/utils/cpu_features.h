@@ -0,0 +1,62 @@
+#pragma once
+#include "core/common.h"
+
+namespace infini {
+
+/**
+ * @brief Instruction set levels that have dedicated kernel translation units.
+ * Each level implies the ones before it.
+ */
+enum class CpuIsa { Scalar = 0, SSE4, AVX2, AVX512 };
+
+const char *cpu_isa_to_str(CpuIsa isa);
+
+/**
+ * @brief Features of the host CPU, probed once with CPUID (plus XGETBV for
+ * the register state enabled by the OS).
+ *
+ * The environment variable INFINI_CPU_ISA (scalar, sse4, avx2, avx512) caps
+ * the ISA level reported by getIsa(), which is handy for comparing kernels.
+ */
+class CpuFeatures {
+  private:
+    bool sse41 = false, sse42 = false, avx = false, avx2 = false, fma = false,
+         f16c = false;
+    bool avx512f = false, avx512bw = false, avx512dq = false, avx512vl = false,
+         avx512vnni = false, avx512bf16 = false, avxvnni = false;
+    size_t l1CacheSize, l2CacheSize, l3CacheSize;
+    CpuIsa isa;
+
+    CpuFeatures();
+
+  public:
+    static const CpuFeatures &getInstance();
+
+    bool hasSse41() const { return sse41; }
+    bool hasSse42() const { return sse42; }
+    bool hasAvx() const { return avx; }
+    bool hasAvx2() const { return avx2; }
+    bool hasFma() const { return fma; }
+    bool hasF16c() const { return f16c; }
+    bool hasAvx512f() const { return avx512f; }
+    bool hasAvx512bw() const { return avx512bw; }
+    bool hasAvx512dq() const { return avx512dq; }
+    bool hasAvx512vl() const { return avx512vl; }
+    bool hasAvx512Vnni() const { return avx512vnni; }
+    bool hasAvx512Bf16() const { return avx512bf16; }
+    bool hasAvxVnni() const { return avxvnni; }
+
+    // Data cache sizes in bytes, with conservative defaults if unknown.
+    size_t getL1CacheSize() const { return l1CacheSize; }
+    size_t getL2CacheSize() const { return l2CacheSize; }
+    size_t getL3CacheSize() const { return l3CacheSize; }
+
+    // Highest ISA level usable for kernel dispatch on this host.
+    CpuIsa getIsa() const { return isa; }
+    // Whether the host (regardless of INFINI_CPU_ISA) can run `level`.
+    bool supports(CpuIsa level) const;
+
+    string toString() const;
+};
+
+} // namespace infini
@@ -0,0 +1,70 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace infini {
+
+// Float16 and BFloat16 tensors store raw uint16_t bit patterns. These scalar
+// conversions round to nearest even, keep NaN quiet and handle subnormals;
+// the SIMD conversions in SimdKernels produce bit-identical results.
+
+inline uint32_t fp32_to_bits(float f) {
+    uint32_t w;
+    std::memcpy(&w, &f, sizeof(w));
+    return w;
+}
+
+inline float fp32_from_bits(uint32_t w) {
+    float f;
+    std::memcpy(&f, &w, sizeof(f));
+    return f;
+}
+
+inline float float16_to_float(uint16_t h) {
+    // Normal numbers: move exponent and mantissa into place and rescale the
+    // exponent bias with one multiplication. Subnormals: build 0.5 + m*2^-24
+    // in float and subtract 0.5.
+    const uint32_t w = uint32_t(h) << 16;
+    const uint32_t sign = w & 0x80000000u;
+    const uint32_t twoW = w + w;
+    const float normalized =
+        fp32_from_bits((twoW >> 4) + (0xe0u << 23)) * 0x1.0p-112f;
+    const float denormalized = fp32_from_bits((twoW >> 17) | (126u << 23)) - 0.5f;
+    return fp32_from_bits(sign | (twoW < (1u << 27) ? fp32_to_bits(denormalized)
+                                                     : fp32_to_bits(normalized)));
+}
+
+inline uint16_t float_to_float16(float f) {
+    // Scaling by 2^112 * 2^-110 lets the FPU do the round-to-nearest-even
+    // at the half precision boundary, including overflow to infinity.
+    float base = (std::fabs(f) * 0x1.0p+112f) * 0x1.0p-110f;
+    const uint32_t w = fp32_to_bits(f);
+    const uint32_t shl1W = w + w;
+    const uint32_t sign = w & 0x80000000u;
+    uint32_t bias = shl1W & 0xff000000u;
+    if (bias < 0x71000000u)
+        bias = 0x71000000u;
+    base = fp32_from_bits((bias >> 1) + 0x07800000u) + base;
+    const uint32_t bits = fp32_to_bits(base);
+    const uint32_t expBits = (bits >> 13) & 0x00007c00u;
+    const uint32_t mantissaBits = bits & 0x00000fffu;
+    const uint32_t nonsign = expBits + mantissaBits;
+    // NaN stays quiet and keeps the top of its payload, as F16C does.
+    const uint32_t nan = 0x7e00u | ((w >> 13) & 0x3ffu);
+    return (sign >> 16) | (shl1W > 0xff000000u ? nan : nonsign);
+}
+
+inline float bfloat16_to_float(uint16_t b) {
+    return fp32_from_bits(uint32_t(b) << 16);
+}
+
+inline uint16_t float_to_bfloat16(float f) {
+    uint32_t w = fp32_to_bits(f);
+    if ((w & 0x7fffffffu) > 0x7f800000u)
+        return uint16_t((w >> 16) | 0x40u);
+    w += 0x7fffu + ((w >> 16) & 1u);
+    return uint16_t(w >> 16);
+}
+
+} // namespace infini
@@ -113,6 +113,7 @@ namespace infini
             if (prev->first + prev->second == it->first) {
                 prev->second += it->second; 
                 freeBlocks.erase(it);       
+                it = prev;
             }
         }
 
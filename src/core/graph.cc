@@ -1,12 +1,93 @@
 #include "core/graph.h"
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <queue>
+#include <unordered_set>
+#include "operators/concat.h"
+#include "operators/fused_element_wise.h"
 #include "operators/matmul.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
 
 namespace infini
 {
+    namespace
+    {
+        // tensor -> (tensor whose buffer it lives in, byte offset)
+        using AliasMap =
+            std::unordered_map<TensorObj *, std::pair<TensorObj *, size_t>>;
+
+        // Finds the Concat inputs that can be written by their producer
+        // straight into their slice of the Concat output. This needs the
+        // slice to be contiguous (all dims before the axis are 1), and the
+        // input to be a computed tensor read by nothing but this Concat, once.
+        AliasMap planConcatAliases(const OpVec &ops)
+        {
+            AliasMap aliases;
+            for (auto &op : ops)
+            {
+                if (op->getOpType() != OpType::Concat)
+                    continue;
+                auto concat = as<ConcatObj>(op);
+                auto output = concat->getOutput();
+                const auto &outDim = output->getDims();
+                int outer = 1;
+                for (int i = 0; i < concat->getDim(); ++i)
+                    outer *= outDim[i];
+                if (outer != 1)
+                    continue;
+                auto inputs = concat->getInputs();
+                size_t offset = 0;
+                for (auto &input : inputs)
+                {
+                    bool once = std::count(inputs.begin(), inputs.end(),
+                                           input) == 1;
+                    if (once && input->getSource() &&
+                        input->getTargets().size() == 1)
+                        aliases[input.get()] = {output.get(), offset};
+                    offset += input->getBytes();
+                }
+            }
+            return aliases;
+        }
+
+        // Ops whose output element i depends only on element i of each
+        // input of the output's shape, so that the output can be written
+        // over such an input. A Cast qualifies when it keeps the element
+        // size, so that both sides index the same bytes, and so do Softmax
+        // and the normalizations, whose kernels read every element of a row
+        // before writing it.
+        bool canRunInPlace(const Operator &op)
+        {
+            switch (op->getOpType().underlying())
+            {
+            case OpType::Add:
+            case OpType::Sub:
+            case OpType::Mul:
+            case OpType::Div:
+            case OpType::Relu:
+            case OpType::Clip:
+            case OpType::Erf:
+            case OpType::Exp:
+            case OpType::Gelu:
+            case OpType::Sigmoid:
+            case OpType::Silu:
+            case OpType::Tanh:
+            case OpType::FusedElementWise:
+            case OpType::Softmax:
+            case OpType::LayerNormalization:
+            case OpType::RMSNormalization:
+                return true;
+            case OpType::Cast:
+                return op->getInputs(0)->getDType().getSize() ==
+                       op->getOutput()->getDType().getSize();
+            default:
+                return false;
+            }
+        }
+    } // namespace
+
     void GraphObj::addOperatorAndConnect(const Operator &op)
     {
         sorted = false;
@@ -117,6 +198,86 @@ namespace infini
             return (perm[r - 1] == r - 2 && perm[r - 2] == r - 1);
         };
 
+        // The graph outputs are kept even though nothing reads them.
+        std::unordered_set<TensorObj *> graphOutputs;
+        for (auto &tensor : getOutputs())
+            graphOutputs.insert(tensor.get());
+
+        // MatMul 之后的算子折叠进 epilogue，成功返回 true
+        std::unordered_set<OperatorObj *> folded;
+        auto foldIntoMatmul = [&](const Ref<MatmulObj> &matmul,
+                                  const Operator &next) {
+            auto output = matmul->getOutput();
+            const bool bare = !matmul->getBias() && !matmul->getResidual() &&
+                              matmul->getActivation() == OpType::Unknown;
+            Tensor other;
+            switch (next->getOpType().underlying()) {
+            case OpType::Add: {
+                other = next->getInputs(0) == output ? next->getInputs(1)
+                                                     : next->getInputs(0);
+                const auto &dims = other->getDims();
+                bool row = !dims.empty() &&
+                           dims.back() == output->getDims().back() &&
+                           dims.size() <= output->getRank() &&
+                           std::all_of(dims.begin(), dims.end() - 1,
+                                       [](int d) { return d == 1; });
+                if (bare && row)
+                    matmul->setBias(other);
+                else if (!matmul->getResidual() &&
+                         matmul->getActivation() == OpType::Unknown &&
+                         dims == output->getDims())
+                    matmul->setResidual(other);
+                else
+                    return false;
+                break;
+            }
+            case OpType::Relu:
+            case OpType::Gelu:
+                if (matmul->getActivation() != OpType::Unknown)
+                    return false;
+                matmul->setActivation(next->getOpType());
+                break;
+            case OpType::Clip: {
+                if (matmul->getActivation() != OpType::Unknown)
+                    return false;
+                auto clip = as<ClipObj>(next);
+                matmul->setActivation(OpType::Clip,
+                                      clip->getMin().value_or(-INFINITY),
+                                      clip->getMax().value_or(INFINITY));
+                break;
+            }
+            default:
+                return false;
+            }
+            // 重新连线：MatMul 直接产出 next 的输出
+            // The op links follow the tensors, as in addOperatorAndConnect.
+            matmul->removeSuccessors(next);
+            next->removePredecessors(matmul);
+            if (other) {
+                other->removeTarget(next);
+                other->addTarget(matmul);
+                if (auto source = other->getSource()) {
+                    source->removeSuccessors(next);
+                    next->removePredecessors(source);
+                    source->addSuccessors(matmul);
+                    matmul->addPredecessors(source);
+                }
+            }
+            output->removeTarget(next);
+            removeTensor(output);
+            auto newOutput = next->getOutput();
+            matmul->outputs[0] = newOutput;
+            newOutput->setSource(matmul);
+            for (auto &succ : newOutput->getTargets()) {
+                next->removeSuccessors(succ);
+                succ->removePredecessors(next);
+                matmul->addSuccessors(succ);
+                succ->addPredecessors(matmul);
+            }
+            folded.insert(next.get());
+            return true;
+        };
+
         bool changed = true;
         while (changed) {
             changed = false;
@@ -147,6 +308,17 @@ namespace infini
                     }
                 }
 
+                // Add(bias)、Add(residual) 与 Relu/Clip/Gelu 融入 MatMul
+                if (op->getOpType() == OpType::MatMul) {
+                    auto matmul = std::dynamic_pointer_cast<MatmulObj>(op);
+                    auto output = matmul->getOutput();
+                    auto targets = output->getTargets();
+                    if (output->getDType() == DataType::Float32 &&
+                        targets.size() == 1 &&
+                        foldIntoMatmul(matmul, targets[0]))
+                        changed = true;
+                }
+
                 // 连续冗余 Transpose 消除 
                 if (op->getOpType() == OpType::Transpose) {
                     auto trans2 = std::dynamic_pointer_cast<TransposeObj>(op);
@@ -174,15 +346,22 @@ namespace infini
             // 彻底移除被优化掉的算子
             // 只有这里真正删除了算子，shared_ptr 计数才会归零，防止 bad_weak_ptr
             ops.erase(std::remove_if(ops.begin(), ops.end(), [&](const Operator &o) {
-                // 如果算子不是 MatMul，且它的所有输出都没有人用了，就删掉它
-                if (o->getOpType() == OpType::MatMul) return false;
+                // 已折叠进 MatMul 的算子直接删掉
+                if (folded.count(o.get())) {
+                    for (auto &in : o->getInputs()) in->removeTarget(o);
+                    return true;
+                }
+                // 如果算子的所有输出都没有人用了，且不是图的输出，就删掉它
                 for (auto &out : o->getOutputs()) {
-                    if (!out->getTargets().empty()) return false;
+                    if (!out->getTargets().empty() ||
+                        graphOutputs.count(out.get()))
+                        return false;
                 }
                 // 删除前，断开它与输入 Tensor 的联系
                 for (auto &in : o->getInputs()) in->removeTarget(o);
                 return true;
             }), ops.end());
+            folded.clear();
 
             // 移除中间残留的中间 Tensor 
             tensors.erase(std::remove_if(tensors.begin(), tensors.end(), [](const Tensor &t) {
@@ -192,6 +371,8 @@ namespace infini
             }), tensors.end());
         }
 
+        fuseElementWise();
+
         // 重建算子间的拓扑连接
         // 因为前面的逻辑打乱了算子间的双向弱引用，必须全部重来
         for (auto &op : ops) {
@@ -211,6 +392,137 @@ namespace infini
         this->sorted = false;
     }
 
+    void GraphObj::fuseElementWise()
+    {
+        IT_ASSERT(topo_sort() == true);
+        auto fusible = [](const Operator &op)
+        {
+            if (!FusedElementWiseObj::canFuse(op->getOpType()))
+                return false;
+            for (auto &tensor : op->getInputs())
+                if (!(tensor->getDType() == DataType::Float32))
+                    return false;
+            return op->getOutput()->getDType() == DataType::Float32;
+        };
+
+        // Groups of fusible ops joined by tensors that have the output shape
+        // and exactly one reader, so that they need not be materialized. A
+        // group is a tree: only its last op has readers outside of it.
+        std::unordered_map<OperatorObj *, size_t> position, groupOf;
+        vector<OpVec> groups;
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            auto &op = ops[i];
+            position[op.get()] = i;
+            if (!fusible(op))
+                continue;
+            size_t g = groups.size();
+            for (auto &input : op->getInputs())
+            {
+                auto source = input->getSource();
+                if (!source || !groupOf.count(source.get()) ||
+                    input->getTargets().size() != 1 ||
+                    input->getDims() != op->getOutput()->getDims())
+                    continue;
+                size_t h = groupOf[source.get()];
+                if (g == groups.size())
+                    g = h;
+                else if (h != g)
+                {
+                    for (auto &member : groups[h])
+                        groupOf[member.get()] = g;
+                    groups[g].insert(groups[g].end(), groups[h].begin(),
+                                     groups[h].end());
+                    groups[h].clear();
+                }
+            }
+            if (g == groups.size())
+                groups.emplace_back();
+            groups[g].emplace_back(op);
+            groupOf[op.get()] = g;
+        }
+
+        for (auto &group : groups)
+        {
+            if (group.size() < 2)
+                continue;
+            std::sort(group.begin(), group.end(),
+                      [&](const Operator &a, const Operator &b)
+                      { return position[a.get()] < position[b.get()]; });
+            std::unordered_set<OperatorObj *> members;
+            for (auto &op : group)
+                members.insert(op.get());
+            auto internal = [&](const Tensor &tensor)
+            {
+                auto source = tensor->getSource();
+                return source && members.count(source.get());
+            };
+
+            // Registers: the distinct inputs first, then the intermediate
+            // results. Each of those is read once, so its register is free
+            // again as soon as the step that reads it has.
+            TensorVec inputs;
+            std::unordered_map<TensorObj *, int> reg;
+            for (auto &op : group)
+                for (auto &tensor : op->getInputs())
+                    if (!internal(tensor) && !reg.count(tensor.get()))
+                    {
+                        reg[tensor.get()] = inputs.size();
+                        inputs.emplace_back(tensor);
+                    }
+            int numRegisters = inputs.size();
+            vector<int> freeRegisters;
+            vector<FusedStep> steps;
+            for (auto &op : group)
+            {
+                FusedStep step{op->getOpType(), 0, reg[op->getInputs(0).get()],
+                               -1, -INFINITY, INFINITY};
+                if (op->numInputs() == 2)
+                    step.in1 = reg[op->getInputs(1).get()];
+                if (op->getOpType() == OpType::Clip)
+                {
+                    auto clip = as<ClipObj>(op);
+                    step.min = clip->getMin().value_or(-INFINITY);
+                    step.max = clip->getMax().value_or(INFINITY);
+                }
+                for (auto &tensor : op->getInputs())
+                    if (internal(tensor))
+                        freeRegisters.emplace_back(reg[tensor.get()]);
+                if (freeRegisters.empty())
+                    step.out = numRegisters++;
+                else
+                {
+                    step.out = freeRegisters.back();
+                    freeRegisters.pop_back();
+                }
+                reg[op->getOutput().get()] = step.out;
+                steps.emplace_back(step);
+            }
+
+            // The output tensor exists already, so no graph is passed to
+            // create it (see OperatorObj::checkValid).
+            auto output = group.back()->getOutput();
+            auto fused = make_ref<FusedElementWiseObj>(
+                nullptr, inputs, output, std::move(steps), numRegisters);
+            for (auto &op : group)
+            {
+                for (auto &pred : op->getPredecessors())
+                    pred->removeSuccessors(op);
+                for (auto &succ : op->getSuccessors())
+                    succ->removePredecessors(op);
+                for (auto &tensor : op->getInputs())
+                {
+                    tensor->removeTarget(op);
+                    if (internal(tensor))
+                        removeTensor(tensor);
+                }
+                removeOperator(op);
+            }
+            addOperatorAndConnect(fused);
+        }
+        sorted = false;
+    }
+
 
     Tensor GraphObj::getTensor(int fuid) const
     {
@@ -247,7 +559,7 @@ namespace infini
         }
     }
 
-    void GraphObj::dataMalloc() {
+    void GraphObj::dataMalloc(bool inPlace, bool reuse) {
         IT_ASSERT(topo_sort() == true);
 
         std::unordered_map<TensorObj *, size_t> offsets;
@@ -261,7 +573,7 @@ namespace infini
         // 给没有源头的tensor也要分配空间
         for (auto &tensor : tensors) {
             // 如果一个 Tensor 没有来源算子，说明它是输入或权重
-            if (!tensor->getSource()) {
+            if (!tensor->getSource() && !tensor->hasData()) {
                 size_t size = tensor->getBytes();
                 if (size > 0) {
                     offsets[tensor.get()] = allocator.alloc(size);
@@ -270,13 +582,64 @@ namespace infini
         }
         // =================================================================
 
+        // Concat inputs placed inside the Concat output share its block: it
+        // is allocated when the first of them is produced and freed with the
+        // Concat output, nested Concats resolve to the outermost buffer.
+        auto aliases = planConcatAliases(ops);
+        std::function<void(TensorObj *)> allocate = [&](TensorObj *tensor)
+        {
+            auto it = aliases.find(tensor);
+            if (it == aliases.end())
+            {
+                offsets[tensor] = allocator.alloc(tensor->getBytes());
+                return;
+            }
+            auto [base, offset] = it->second;
+            if (!offsets.count(base))
+                allocate(base);
+            offsets[tensor] = offsets[base] + offset;
+        };
+
+        // Outputs written over an input that dies at their op: the buffer
+        // moves on to the output and is freed with it.
+        std::unordered_set<TensorObj *> handedOver;
+        auto reuseInput = [&](const Operator &op)
+        {
+            auto output = op->getOutput();
+            auto inputs = op->getInputs();
+            for (auto &input : inputs)
+            {
+                auto t_ptr = input.get();
+                // Graph inputs are left to the caller, and Concat slices
+                // belong to the Concat output.
+                if (!input->getSource() || !offsets.count(t_ptr) ||
+                    aliases.count(t_ptr) || handedOver.count(t_ptr))
+                    continue;
+                size_t uses = std::count(inputs.begin(), inputs.end(), input);
+                if (refCount[t_ptr] == uses &&
+                    input->getDims() == output->getDims() &&
+                    input->getBytes() == output->getBytes())
+                {
+                    offsets[output.get()] = offsets[t_ptr];
+                    handedOver.insert(t_ptr);
+                    return;
+                }
+            }
+        };
+
         // 离线规划：遍历算子
         for (auto &op : ops) {
             // 分配输出
+            if (inPlace && op->numOutputs() == 1 && canRunInPlace(op)) {
+                auto output = op->getOutput().get();
+                if (output->getBytes() > 0 && !offsets.count(output) &&
+                    !aliases.count(output))
+                    reuseInput(op);
+            }
             for (auto &tensor : op->getOutputs()) {
                 size_t size = tensor->getBytes();
-                if (size > 0) {
-                    offsets[tensor.get()] = allocator.alloc(size);
+                if (size > 0 && !offsets.count(tensor.get())) {
+                    allocate(tensor.get());
                 }
             }
 
@@ -287,7 +650,10 @@ namespace infini
                     refCount[t_ptr]--;
                     if (refCount[t_ptr] == 0) {
                         // 只有分配过的（在 offsets 里的）才需要释放
-                        if (offsets.count(t_ptr)) {
+                        // Graph inputs are read again by every run.
+                        if (reuse && tensor->getSource() &&
+                            offsets.count(t_ptr) && !aliases.count(t_ptr) &&
+                            !handedOver.count(t_ptr)) {
                             allocator.free(offsets[t_ptr], tensor->getBytes());
                         }
                     }
@@ -309,6 +675,26 @@ namespace infini
         allocator.info();
     }
 
+    Graph GraphObj::clone() const
+    {
+        Graph graph = make_ref<GraphObj>(runtime);
+        std::unordered_map<TensorObj *, Tensor> copies;
+        for (auto &tensor : tensors)
+            copies[tensor.get()] =
+                graph->addTensor(tensor->getDims(), tensor->getDType());
+        auto copy = [&](const TensorVec &vec)
+        {
+            TensorVec ret;
+            for (auto &tensor : vec)
+                ret.emplace_back(tensor ? copies.at(tensor.get()) : nullptr);
+            return ret;
+        };
+        for (auto &op : ops)
+            graph->addOperatorAndConnect(
+                op->clone(copy(op->getInputs()), copy(op->getOutputs())));
+        return graph;
+    }
+
     Tensor GraphObj::addTensor(Shape dim, DataType dtype)
     {
         return tensors.emplace_back(make_ref<TensorObj>(dim, dtype, runtime));
@@ -21,6 +21,28 @@ namespace infini
             CASE(Transpose);
             CASE(Concat);
             CASE(MatMul);
+            CASE(Erf);
+            CASE(Exp);
+            CASE(Gelu);
+            CASE(Sigmoid);
+            CASE(Silu);
+            CASE(Tanh);
+            CASE(FusedElementWise);
+            CASE(QuantizeLinear);
+            CASE(DequantizeLinear);
+            CASE(ReduceSum);
+            CASE(ReduceMean);
+            CASE(ReduceMax);
+            CASE(ReduceMin);
+            CASE(Softmax);
+            CASE(LayerNormalization);
+            CASE(RMSNormalization);
+            CASE(Conv);
+            CASE(MaxPool);
+            CASE(AveragePool);
+            CASE(GlobalAveragePool);
+            CASE(Gather);
+            CASE(EmbeddingBag);
 
         default:
             return "Unknown";
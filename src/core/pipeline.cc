@@ -0,0 +1,140 @@
+#include "core/pipeline.h"
+#include "core/graph.h"
+#include <algorithm>
+#include <cstring>
+
+namespace infini {
+
+namespace {
+vector<int> indicesIn(const TensorVec &all, const TensorVec &tensors) {
+    vector<int> ret;
+    for (auto &tensor : tensors) {
+        auto it = std::find(all.begin(), all.end(), tensor);
+        IT_ASSERT(it != all.end(), "Tensor not in the graph");
+        ret.emplace_back(it - all.begin());
+    }
+    return ret;
+}
+
+TensorVec pick(const TensorVec &all, const vector<int> &indices) {
+    TensorVec ret;
+    for (int i : indices)
+        ret.emplace_back(all[i]);
+    return ret;
+}
+} // namespace
+
+Pipeline::Pipeline(Ref<NativeCpuRuntimeObj> rt, Graph graph, TensorVec inputs,
+                   int depth)
+    : runtime(std::move(rt)) {
+    IT_ASSERT(depth >= 1);
+    const auto &tensors = graph->getTensors();
+    for (auto &tensor : tensors)
+        IT_ASSERT(tensor->getBytes() == 0 || tensor->hasData(),
+                  "The graph must be allocated first");
+    const auto inputIndices = indicesIn(tensors, inputs);
+    const auto outputIndices = indicesIn(tensors, graph->getOutputs());
+    // Graph inputs no request sets, shared by the clones.
+    vector<int> shared;
+    for (size_t i = 0; i < tensors.size(); ++i)
+        if (!tensors[i]->getSource() &&
+            std::find(inputIndices.begin(), inputIndices.end(), int(i)) ==
+                inputIndices.end())
+            shared.emplace_back(i);
+
+    for (int s = 0; s < depth; ++s) {
+        Graph g = graph;
+        if (s > 0) {
+            g = graph->clone();
+            for (int i : shared)
+                g->getTensors()[i]->setDataBlob(tensors[i]->getDataBlob());
+            g->dataMalloc();
+        }
+        auto plan = runtime->compile(g);
+        slots.push_back({g, pick(g->getTensors(), inputIndices),
+                         pick(g->getTensors(), outputIndices),
+                         std::move(plan)});
+        freeSlots.emplace_back(depth - 1 - s);
+    }
+}
+
+Pipeline::~Pipeline() { wait(); }
+
+void Pipeline::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return outstanding == 0; });
+}
+
+void Pipeline::submit(vector<Buffer> inputs, Callback done) {
+    const auto &tensors = slots[0].inputs;
+    IT_ASSERT(inputs.size() == tensors.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+        IT_ASSERT(inputs[i].size() == tensors[i]->getBytes(),
+                  "Input " + std::to_string(i) + " has the wrong size");
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++outstanding;
+        if (freeSlots.empty()) {
+            queue.push_back({std::move(inputs), std::move(done)});
+            return;
+        }
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    start(slot, {std::move(inputs), std::move(done)});
+}
+
+std::future<vector<Pipeline::Buffer>>
+Pipeline::submit(vector<Buffer> inputs) {
+    auto promise = std::make_shared<std::promise<vector<Buffer>>>();
+    auto future = promise->get_future();
+    submit(std::move(inputs),
+           [promise](vector<Buffer> outputs, std::exception_ptr error) {
+               if (error)
+                   promise->set_exception(error);
+               else
+                   promise->set_value(std::move(outputs));
+           });
+    return future;
+}
+
+void Pipeline::start(int slot, Request request) {
+    auto &s = slots[slot];
+    for (size_t i = 0; i < s.inputs.size(); ++i)
+        std::memcpy(s.inputs[i]->getRawDataPtr<void *>(),
+                    request.inputs[i].data(), request.inputs[i].size());
+    runtime->runAsync(
+        s.plan, [this, slot, done = std::move(request.done)](
+                    std::exception_ptr error) { finish(slot, done, error); });
+}
+
+void Pipeline::finish(int slot, Callback done, std::exception_ptr error) {
+    vector<Buffer> outputs;
+    if (!error)
+        for (auto &tensor : slots[slot].outputs) {
+            auto data = tensor->getRawDataPtr<uint8_t *>();
+            outputs.emplace_back(data, data + tensor->getBytes());
+        }
+    // The slot goes to the oldest waiting request, before the callback runs.
+    std::optional<Request> next;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty())
+            freeSlots.emplace_back(slot);
+        else {
+            next = std::move(queue.front());
+            queue.pop_front();
+        }
+    }
+    if (next)
+        start(slot, std::move(*next));
+    done(std::move(outputs), error);
+    // Notified under the lock, as the destructor may return as soon as it
+    // can take it.
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--outstanding == 0)
+        idle.notify_all();
+}
+
+} // namespace infini
@@ -0,0 +1,226 @@
+#include "core/profiler.h"
+#include "operators/conv.h"
+#include "operators/fused_element_wise.h"
+#include "operators/matmul.h"
+#include "operators/pooling.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace infini {
+
+void Profiler::OpStats::add(double time) {
+    ++calls;
+    totalTime += time;
+    if (samples.size() < maxSamples) {
+        samples.emplace_back(time);
+        return;
+    }
+    // The call replaces a sample with probability maxSamples / calls.
+    const size_t i = std::uniform_int_distribution<size_t>(0, calls - 1)(rng);
+    if (i < maxSamples)
+        samples[i] = time;
+}
+
+double Profiler::OpStats::percentile(double p) const {
+    if (samples.empty())
+        return 0;
+    vector<double> sorted(samples);
+    const size_t rank = std::clamp<size_t>(
+        size_t(std::ceil(p / 100 * sorted.size())), 1, sorted.size());
+    std::nth_element(sorted.begin(), sorted.begin() + rank - 1, sorted.end());
+    return sorted[rank - 1];
+}
+
+void Profiler::record(const Operator &op, const string &kernel,
+                      Clock::time_point start, Clock::time_point end) {
+    using us = std::chrono::duration<double, std::micro>;
+    const double duration = us(end - start).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = stats.try_emplace(op->getGuid());
+    OpStats &s = it->second;
+    if (inserted) {
+        s.name = string(op->getOpType().toString()) + "[" +
+                 to_string(op->getGuid()) + "]";
+        s.kernel = kernel;
+        s.bytes = 0;
+        for (const auto &t : op->getInputs()) {
+            s.inputs.emplace_back(t->getDims());
+            s.bytes += t->getBytes();
+        }
+        for (const auto &t : op->getOutputs()) {
+            s.outputs.emplace_back(t->getDims());
+            s.bytes += t->getBytes();
+        }
+        s.flops = estimateFlops(op);
+    }
+    s.add(duration);
+
+    if (events.size() >= maxEvents) {
+        ++droppedEvents;
+        return;
+    }
+    auto thread =
+        threads.try_emplace(std::this_thread::get_id(), threads.size()).first;
+    events.push_back({op->getGuid(), us(start - epoch).count(), duration,
+                      thread->second});
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+    droppedEvents = 0;
+    stats.clear();
+}
+
+vector<Profiler::OpStats> Profiler::getStats() const {
+    vector<OpStats> ret;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &[guid, s] : stats)
+            ret.emplace_back(s);
+    }
+    vector<double> totals;
+    for (const auto &s : ret)
+        totals.emplace_back(s.total());
+    vector<size_t> order(ret.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return totals[a] > totals[b];
+    });
+    vector<OpStats> sorted;
+    for (size_t i : order)
+        sorted.emplace_back(std::move(ret[i]));
+    return sorted;
+}
+
+size_t Profiler::getNumEvents() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return events.size();
+}
+
+static string shapesToString(const vector<Shape> &shapes) {
+    string ret;
+    for (const auto &shape : shapes)
+        ret += (ret.empty() ? "" : ",") + vecToString(shape);
+    return ret;
+}
+
+string Profiler::summary() const {
+    const auto all = getStats();
+    double sum = 0;
+    for (const auto &s : all)
+        sum += s.total();
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1);
+    os << std::left << std::setw(28) << "op" << std::setw(28) << "kernel"
+       << std::right << std::setw(8) << "calls" << std::setw(12)
+       << "total(us)" << std::setw(7) << "%" << std::setw(10) << "p50(us)"
+       << std::setw(10) << "p99(us)" << std::setw(10) << "GFLOP/s"
+       << std::setw(9) << "GB/s"
+       << "  inputs -> outputs\n";
+    for (const auto &s : all) {
+        const double total = s.total(), mean = total / s.calls;
+        // Per microsecond over 1e3 is giga per second.
+        os << std::left << std::setw(28) << s.name << std::setw(28)
+           << s.kernel << std::right << std::setw(8) << s.calls
+           << std::setw(12) << total << std::setw(7)
+           << (sum > 0 ? 100 * total / sum : 0) << std::setw(10)
+           << s.percentile(50) << std::setw(10) << s.percentile(99)
+           << std::setw(10) << (mean > 0 ? s.flops / mean / 1e3 : 0)
+           << std::setw(9) << (mean > 0 ? s.bytes / mean / 1e3 : 0) << "  "
+           << shapesToString(s.inputs) << " -> "
+           << shapesToString(s.outputs) << "\n";
+    }
+    os << "total " << sum << " us in " << all.size() << " ops\n";
+    return os.str();
+}
+
+static string escapeJson(const string &s) {
+    string ret;
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            ret += '\\';
+        ret += c;
+    }
+    return ret;
+}
+
+string Profiler::chromeTrace() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(3);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto &e = events[i];
+        const auto &s = stats.at(e.guid);
+        os << (i ? ",\n" : "\n") << "{\"name\":\"" << escapeJson(s.name)
+           << "\",\"cat\":\"op\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.thread
+           << ",\"ts\":" << e.start << ",\"dur\":" << e.duration
+           << ",\"args\":{\"kernel\":\"" << escapeJson(s.kernel)
+           << "\",\"inputs\":\"" << shapesToString(s.inputs)
+           << "\",\"outputs\":\"" << shapesToString(s.outputs)
+           << "\",\"bytes\":" << s.bytes << ",\"flops\":" << s.flops << "}}";
+    }
+    os << "\n],\"otherData\":{\"droppedEvents\":" << droppedEvents << "}}\n";
+    return os.str();
+}
+
+void Profiler::dumpChromeTrace(const string &path) const {
+    std::ofstream file(path);
+    IT_ASSERT(file.is_open(), "Cannot open " + path);
+    file << chromeTrace();
+}
+
+double Profiler::estimateFlops(const Operator &op) {
+    const double out = op->getOutput()->size();
+    const double in = op->getInputs(0)->size();
+    switch (op->getOpType().underlying()) {
+    case OpType::MatMul: {
+        auto matmul = as<MatmulObj>(op);
+        return 2 * out * matmul->getK();
+    }
+    case OpType::Conv: {
+        const auto &w = op->getInputs(1)->getDims();
+        return 2 * out * w[1] * w[2] * w[3];
+    }
+    case OpType::MaxPool:
+    case OpType::AveragePool: {
+        auto pool = as<PoolingObj>(op);
+        return out * pool->getKh() * pool->getKw();
+    }
+    case OpType::FusedElementWise:
+        return out * as<FusedElementWiseObj>(op)->getSteps().size();
+    case OpType::ReduceSum:
+    case OpType::ReduceMean:
+    case OpType::ReduceMax:
+    case OpType::ReduceMin:
+    case OpType::GlobalAveragePool:
+        return in;
+    case OpType::EmbeddingBag:
+        return double(op->getOutput()->getDims()[1]) *
+               op->getInputs(1)->size();
+    // A max, an exp, a sum and a product per element.
+    case OpType::Softmax:
+        return 4 * in;
+    case OpType::LayerNormalization:
+        return 5 * in;
+    case OpType::RMSNormalization:
+        return 4 * in;
+    case OpType::QuantizeLinear:
+    case OpType::DequantizeLinear:
+        return 2 * out;
+    // Data movement.
+    case OpType::Transpose:
+    case OpType::Concat:
+    case OpType::Gather:
+    case OpType::Cast:
+        return 0;
+    default:
+        return out;
+    }
+}
+
+} // namespace infini
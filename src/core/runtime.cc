@@ -1,23 +1,317 @@
 #include "core/runtime.h"
 #include "core/blob.h"
+#include "core/execution_plan.h"
 #include "core/kernel.h"
 #include "core/graph.h"
-#include "core/kernel.h"
+#include "core/profiler.h"
+#include "core/thread_pool.h"
 #include <chrono>
 #include <cstring>
+#include <deque>
 #include <memory>
 namespace infini
 {
+    namespace
+    {
+        // Byte ranges [begin, end) of the allocated tensors.
+        using Range = std::pair<uintptr_t, uintptr_t>;
+
+        vector<Range> byteRanges(const TensorVec &tensors)
+        {
+            vector<Range> ranges;
+            for (auto &tensor : tensors)
+            {
+                if (!tensor || tensor->getBytes() == 0)
+                    continue;
+                auto begin = uintptr_t(tensor->getRawDataPtr<void *>());
+                ranges.emplace_back(begin, begin + tensor->getBytes());
+            }
+            return ranges;
+        }
+
+        bool overlap(const vector<Range> &a, const vector<Range> &b)
+        {
+            for (auto &[beginA, endA] : a)
+                for (auto &[beginB, endB] : b)
+                    if (beginA < endB && beginB < endA)
+                        return true;
+            return false;
+        }
+
+        // Links every step to the ones it must wait for, see ExecutionPlan.
+        void linkSteps(vector<ExecutionPlan::Step> &steps)
+        {
+            const int n = steps.size();
+            std::unordered_map<OperatorObj *, int> index;
+            vector<vector<Range>> reads(n), writes(n);
+            for (int i = 0; i < n; ++i)
+            {
+                index[steps[i].op.get()] = i;
+                reads[i] = byteRanges(steps[i].op->getInputs());
+                writes[i] = byteRanges(steps[i].op->getOutputs());
+            }
+            for (int j = 0; j < n; ++j)
+            {
+                vector<bool> waits(j, false);
+                for (auto &pred : steps[j].op->getPredecessors())
+                {
+                    auto it = index.find(pred.get());
+                    if (it != index.end() && it->second < j)
+                        waits[it->second] = true;
+                }
+                for (int i = 0; i < j; ++i)
+                    if (!waits[i] && (overlap(writes[j], reads[i]) ||
+                                      overlap(writes[j], writes[i]) ||
+                                      overlap(reads[j], writes[i])))
+                        waits[i] = true;
+                steps[j].numPredecessors = 0;
+                for (int i = 0; i < j; ++i)
+                    if (waits[i])
+                    {
+                        ++steps[j].numPredecessors;
+                        steps[i].successors.emplace_back(j);
+                    }
+            }
+        }
+
+        void runStep(const ExecutionPlan::Step &step, Profiler *profiler)
+        {
+            if (!profiler)
+            {
+                step.fn();
+                return;
+            }
+            auto start = Profiler::Clock::now();
+            step.fn();
+            auto end = Profiler::Clock::now();
+            profiler->record(step.op, *step.kernel, start, end);
+        }
+    } // namespace
+
+    NativeCpuRuntimeObj::NativeCpuRuntimeObj()
+        : RuntimeObj(Device::CPU), pool(ThreadPool::getDefault()) {}
+
+    NativeCpuRuntimeObj::~NativeCpuRuntimeObj() {}
+
     void NativeCpuRuntimeObj::run(const Graph &graph) const
     {
+        if (interOp > 1)
+        {
+            run(compile(graph));
+            return;
+        }
+        ThreadPool::Scope scope(pool.get(), intraOp);
+
         const auto &kernelRegistry = KernelRegistry::getInstance();
 
         for (auto &op : graph->getOperators())
         {
             auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
             Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
+            if (!profiler)
+            {
+                kernel->compute(op, this);
+                continue;
+            }
+            auto start = Profiler::Clock::now();
             kernel->compute(op, this);
+            auto end = Profiler::Clock::now();
+            const auto &name =
+                std::get<1>(kernelRegistry.getKernelItem(kernelAttrs));
+            profiler->record(op, name, start, end);
+        }
+    }
+
+    ExecutionPlan NativeCpuRuntimeObj::compile(const Graph &graph) const
+    {
+        const auto &kernelRegistry = KernelRegistry::getInstance();
+        vector<ExecutionPlan::Step> steps;
+        for (auto &op : graph->getOperators())
+        {
+            auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
+            Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
+            const auto &name =
+                std::get<1>(kernelRegistry.getKernelItem(kernelAttrs));
+            steps.push_back({kernel->prepare(op, this), op, &name, 0, {}});
+        }
+        linkSteps(steps);
+        return ExecutionPlan(graph, std::move(steps));
+    }
+
+    void NativeCpuRuntimeObj::run(const ExecutionPlan &plan) const
+    {
+        if (interOp > 1)
+        {
+            runConcurrently(plan);
+            return;
+        }
+        ThreadPool::Scope scope(pool.get(), intraOp);
+        for (const auto &step : plan.getSteps())
+            runStep(step, profiler.get());
+    }
+
+    namespace
+    {
+        // A run of a plan in flight on the pool, see runAsync. Every step
+        // counts down the predecessors of its successors. Of the ones it
+        // releases, the same worker runs one next and the others are
+        // queued, or parked while `limit` steps are in flight; a finishing
+        // step hands its slot to a parked one. The first exception stops
+        // further kernels and is passed on once the steps already running
+        // are done. The tasks hold the run by a Ref, since `done` may
+        // release everything else.
+        struct AsyncRun : std::enable_shared_from_this<AsyncRun>
+        {
+            const vector<ExecutionPlan::Step> &steps;
+            std::unique_ptr<std::atomic<int>[]> pending;
+            std::atomic<size_t> remaining;
+            std::atomic<bool> failed{false};
+            std::mutex mutex;
+            std::exception_ptr error;
+            // Steps in flight and the ready ones waiting for a slot.
+            int inFlight = 0;
+            const int limit, intraOp;
+            std::deque<int> parked;
+            Profiler *profiler;
+            ThreadPool &pool;
+            std::function<void(std::exception_ptr)> done;
+
+            AsyncRun(const ExecutionPlan &plan, int limit, int intraOp,
+                     Profiler *profiler, ThreadPool &pool,
+                     std::function<void(std::exception_ptr)> done)
+                : steps(plan.getSteps()),
+                  pending(new std::atomic<int>[steps.size()]),
+                  remaining(steps.size()), limit(limit), intraOp(intraOp),
+                  profiler(profiler), pool(pool), done(std::move(done))
+            {
+                for (size_t i = 0; i < steps.size(); ++i)
+                    pending[i].store(steps[i].numPredecessors,
+                                     std::memory_order_relaxed);
+            }
+
+            void start()
+            {
+                for (size_t i = 0; i < steps.size(); ++i)
+                    if (steps[i].numPredecessors == 0)
+                        launch(int(i));
+            }
+
+            void launch(int s)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (inFlight >= limit)
+                    {
+                        parked.emplace_back(s);
+                        return;
+                    }
+                    ++inFlight;
+                }
+                pool.submit([self = shared_from_this(), s]
+                            { self->execute(s); });
+            }
+
+            void execute(int i)
+            {
+                ThreadPool::Scope scope(&pool, intraOp);
+                while (i >= 0)
+                {
+                    if (!failed.load(std::memory_order_relaxed))
+                    {
+                        try
+                        {
+                            runStep(steps[i], profiler);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            if (!error)
+                                error = std::current_exception();
+                            failed = true;
+                        }
+                    }
+                    int next = -1;
+                    for (int s : steps[i].successors)
+                    {
+                        if (pending[s].fetch_sub(
+                                1, std::memory_order_acq_rel) != 1)
+                            continue;
+                        if (next < 0)
+                            next = s;
+                        else
+                            launch(s);
+                    }
+                    if (next < 0)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (parked.empty())
+                            --inFlight;
+                        else
+                        {
+                            next = parked.front();
+                            parked.pop_front();
+                        }
+                    }
+                    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        std::exception_ptr e;
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            e = error;
+                        }
+                        done(e);
+                    }
+                    i = next;
+                }
+            }
+        };
+    } // namespace
+
+    void NativeCpuRuntimeObj::runAsync(
+        const ExecutionPlan &plan,
+        std::function<void(std::exception_ptr)> done) const
+    {
+        if (plan.size() == 0)
+        {
+            done(nullptr);
+            return;
         }
+        auto run = std::make_shared<AsyncRun>(
+            plan, interOp, intraOp, profiler.get(), *pool, std::move(done));
+        run->start();
+    }
+
+    void NativeCpuRuntimeObj::runConcurrently(const ExecutionPlan &plan) const
+    {
+        std::mutex mutex;
+        std::condition_variable done;
+        bool finished = false;
+        std::exception_ptr error;
+        auto finish = [&](std::exception_ptr e)
+        {
+            // Notified under the lock, as the caller returns and destroys
+            // all of this as soon as it can take it.
+            std::lock_guard<std::mutex> lock(mutex);
+            error = e;
+            finished = true;
+            done.notify_one();
+        };
+        runAsync(plan, finish);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return finished; });
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void NativeCpuRuntimeObj::setThreadPool(const ThreadPoolConfig &config)
+    {
+        pool = make_ref<ThreadPool>(config);
+    }
+
+    void NativeCpuRuntimeObj::setThreads(int interOp, int intraOp)
+    {
+        this->interOp = std::max(interOp, 1);
+        this->intraOp = std::max(intraOp, 0);
     }
 
     string NativeCpuRuntimeObj::toString() const { return "CPU Runtime"; }
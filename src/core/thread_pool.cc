@@ -0,0 +1,247 @@
+#include "core/thread_pool.h"
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace infini {
+
+namespace {
+// The pool the calling thread works for or was given by a Scope, and its
+// index there.
+thread_local ThreadPool *currentPool = nullptr;
+thread_local int currentIndex = -1;
+// The limit of the innermost Scope, 0 for none.
+thread_local int currentParallelism = 0;
+// Set while the calling thread runs chunks of a parallelFor.
+thread_local bool inParallelFor = false;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Threads a parallelFor of the calling thread uses at most.
+int parallelismOf(const ThreadPool &pool) {
+    const int n = pool.getParallelism();
+    return currentParallelism > 0 ? std::min(n, currentParallelism) : n;
+}
+
+void pinTo(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    IT_ASSERT(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0,
+              "Cannot pin a worker to CPU " + std::to_string(cpu));
+#endif
+}
+
+// A parallelFor in flight. The helpers hold it by a Ref, since the last of
+// them may only find the chunks used up after the caller has returned.
+struct ParallelFor {
+    size_t n, grain, chunks;
+    void (*call)(const void *, size_t, size_t);
+    const void *fn;
+    std::atomic<size_t> next{0}, done{0};
+    std::atomic<bool> failed{false};
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    void work() {
+        const bool nested = inParallelFor;
+        inParallelFor = true;
+        for (size_t c; (c = next.fetch_add(1)) < chunks;) {
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    call(fn, c * grain, std::min(n, (c + 1) * grain));
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    failed = true;
+                }
+            }
+            done.fetch_add(1, std::memory_order_release);
+        }
+        inParallelFor = nested;
+    }
+};
+} // namespace
+
+ThreadPool::Scope::Scope(ThreadPool *pool, int parallelism)
+    : saved(currentPool), savedParallelism(currentParallelism) {
+    currentPool = pool;
+    currentParallelism = parallelism;
+}
+
+ThreadPool::Scope::~Scope() {
+    currentPool = saved;
+    currentParallelism = savedParallelism;
+}
+
+ThreadPool *ThreadPool::current() { return currentPool; }
+
+const Ref<ThreadPool> &ThreadPool::getDefault() {
+    static const Ref<ThreadPool> pool = make_ref<ThreadPool>();
+    return pool;
+}
+
+ThreadPool::ThreadPool(ThreadPoolConfig cfg, std::function<void(int)> init)
+    : config(std::move(cfg)) {
+    int numThreads = config.numThreads;
+    if (numThreads <= 0)
+        numThreads =
+            std::max(1, int(std::thread::hardware_concurrency()) - 1);
+    for (int i = 0; i < numThreads; ++i)
+        queues.emplace_back(std::make_unique<Queue>());
+    for (int i = 0; i < numThreads; ++i)
+        threads.emplace_back([this, i, init] { work(i, init); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto &thread : threads)
+        thread.join();
+}
+
+int ThreadPool::currentWorker() const {
+    return currentPool == this ? currentIndex : -1;
+}
+
+int ThreadPool::getParallelism() const {
+    const int n = parallelism.load(std::memory_order_relaxed);
+    return n > 0 ? std::min(n, size() + 1) : size() + 1;
+}
+
+void ThreadPool::submit(Task task) {
+    int index = currentWorker();
+    if (index < 0)
+        index = next.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.emplace_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    // Pairs with the sleeper count a worker raises before its last look at
+    // `queued`: one of them sees the other. The lock orders the notification
+    // after that look.
+    if (sleepers.load() > 0) {
+        { std::lock_guard<std::mutex> lock(mutex); }
+        wake.notify_one();
+    }
+}
+
+bool ThreadPool::pop(int index, Task &task) {
+    if (queued.load() == 0)
+        return false;
+    const int n = queues.size();
+    for (int i = 0; i < n; ++i) {
+        auto &queue = *queues[(index + i) % n];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+        // The newest own task, or the oldest of another worker.
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::work(int index, const std::function<void(int)> &init) {
+    currentPool = this;
+    currentIndex = index;
+    if (!config.cpus.empty())
+        pinTo(config.cpus[index % config.cpus.size()]);
+    if (init)
+        init(index);
+    using Clock = std::chrono::steady_clock;
+    const auto spin = std::chrono::microseconds(config.spinMicroseconds);
+    Task task;
+    while (true) {
+        if (pop(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        bool found = false;
+        const auto until = Clock::now() + spin;
+        while (!found && Clock::now() < until)
+            for (int i = 0; i < 64 && !found; ++i) {
+                cpuRelax();
+                found = queued.load(std::memory_order_relaxed) > 0;
+            }
+        if (found)
+            continue;
+        std::unique_lock<std::mutex> lock(mutex);
+        sleepers.fetch_add(1);
+        wake.wait(lock, [this] { return stop || queued.load() > 0; });
+        sleepers.fetch_sub(1);
+        if (stop && queued.load() == 0)
+            return;
+    }
+}
+
+int parallelThreads() {
+    ThreadPool *pool = ThreadPool::current();
+    return pool && !inParallelFor ? parallelismOf(*pool) : 1;
+}
+
+namespace detail {
+void parallelFor(size_t n, size_t grain,
+                 void (*call)(const void *, size_t, size_t), const void *fn) {
+    const size_t chunks = (n + grain - 1) / grain;
+    if (chunks == 0)
+        return;
+    ThreadPool *pool = ThreadPool::current();
+    const size_t helpers =
+        pool && !inParallelFor
+            ? std::min(chunks, size_t(parallelismOf(*pool))) - 1
+            : 0;
+    if (helpers == 0) {
+        for (size_t c = 0; c < chunks; ++c)
+            call(fn, c * grain, std::min(n, (c + 1) * grain));
+        return;
+    }
+
+    auto state = std::make_shared<ParallelFor>();
+    state->n = n;
+    state->grain = grain;
+    state->chunks = chunks;
+    state->call = call;
+    state->fn = fn;
+    for (size_t i = 0; i < helpers; ++i)
+        pool->submit([state] { state->work(); });
+    state->work();
+    // The chunks left are running on helpers; they are short.
+    for (int spins = 0;
+         state->done.load(std::memory_order_acquire) < chunks; ++spins) {
+        if (spins < 4096)
+            cpuRelax();
+        else
+            std::this_thread::yield();
+    }
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+} // namespace detail
+
+} // namespace infini
@@ -0,0 +1,59 @@
+#include "kernels/cpu/broadcast.h"
+
+namespace infini {
+
+BroadcastPlan::BroadcastPlan(const Shape &a, const Shape &b, const Shape &c) {
+    const int rankC = c.size();
+    IT_ASSERT((int)a.size() <= rankC && (int)b.size() <= rankC);
+    auto dimOf = [rankC](const Shape &s, int i) {
+        int j = i - (rankC - (int)s.size());
+        return j < 0 ? 1 : s[j];
+    };
+
+    // Collapse: skip output dims of size 1 and merge neighbours whose
+    // broadcast pattern (which input is expanded) is the same.
+    bool fullA[MaxRank], fullB[MaxRank];
+    rank = 0;
+    size = 1;
+    for (int i = 0; i < rankC; ++i) {
+        if (c[i] == 1)
+            continue;
+        bool inA = dimOf(a, i) == c[i], inB = dimOf(b, i) == c[i];
+        IT_ASSERT((inA || dimOf(a, i) == 1) && (inB || dimOf(b, i) == 1),
+                  "Shapes are not broadcastable");
+        size *= c[i];
+        if (rank > 0 && fullA[rank - 1] == inA && fullB[rank - 1] == inB) {
+            dims[rank - 1] *= c[i];
+            continue;
+        }
+        IT_ASSERT(rank < MaxRank, "Broadcast pattern has too many dims");
+        dims[rank] = c[i];
+        fullA[rank] = inA;
+        fullB[rank] = inB;
+        ++rank;
+    }
+    if (rank == 0) {
+        dims[0] = 1;
+        fullA[0] = fullB[0] = true;
+        rank = 1;
+    }
+
+    size_t pA = 1, pB = 1;
+    for (int d = rank - 1; d >= 0; --d) {
+        strideA[d] = fullA[d] ? pA : 0;
+        strideB[d] = fullB[d] ? pB : 0;
+        pA *= fullA[d] ? dims[d] : 1;
+        pB *= fullB[d] ? dims[d] : 1;
+    }
+
+    // Both inputs cannot be expanded along the same output dim, so the
+    // innermost dim is contiguous in at least one of them.
+    const bool innerA = fullA[rank - 1], innerB = fullB[rank - 1];
+    if (rank == 1)
+        kind = !innerA ? Kind::ScalarA : !innerB ? Kind::ScalarB
+                                                 : Kind::SameShape;
+    else
+        kind = !innerA ? Kind::ColumnA : !innerB ? Kind::ColumnB : Kind::Row;
+}
+
+} // namespace infini
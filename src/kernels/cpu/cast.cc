@@ -0,0 +1,148 @@
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include "operators/unary.h"
+#include <cstring>
+#include <limits>
+
+namespace infini {
+
+class NativeCast : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Elements per parallel chunk: enough work to amortize the scheduling,
+    // small enough that the input and output of a chunk stay in L2.
+    static constexpr size_t chunkSize = 16384;
+
+    // Integer to integer and integer to float follow static_cast, i.e.
+    // narrowing integers wraps around. The loop is left to the compiler's
+    // vectorizer.
+    template <typename From, typename To>
+    static void convertStatic(const From *x, To *y, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            y[i] = static_cast<To>(x[i]);
+    }
+
+    // Float to integer truncates toward zero, saturates values out of range
+    // and maps NaN to 0, like SimdKernels::f32ToI32.
+    template <typename To>
+    static void convertFloatToInt(const float *x, To *y, size_t n) {
+        constexpr float lo = float(std::numeric_limits<To>::min());
+        constexpr float hi = -lo;
+        for (size_t i = 0; i < n; ++i) {
+            float v = x[i];
+            y[i] = v != v    ? To(0)
+                   : v >= hi ? std::numeric_limits<To>::max()
+                   : v < lo  ? std::numeric_limits<To>::min()
+                             : To(v);
+        }
+    }
+
+    static void copyFloat(const float *x, float *y, size_t n) {
+        if (x != y)
+            std::memcpy(y, x, n * sizeof(float));
+    }
+
+    template <typename From, typename To>
+    static void convert(const Ref<CastObj> &op,
+                        void (*fn)(const From *, To *, size_t)) {
+        auto input = op->getInputs(0), output = op->getOutput();
+        IT_ASSERT(input->getDType().getSize() == sizeof(From),
+                  "Cast input has data type " + input->getDType().toString());
+        IT_ASSERT(output->getDType().getSize() == sizeof(To));
+        auto x = input->getRawDataPtr<From *>();
+        auto y = output->getRawDataPtr<To *>();
+        parallelFor(output->size(), chunkSize, [&](size_t begin, size_t end) {
+            fn(x + begin, y + begin, end - begin);
+        });
+    }
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<CastObj>(_op);
+        switch (op->getType()) {
+        case CastType::Float2Float16:
+            convert<float, uint16_t>(op, simd.f32ToF16);
+            break;
+        case CastType::Float2Int64:
+            convert<float, int64_t>(op, convertFloatToInt<int64_t>);
+            break;
+        case CastType::Float2Int32:
+            convert<float, int32_t>(op, simd.f32ToI32);
+            break;
+        case CastType::Float2Int16:
+            convert<float, int16_t>(op, convertFloatToInt<int16_t>);
+            break;
+        case CastType::Float2Int8:
+            convert<float, int8_t>(op, convertFloatToInt<int8_t>);
+            break;
+        case CastType::Float2BFloat16:
+            convert<float, uint16_t>(op, simd.f32ToBf16);
+            break;
+        case CastType::Int322Float:
+            convert<int32_t, float>(op, simd.i32ToF32);
+            break;
+        case CastType::Int322Int8:
+            convert<int32_t, int8_t>(op, convertStatic<int32_t, int8_t>);
+            break;
+        case CastType::Int322Int16:
+            convert<int32_t, int16_t>(op, convertStatic<int32_t, int16_t>);
+            break;
+        case CastType::Int322Int64:
+            convert<int32_t, int64_t>(op, convertStatic<int32_t, int64_t>);
+            break;
+        case CastType::Int162Float:
+            convert<int16_t, float>(op, convertStatic<int16_t, float>);
+            break;
+        case CastType::Int162Int32:
+            convert<int16_t, int32_t>(op, convertStatic<int16_t, int32_t>);
+            break;
+        case CastType::Int82Float:
+            convert<int8_t, float>(op, convertStatic<int8_t, float>);
+            break;
+        case CastType::Int82Int16:
+            convert<int8_t, int16_t>(op, convertStatic<int8_t, int16_t>);
+            break;
+        case CastType::Int82Int32:
+            convert<int8_t, int32_t>(op, convertStatic<int8_t, int32_t>);
+            break;
+        case CastType::Uint82Float:
+            convert<uint8_t, float>(op, convertStatic<uint8_t, float>);
+            break;
+        case CastType::Uint82Int32:
+            convert<uint8_t, int32_t>(op, convertStatic<uint8_t, int32_t>);
+            break;
+        case CastType::Uint82Int64:
+            convert<uint8_t, int64_t>(op, convertStatic<uint8_t, int64_t>);
+            break;
+        case CastType::Int642Int32:
+            convert<int64_t, int32_t>(op, convertStatic<int64_t, int32_t>);
+            break;
+        case CastType::Int642Uint32:
+            convert<int64_t, uint32_t>(op, convertStatic<int64_t, uint32_t>);
+            break;
+        case CastType::Int642Float:
+            convert<int64_t, float>(op, convertStatic<int64_t, float>);
+            break;
+        case CastType::Uint322Int64:
+            convert<uint32_t, int64_t>(op, convertStatic<uint32_t, int64_t>);
+            break;
+        case CastType::Float162Float:
+            convert<uint16_t, float>(op, simd.f16ToF32);
+            break;
+        case CastType::BFloat162Float:
+            convert<uint16_t, float>(op, simd.bf16ToF32);
+            break;
+        case CastType::Float2Float:
+            convert<float, float>(op, copyFloat);
+            break;
+        default:
+            IT_TODO_HALT();
+        }
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::Cast, NativeCast, "CastNative_CPU");
+
+} // namespace infini
@@ -1,64 +1,76 @@
 #include "operators/concat.h"
 #include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <cstring>
 
 namespace infini {
 
-class NaiveConcat : public CpuKernelWithoutConfig {
-    template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
-        auto op = as<ConcatObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
-        auto dim = op->getDim();
-        auto output = outputs[0];
-        std::vector<Shape> iDims;
-        for (auto input : inputs)
-            iDims.emplace_back(input->getDims());
-        const auto &outDim = output->getDims();
-        size_t blockOffsetInner = 1;
-        for (size_t i = outDim.size() - 1; i > (size_t)dim; --i)
-            blockOffsetInner *= outDim[i];
-        size_t blockOffset = outDim[dim] * blockOffsetInner;
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            auto input = inputs[i];
-            auto dimOffset = 0;
-            auto iDim = iDims[i];
-            for (size_t j = 0; j < i; ++j)
-                dimOffset += iDims[j][dim];
-            size_t localBlockOffset = 1;
-            for (size_t i = iDim.size() - 1;
-                 i >= (size_t)dim && i != (size_t)-1; --i)
-                localBlockOffset *= iDim[i];
-            auto innerOffset = blockOffsetInner * dimOffset;
-            auto inSize = input->size();
-            auto inPtr = input->getRawDataPtr<T *>(),
-                 outPtr = output->getRawDataPtr<T *>();
-#pragma omp parallel for
-            for (size_t iOffset = 0; iOffset < inSize; ++iOffset) {
-                auto oOffset = iOffset % localBlockOffset + innerOffset +
-                               iOffset / localBlockOffset * blockOffset;
-                outPtr[oOffset] = inPtr[iOffset];
-            }
-        }
+class NativeConcat : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Outputs below this many bytes are copied by the calling thread.
+    static constexpr size_t parallelThreshold = 1 << 17;
+
+    static void copyBytes(void *dst, const void *src, size_t bytes) {
+        std::memcpy(dst, src, bytes);
     }
 
+    // The output is [outer, concat dim, inner]; input i fills a slab of its
+    // own extent along the concat dim. Each (outer index, input) pair is one
+    // contiguous block, so the whole kernel is a set of independent block
+    // copies of raw bytes, whatever the dtype.
     void compute(const Operator &_op,
                  const RuntimeObj *context) const override {
-#define CASE(N)                                                                \
-    case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
+        auto op = as<ConcatObj>(_op);
+        auto inputs = op->getInputs();
+        auto output = op->getOutput();
+        const auto &outDim = output->getDims();
+        const int dim = op->getDim();
+        const size_t elemSize = output->getDType().getSize();
 
-        int dataTypeIdx = _op->getDType().getIndex();
-        switch (dataTypeIdx) {
-            CASE(1); // DataType::Float32
-            break;
-            CASE(12); // DataType::UInt32
-            break;
-        default:
-            IT_TODO_HALT();
+        size_t outer = 1, inner = elemSize;
+        for (int i = 0; i < dim; ++i)
+            outer *= outDim[i];
+        for (size_t i = dim + 1; i < outDim.size(); ++i)
+            inner *= outDim[i];
+        const size_t outRow = outDim[dim] * inner;
+
+        const size_t n = inputs.size();
+        vector<const char *> srcs(n);
+        vector<size_t> blockBytes(n), dstOffsets(n);
+        for (size_t i = 0, offset = 0; i < n; ++i) {
+            IT_ASSERT(inputs[i]->getDType().getSize() == elemSize);
+            srcs[i] = inputs[i]->getRawDataPtr<char *>();
+            blockBytes[i] = inputs[i]->getDims()[dim] * inner;
+            dstOffsets[i] = offset;
+            offset += blockBytes[i];
         }
+        auto dst = output->getRawDataPtr<char *>();
+
+        // An output larger than the last level cache would only evict the
+        // inputs of the next ops: write it around the cache.
+        const size_t bytes = output->getBytes();
+        auto copy = bytes > CpuFeatures::getInstance().getL3CacheSize()
+                        ? simd.streamCopy
+                        : copyBytes;
+        const size_t blocks = outer * n;
+        parallelFor(blocks, evenGrain(blocks, bytes >= parallelThreshold),
+                    [&](size_t begin, size_t end) {
+                        for (size_t t = begin; t < end; ++t) {
+                            size_t o = t / n, i = t % n;
+                            char *to = dst + o * outRow + dstOffsets[i];
+                            const char *from = srcs[i] + o * blockBytes[i];
+                            // Inputs placed in their slice by
+                            // GraphObj::dataMalloc are already there.
+                            if (to != from)
+                                copy(to, from, blockBytes[i]);
+                        }
+                    });
     }
 };
 
-REGISTER_KERNEL(Device::CPU, OpType::Concat, NaiveConcat, "ConcatNaive_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::Concat, NativeConcat, "ConcatNative_CPU");
 
 } // namespace infini
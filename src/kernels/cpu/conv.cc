@@ -0,0 +1,344 @@
+#include "operators/conv.h"
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/gemm.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <algorithm>
+
+namespace infini {
+
+namespace {
+
+// Floats of scratch (im2col columns, Winograd tiles) one step may use.
+constexpr size_t scratchFloats = size_t(1) << 20;
+
+// Work below which a loop stays on the calling thread.
+constexpr size_t chunkSize = 16384;
+
+struct ConvParams {
+    int n, c, h, w;
+    int f, r, s;
+    int oh, ow;
+    int groups, cpg, fpg;
+    int ph, pw, sh, sw, dh, dw;
+};
+
+ConvParams getParams(const ConvObj &op) {
+    const auto &x = op.getInputs(0)->getDims();
+    const auto &w = op.getInputs(1)->getDims();
+    const auto &y = op.getOutput()->getDims();
+    ConvParams p;
+    p.n = x[0], p.c = x[1], p.h = x[2], p.w = x[3];
+    p.f = w[0], p.r = w[2], p.s = w[3];
+    p.oh = y[2], p.ow = y[3];
+    p.groups = op.getNumGroups();
+    p.cpg = w[1], p.fpg = p.f / p.groups;
+    p.ph = op.getPh(), p.pw = op.getPw();
+    p.sh = op.getSh(), p.sw = op.getSw();
+    p.dh = op.getDh(), p.dw = op.getDw();
+    return p;
+}
+
+// Outputs [begin, end) of a row of `out` whose input position
+// o * stride - pad + offset falls in [0, in).
+void validRange(int out, int in, int pad, int stride, int offset, int &begin,
+                int &end) {
+    const int lo = pad - offset, hi = in - 1 + pad - offset;
+    begin = lo <= 0 ? 0 : (lo + stride - 1) / stride;
+    end = hi < 0 ? 0 : std::min(out, hi / stride + 1);
+    end = std::max(begin, end);
+}
+
+// One input channel per group (depthwise, possibly with a channel
+// multiplier): every output plane is accumulated tap by tap from its input
+// plane, row by row so that the output row stays in L1. No scratch.
+void convDirect(const ConvParams &p, const float *x, const float *w,
+                const float *bias, float *y) {
+    vector<int> colBegin(p.s), colEnd(p.s);
+    for (int j = 0; j < p.s; ++j)
+        validRange(p.ow, p.w, p.pw, p.sw, j * p.dw, colBegin[j], colEnd[j]);
+    const size_t planes = (size_t)p.n * p.f, plane = (size_t)p.oh * p.ow;
+    const size_t grain =
+        evenGrain(planes, planes * plane * p.r * p.s >= 2 * chunkSize);
+    parallelFor(planes, grain, [&](size_t begin, size_t end) {
+        for (size_t nf = begin; nf < end; ++nf) {
+            const int f = nf % p.f;
+            const float *in = x + (nf / p.f * p.c + f / p.fpg) * p.h * p.w;
+            const float *wf = w + (size_t)f * p.r * p.s;
+            float *out = y + nf * plane;
+            std::fill_n(out, plane, bias ? bias[f] : 0.f);
+            for (int oy = 0; oy < p.oh; ++oy) {
+                float *row = out + (size_t)oy * p.ow;
+                for (int i = 0; i < p.r; ++i) {
+                    const int iy = oy * p.sh - p.ph + i * p.dh;
+                    if (iy < 0 || iy >= p.h)
+                        continue;
+                    for (int j = 0; j < p.s; ++j) {
+                        const float wv = wf[i * p.s + j];
+                        const float *src = in + iy * p.w + j * p.dw - p.pw;
+                        if (p.sw == 1) {
+                            for (int ox = colBegin[j]; ox < colEnd[j]; ++ox)
+                                row[ox] += wv * src[ox];
+                        } else {
+                            for (int ox = colBegin[j]; ox < colEnd[j]; ++ox)
+                                row[ox] += wv * src[ox * p.sw];
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+// General convolution: the receptive fields of a block of output rows are
+// unfolded into a [cpg * R * S, rows * OW] matrix that the blocked GEMM
+// multiplies by the group's [fpg, cpg * R * S] weights. Blocking the rows
+// bounds the unfolded copy to scratchFloats.
+void convIm2col(const ConvParams &p, const float *x, const float *w,
+                float *y) {
+    const int k = p.cpg * p.r * p.s;
+    const size_t plane = (size_t)p.oh * p.ow;
+    const int rows = std::clamp<int>(scratchFloats / ((size_t)k * p.ow), 1,
+                                     p.oh);
+    vector<float> col((size_t)k * rows * p.ow);
+    vector<int> colBegin(p.s), colEnd(p.s);
+    for (int j = 0; j < p.s; ++j)
+        validRange(p.ow, p.w, p.pw, p.sw, j * p.dw, colBegin[j], colEnd[j]);
+    for (int n = 0; n < p.n; ++n)
+        for (int g = 0; g < p.groups; ++g) {
+            const float *in = x + ((size_t)n * p.c + g * p.cpg) * p.h * p.w;
+            for (int oy0 = 0; oy0 < p.oh; oy0 += rows) {
+                const int nr = std::min(rows, p.oh - oy0);
+                const int cols = nr * p.ow;
+                const size_t grain =
+                    evenGrain(k, (size_t)k * cols >= 2 * chunkSize);
+                parallelFor(k, grain, [&](size_t begin, size_t end) {
+                    for (int kk = begin; kk < int(end); ++kk) {
+                        const int c = kk / (p.r * p.s), i = kk / p.s % p.r,
+                                  j = kk % p.s;
+                        const float *src = in + (size_t)c * p.h * p.w;
+                        float *dst = col.data() + (size_t)kk * cols;
+                        for (int oy = oy0; oy < oy0 + nr; ++oy, dst += p.ow) {
+                            const int iy = oy * p.sh - p.ph + i * p.dh;
+                            if (iy < 0 || iy >= p.h) {
+                                std::fill_n(dst, p.ow, 0.f);
+                                continue;
+                            }
+                            const float *line =
+                                src + iy * p.w + j * p.dw - p.pw;
+                            std::fill_n(dst, colBegin[j], 0.f);
+                            for (int ox = colBegin[j]; ox < colEnd[j]; ++ox)
+                                dst[ox] = line[ox * p.sw];
+                            std::fill_n(dst + colEnd[j], p.ow - colEnd[j], 0.f);
+                        }
+                    }
+                });
+                float *out = y + ((size_t)n * p.f + g * p.fpg) * plane +
+                             (size_t)oy0 * p.ow;
+                gemm<float>(false, false, p.fpg, cols, k,
+                            w + (size_t)g * p.fpg * k, k, col.data(), cols,
+                            out, plane);
+            }
+        }
+}
+
+// 1x1, stride 1 and no padding: the input planes already are the GEMM's
+// right-hand matrix, so the weights multiply them in place.
+void conv1x1(const ConvParams &p, const float *x, const float *w, float *y) {
+    const int plane = p.oh * p.ow;
+    for (int n = 0; n < p.n; ++n)
+        for (int g = 0; g < p.groups; ++g)
+            gemm<float>(false, false, p.fpg, plane, p.cpg,
+                        w + (size_t)g * p.fpg * p.cpg, p.cpg,
+                        x + ((size_t)n * p.c + g * p.cpg) * plane, plane,
+                        y + ((size_t)n * p.f + g * p.fpg) * plane, plane);
+}
+
+// Winograd F(2x2, 3x3) for 3x3 kernels with stride and dilation 1: each
+// 2x2 output tile is A^T [(G g G^T) . (B^T d B)] A over the 4x4 input tile
+// d, and the elementwise products summed over channels are 16 GEMMs of
+// [fpg, cpg] by [cpg, tiles]. That is 16 multiplications per tile and
+// channel pair instead of 36. Tiles go in blocks that bound the transformed
+// tiles to scratchFloats.
+void convWinograd(const ConvParams &p, const float *x, const float *w,
+                  float *y) {
+    // U[g][k][f][c] = (G g G^T)[k] with k = 4 * row + column.
+    const size_t uSize = (size_t)16 * p.fpg * p.cpg;
+    vector<float> u(uSize * p.groups);
+    const size_t grain =
+        evenGrain(p.f, (size_t)p.f * p.cpg * 16 >= 2 * chunkSize);
+    parallelFor(p.f, grain, [&](size_t begin, size_t end) {
+        for (int f = begin; f < int(end); ++f)
+            for (int c = 0; c < p.cpg; ++c) {
+                const float *g = w + ((size_t)f * p.cpg + c) * 9;
+                float t[4][3];
+                for (int j = 0; j < 3; ++j) {
+                    t[0][j] = g[j];
+                    t[1][j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+                    t[2][j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+                    t[3][j] = g[6 + j];
+                }
+                float *dst = u.data() + f / p.fpg * uSize +
+                             (size_t)(f % p.fpg) * p.cpg + c;
+                const size_t step = (size_t)p.fpg * p.cpg;
+                for (int i = 0; i < 4; ++i) {
+                    dst[(4 * i + 0) * step] = t[i][0];
+                    dst[(4 * i + 1) * step] =
+                        0.5f * (t[i][0] + t[i][1] + t[i][2]);
+                    dst[(4 * i + 2) * step] =
+                        0.5f * (t[i][0] - t[i][1] + t[i][2]);
+                    dst[(4 * i + 3) * step] = t[i][2];
+                }
+            }
+    });
+
+    const int tilesH = (p.oh + 1) / 2, tilesW = (p.ow + 1) / 2;
+    const int tiles = tilesH * tilesW;
+    const int block = std::clamp<int>(
+        scratchFloats / (16 * (size_t)(p.cpg + p.fpg)), 1, tiles);
+    vector<float> v((size_t)16 * p.cpg * block), m((size_t)16 * p.fpg * block);
+    const size_t plane = (size_t)p.oh * p.ow;
+    for (int n = 0; n < p.n; ++n)
+        for (int g = 0; g < p.groups; ++g) {
+            const float *in = x + ((size_t)n * p.c + g * p.cpg) * p.h * p.w;
+            float *out = y + ((size_t)n * p.f + g * p.fpg) * plane;
+            for (int t0 = 0; t0 < tiles; t0 += block) {
+                const int nt = std::min(block, tiles - t0);
+                // V[k][c][t] = (B^T d B)[k]
+                const size_t vTasks = (size_t)p.cpg * nt;
+                parallelFor(vTasks, evenGrain(vTasks, vTasks >= 1024),
+                            [&](size_t begin, size_t end) {
+                    for (size_t task = begin; task < end; ++task) {
+                        const int c = int(task / nt), t = int(task % nt);
+                        const int y0 = (t0 + t) / tilesW * 2 - p.ph;
+                        const int x0 = (t0 + t) % tilesW * 2 - p.pw;
+                        const float *src = in + (size_t)c * p.h * p.w;
+                        float d[4][4];
+                        for (int i = 0; i < 4; ++i)
+                            for (int j = 0; j < 4; ++j) {
+                                const int iy = y0 + i, ix = x0 + j;
+                                d[i][j] = iy >= 0 && iy < p.h && ix >= 0 &&
+                                                  ix < p.w
+                                              ? src[iy * p.w + ix]
+                                              : 0.f;
+                            }
+                        float b[4][4];
+                        for (int j = 0; j < 4; ++j) {
+                            b[0][j] = d[0][j] - d[2][j];
+                            b[1][j] = d[1][j] + d[2][j];
+                            b[2][j] = d[2][j] - d[1][j];
+                            b[3][j] = d[1][j] - d[3][j];
+                        }
+                        float *dst = v.data() + (size_t)c * nt + t;
+                        const size_t step = (size_t)p.cpg * nt;
+                        for (int i = 0; i < 4; ++i) {
+                            dst[(4 * i + 0) * step] = b[i][0] - b[i][2];
+                            dst[(4 * i + 1) * step] = b[i][1] + b[i][2];
+                            dst[(4 * i + 2) * step] = b[i][2] - b[i][1];
+                            dst[(4 * i + 3) * step] = b[i][1] - b[i][3];
+                        }
+                    }
+                });
+                // The 16 products are independent: with enough of them per
+                // thread they run side by side, each GEMM on one thread.
+                const float *ug = u.data() + g * uSize;
+                const size_t vStep = (size_t)p.cpg * nt,
+                             mStep = (size_t)p.fpg * nt;
+                const size_t kGrain = evenGrain(
+                    16, (size_t)p.fpg * p.cpg * nt >= 2 * chunkSize);
+                parallelFor(16, kGrain, [&](size_t begin, size_t end) {
+                    for (int k = begin; k < int(end); ++k)
+                        gemm<float>(false, false, p.fpg, nt, p.cpg,
+                                    ug + k * (size_t)p.fpg * p.cpg, p.cpg,
+                                    v.data() + k * vStep, nt,
+                                    m.data() + k * mStep, nt);
+                });
+                // Y = A^T M A, clipped to the output.
+                const size_t yTasks = (size_t)p.fpg * nt;
+                parallelFor(yTasks, evenGrain(yTasks, yTasks >= 1024),
+                            [&](size_t begin, size_t end) {
+                    for (size_t task = begin; task < end; ++task) {
+                        const int f = int(task / nt), t = int(task % nt);
+                        const float *src = m.data() + (size_t)f * nt + t;
+                        float a[2][4];
+                        for (int j = 0; j < 4; ++j) {
+                            const float m0 = src[j * mStep],
+                                        m1 = src[(4 + j) * mStep],
+                                        m2 = src[(8 + j) * mStep],
+                                        m3 = src[(12 + j) * mStep];
+                            a[0][j] = m0 + m1 + m2;
+                            a[1][j] = m1 - m2 - m3;
+                        }
+                        const int oy = (t0 + t) / tilesW * 2,
+                                  ox = (t0 + t) % tilesW * 2;
+                        float *dst = out + (size_t)f * plane;
+                        for (int i = 0; i < 2 && oy + i < p.oh; ++i) {
+                            float *row = dst + (size_t)(oy + i) * p.ow + ox;
+                            row[0] = a[i][0] + a[i][1] + a[i][2];
+                            if (ox + 1 < p.ow)
+                                row[1] = a[i][1] - a[i][2] - a[i][3];
+                        }
+                    }
+                });
+            }
+        }
+}
+
+} // namespace
+
+/**
+ * Conv2d on Float32 NCHW tensors. The path depends on the shape: a direct
+ * loop for one input channel per group (depthwise), the weights straight on
+ * the input planes for 1x1 kernels, Winograd F(2x2, 3x3) for 3x3 kernels
+ * with stride 1 and enough channels per group to amortize the transforms,
+ * and im2col into the blocked GEMM otherwise.
+ */
+class NativeConv : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Channels per group from which Winograd beats im2col.
+    static constexpr int winogradMinChannels = 16;
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<ConvObj>(_op);
+        if (!(op->getDType() == DataType::Float32))
+            IT_TODO_HALT();
+        const auto p = getParams(*op);
+        const float *x = op->getInputs(0)->getRawDataPtr<float *>();
+        const float *w = op->getInputs(1)->getRawDataPtr<float *>();
+        const float *bias =
+            op->getBias() ? op->getBias()->getRawDataPtr<float *>() : nullptr;
+        float *y = op->getOutput()->getRawDataPtr<float *>();
+
+        if (p.cpg == 1) {
+            convDirect(p, x, w, bias, y);
+            return;
+        }
+        if (p.r == 1 && p.s == 1 && p.sh == 1 && p.sw == 1 && p.ph == 0 &&
+            p.pw == 0)
+            conv1x1(p, x, w, y);
+        else if (p.r == 3 && p.s == 3 && p.sh == 1 && p.sw == 1 &&
+                 p.dh == 1 && p.dw == 1 && p.cpg >= winogradMinChannels &&
+                 p.fpg >= winogradMinChannels)
+            convWinograd(p, x, w, y);
+        else
+            convIm2col(p, x, w, y);
+        if (bias) {
+            const size_t plane = (size_t)p.oh * p.ow;
+            const size_t planes = (size_t)p.n * p.f;
+            const size_t grain =
+                evenGrain(planes, planes * plane >= 2 * chunkSize);
+            parallelFor(planes, grain, [&](size_t begin, size_t end) {
+                for (size_t nf = begin; nf < end; ++nf)
+                    simd.add.vs(y + nf * plane, bias[nf % p.f], y + nf * plane,
+                                plane);
+            });
+        }
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::Conv, NativeConv, "ConvNative_CPU");
+
+} // namespace infini
@@ -1,95 +1,175 @@
 #include "operators/element_wise.h"
 #include "core/kernel.h"
-#include "utils/operator_utils.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/broadcast.h"
+#include "kernels/cpu/simd_kernels.h"
 
 namespace infini
 {
     class NativeElementWise : public CpuKernelWithoutConfig
     {
+        // ISA-specific loops, chosen when the kernel is registered.
+        const SimdKernels &simd = getSimdKernels();
+
+        // Elements per parallel chunk: enough work to amortize the
+        // scheduling, so small tensors stay on the calling thread.
+        static constexpr size_t chunkSize = 16384;
+        // Elements per block of the 16-bit types, converted on the stack.
+        static constexpr size_t blockSize = 1024;
+
         template <typename T>
-        static T addCompute(T val0, T val1)
+        const BinaryKernels<T> &binaryKernels(OpType type) const
         {
-            return val0 + val1;
+            if constexpr (std::is_same_v<T, float>)
+            {
+                switch (type.underlying())
+                {
+                case OpType::Add:
+                    return simd.add;
+                case OpType::Sub:
+                    return simd.sub;
+                case OpType::Mul:
+                    return simd.mul;
+                case OpType::Div:
+                    return simd.div;
+                default:
+                    IT_TODO_HALT();
+                }
+            }
+            else
+            {
+                switch (type.underlying())
+                {
+                case OpType::Add:
+                    return simd.addU32;
+                case OpType::Sub:
+                    return simd.subU32;
+                case OpType::Mul:
+                    return simd.mulU32;
+                case OpType::Div:
+                    return simd.divU32;
+                default:
+                    IT_TODO_HALT();
+                }
+            }
         }
 
+        // Walks the outputs in [begin, end) in runs along the innermost
+        // collapsed dim; each run is one call of a contiguous loop.
         template <typename T>
-        static T subCompute(T val0, T val1)
+        static void doBroadcast(const BroadcastPlan &plan,
+                                const BinaryKernels<T> &kernels, const T *a,
+                                const T *b, T *c, size_t begin, size_t end)
         {
-            return val0 - val1;
+            switch (plan.kind)
+            {
+            case BroadcastPlan::Kind::SameShape:
+            case BroadcastPlan::Kind::Row:
+                plan.forEachRun(begin, end,
+                                [&](size_t oc, size_t oa, size_t ob, size_t len)
+                                { kernels.vv(a + oa, b + ob, c + oc, len); });
+                break;
+            case BroadcastPlan::Kind::ScalarA:
+            case BroadcastPlan::Kind::ColumnA:
+                plan.forEachRun(begin, end,
+                                [&](size_t oc, size_t oa, size_t ob, size_t len)
+                                { kernels.sv(b + ob, a[oa], c + oc, len); });
+                break;
+            case BroadcastPlan::Kind::ScalarB:
+            case BroadcastPlan::Kind::ColumnB:
+                plan.forEachRun(begin, end,
+                                [&](size_t oc, size_t oa, size_t ob, size_t len)
+                                { kernels.vs(a + oa, b[ob], c + oc, len); });
+                break;
+            }
         }
 
+        // What a Float32 or UInt32 call needs, resolved from the op.
         template <typename T>
-        static T mulCompute(T val0, T val1)
+        struct Args
         {
-            return val0 * val1;
+            BroadcastPlan plan;
+            const BinaryKernels<T> *kernels;
+            const T *a, *b;
+            T *c;
+        };
+
+        template <typename T>
+        Args<T> resolve(const Operator &_op) const
+        {
+            auto op = as<ElementWiseObj>(_op);
+            return {BroadcastPlan(op->getInputs(0)->getDims(),
+                                  op->getInputs(1)->getDims(),
+                                  op->getOutput()->getDims()),
+                    &binaryKernels<T>(op->getOpType()),
+                    op->getInputs(0)->getRawDataPtr<T *>(),
+                    op->getInputs(1)->getRawDataPtr<T *>(),
+                    op->getOutput()->getRawDataPtr<T *>()};
         }
 
         template <typename T>
-        static T divCompute(T val0, T val1)
+        static void execute(const Args<T> &args)
         {
-            return (T)(val0 / val1);
+            const auto &plan = args.plan;
+            parallelFor(plan.size, chunkSize, [&](size_t begin, size_t end)
+            {
+                doBroadcast(plan, *args.kernels, args.a, args.b, args.c, begin,
+                            end);
+            });
         }
 
         template <typename T>
         void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            execute(resolve<T>(_op));
+        }
+
+        // Float16 and BFloat16: each block of outputs gathers its inputs
+        // into fp32 buffers, runs the Float32 loop and is rounded back.
+        void doComputeHalf(const Operator &_op) const
         {
             auto op = as<ElementWiseObj>(_op);
-            T *inptr0 = op->getInputs(0)->getRawDataPtr<T *>();
-            T *inptr1 = op->getInputs(1)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            auto half = getHalfConversions(simd, op->getDType());
+            const uint16_t *a = op->getInputs(0)->getRawDataPtr<uint16_t *>();
+            const uint16_t *b = op->getInputs(1)->getRawDataPtr<uint16_t *>();
+            uint16_t *c = op->getOutput()->getRawDataPtr<uint16_t *>();
 
-            auto shapeA = op->getInputs(0)->getDims();
-            auto shapeB = op->getInputs(1)->getDims();
-            auto shapeC = op->getOutput()->getDims();
-            auto rank = op->getOutput()->getRank();
-            Shape a(rank, 1);
-            Shape b(rank, 1);
-            std::copy(shapeA.begin(), shapeA.end(),
-                      a.begin() + (rank - shapeA.size()));
-            std::copy(shapeB.begin(), shapeB.end(),
-                      b.begin() + (rank - shapeB.size()));
-            auto getStride = [&](const Shape &shape)
+            BroadcastPlan plan(op->getInputs(0)->getDims(),
+                               op->getInputs(1)->getDims(),
+                               op->getOutput()->getDims());
+            const auto &kernels = binaryKernels<float>(op->getOpType());
+            const bool contiguousA = plan.strideA[plan.rank - 1] != 0;
+            const bool contiguousB = plan.strideB[plan.rank - 1] != 0;
+            auto load = [&](const uint16_t *x, bool contiguous, float *y,
+                            size_t len)
             {
-                int p = 1;
-                Shape stride(rank);
-                for (auto i = rank; i > 0; --i)
+                if (contiguous)
+                    half.toF32(x, y, len);
+                else
                 {
-                    stride[i - 1] = p;
-                    p = p * shape[i - 1];
+                    half.toF32(x, y, 1);
+                    std::fill_n(y + 1, len - 1, y[0]);
                 }
-                return stride;
             };
-            Shape strideA = getStride(a);
-            Shape strideB = getStride(b);
-
-            auto n = op->getOutput()->size();
-            T (*_doCompute)
-            (T val0, T val1);
-            switch (op->getOpType().underlying())
-            {
-            case OpType::Add:
-                _doCompute = addCompute<T>;
-                break;
-            case OpType::Sub:
-                _doCompute = subCompute<T>;
-                break;
-            case OpType::Mul:
-                _doCompute = mulCompute<T>;
-                break;
-            case OpType::Div:
-                _doCompute = divCompute<T>;
-                break;
-            default:
-                IT_TODO_HALT();
-            }
-
-            for (size_t i = 0; i < n; ++i)
+            parallelFor(plan.size, chunkSize,
+                        [&](size_t chunkBegin, size_t chunkEnd)
             {
-                auto shapeIndexC = locate_index(i, shapeC);
-                auto indexA = delocate_index(shapeIndexC, a, strideA);
-                auto indexB = delocate_index(shapeIndexC, b, strideB);
-                outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
-            }
+                float bufA[blockSize], bufB[blockSize];
+                for (size_t begin = chunkBegin; begin < chunkEnd;
+                     begin += blockSize)
+                {
+                    size_t end = std::min(chunkEnd, begin + blockSize);
+                    plan.forEachRun(
+                        begin, end,
+                        [&](size_t oc, size_t oa, size_t ob, size_t len)
+                        {
+                            load(a + oa, contiguousA, bufA + oc - begin, len);
+                            load(b + ob, contiguousB, bufB + oc - begin, len);
+                        });
+                    kernels.vv(bufA, bufB, bufA, end - begin);
+                    half.fromF32(bufA, c + begin, end - begin);
+                }
+            });
         }
 
         void compute(const Operator &_op,
@@ -106,10 +186,28 @@ namespace infini
                 break;
                 CASE(12); // DataType::UInt32
                 break;
+            case 10: // DataType::Float16
+            case 16: // DataType::BFloat16
+                doComputeHalf(_op);
+                break;
             default:
                 IT_TODO_HALT();
             }
         }
+
+        std::function<void()> prepare(const Operator &_op,
+                                      const RuntimeObj *context) const override
+        {
+            switch (_op->getDType().getIndex())
+            {
+            case 1: // DataType::Float32
+                return [args = resolve<float>(_op)] { execute(args); };
+            case 12: // DataType::UInt32
+                return [args = resolve<uint32_t>(_op)] { execute(args); };
+            default:
+                return Kernel::prepare(_op, context);
+            }
+        }
     };
 
     REGISTER_KERNEL(Device::CPU, OpType::Add, NativeElementWise, "addNaive_CPU");
@@ -0,0 +1,167 @@
+#include "operators/fused_element_wise.h"
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/broadcast.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <cstring>
+
+namespace infini {
+
+class NativeFusedElementWise : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Elements per parallel chunk: enough work to amortize the scheduling,
+    // so small tensors stay on the calling thread.
+    static constexpr size_t chunkSize = 16384;
+    // Elements per block: the registers of a block stay in L1, so every
+    // step after the first reads what the one before has just written.
+    static constexpr size_t blockSize = 512;
+
+    // A step with its SIMD loop looked up once per call.
+    struct Loop {
+        const BinaryKernels<float> *binary = nullptr;
+        UnaryF32Kernel unary = nullptr;
+    };
+
+    Loop lookup(OpType type) const {
+        switch (type.underlying()) {
+        case OpType::Add:
+            return {&simd.add, nullptr};
+        case OpType::Sub:
+            return {&simd.sub, nullptr};
+        case OpType::Mul:
+            return {&simd.mul, nullptr};
+        case OpType::Div:
+            return {&simd.div, nullptr};
+        case OpType::Clip:
+            return {};
+        case OpType::Relu:
+            return {nullptr, simd.relu};
+        case OpType::Exp:
+            return {nullptr, simd.exp};
+        case OpType::Sigmoid:
+            return {nullptr, simd.sigmoid};
+        case OpType::Tanh:
+            return {nullptr, simd.tanh};
+        case OpType::Gelu:
+            return {nullptr, simd.gelu};
+        case OpType::Silu:
+            return {nullptr, simd.silu};
+        case OpType::Erf:
+            return {nullptr, simd.erf};
+        default:
+            IT_TODO_HALT();
+        }
+    }
+
+    // Writes the elements [begin, begin + len) of the output order of a
+    // broadcast input to y.
+    static void gather(const BroadcastPlan &plan, const float *x, float *y,
+                       size_t begin, size_t len) {
+        const bool contiguous = plan.strideA[plan.rank - 1] != 0;
+        plan.forEachRun(begin, begin + len,
+                        [&](size_t oc, size_t oa, size_t, size_t n) {
+                            float *to = y + (oc - begin);
+                            if (contiguous)
+                                std::memcpy(to, x + oa, n * sizeof(float));
+                            else
+                                std::fill_n(to, n, x[oa]);
+                        });
+    }
+
+    // The steps of the op with their loops and the data they read and
+    // write, resolved from the op.
+    struct Args {
+        vector<FusedStep> steps;
+        vector<Loop> loops;
+        size_t numRegs, n;
+        vector<const float *> in;
+        vector<std::optional<BroadcastPlan>> plans;
+        float *out;
+    };
+
+    Args resolve(const Operator &_op) const {
+        auto op = as<FusedElementWiseObj>(_op);
+        auto output = op->getOutput();
+        IT_ASSERT(output->getDType() == DataType::Float32);
+        const int numIn = op->numInputs();
+        Args args{op->getSteps(), {}, size_t(op->getNumRegisters()),
+                  output->size(),
+                  vector<const float *>(numIn),
+                  vector<std::optional<BroadcastPlan>>(numIn),
+                  output->getRawDataPtr<float *>()};
+
+        // Inputs of the output's size are read in place, the others are
+        // expanded block by block into their register.
+        for (int i = 0; i < numIn; ++i) {
+            auto input = op->getInputs(i);
+            IT_ASSERT(input->getDType() == DataType::Float32);
+            args.in[i] = input->getRawDataPtr<float *>();
+            if (input->size() != args.n)
+                args.plans[i].emplace(input->getDims(), input->getDims(),
+                                      output->getDims());
+        }
+        for (const auto &step : args.steps)
+            args.loops.emplace_back(lookup(step.type));
+        return args;
+    }
+
+    void execute(const Args &args) const {
+        const auto &steps = args.steps;
+        const auto &loops = args.loops;
+        const auto &in = args.in;
+        const auto &plans = args.plans;
+        const int numIn = in.size();
+        const size_t numRegs = args.numRegs, n = args.n;
+        float *out = args.out;
+
+        parallelFor(n, chunkSize, [&](size_t chunkBegin, size_t chunkEnd) {
+            vector<float> scratch(numRegs * blockSize);
+            vector<const float *> regs(numRegs);
+            for (size_t begin = chunkBegin; begin < chunkEnd;
+                 begin += blockSize) {
+                const size_t len = std::min(blockSize, chunkEnd - begin);
+                for (int i = 0; i < numIn; ++i) {
+                    if (!plans[i]) {
+                        regs[i] = in[i] + begin;
+                        continue;
+                    }
+                    float *reg = scratch.data() + i * blockSize;
+                    gather(*plans[i], in[i], reg, begin, len);
+                    regs[i] = reg;
+                }
+                for (size_t s = 0; s < steps.size(); ++s) {
+                    const auto &step = steps[s];
+                    float *dst = s + 1 == steps.size()
+                                     ? out + begin
+                                     : scratch.data() + step.out * blockSize;
+                    if (loops[s].binary)
+                        loops[s].binary->vv(regs[step.in0], regs[step.in1],
+                                            dst, len);
+                    else if (loops[s].unary)
+                        loops[s].unary(regs[step.in0], dst, len);
+                    else
+                        simd.clip(regs[step.in0], dst, len, step.min,
+                                  step.max);
+                    regs[step.out] = dst;
+                }
+            }
+        });
+    }
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        execute(resolve(_op));
+    }
+
+    std::function<void()> prepare(const Operator &_op,
+                                  const RuntimeObj *context) const override {
+        return [this, args = resolve(_op)] { execute(args); };
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::FusedElementWise, NativeFusedElementWise,
+                "FusedElementWiseNative_CPU");
+
+} // namespace infini
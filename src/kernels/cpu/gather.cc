@@ -0,0 +1,160 @@
+#include "operators/gather.h"
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <algorithm>
+#include <cstring>
+
+namespace infini {
+
+// Rows this far ahead of the one being copied are prefetched; a lookup's
+// address depends on an index, so the hardware prefetcher cannot guess it.
+static constexpr size_t prefetchDistance = 8;
+// Bytes of a row that are prefetched, sixteen cache lines.
+static constexpr size_t prefetchBytes = 1024;
+
+static void prefetchRow(const char *row, size_t bytes) {
+    bytes = std::min(bytes, prefetchBytes);
+    for (size_t i = 0; i < bytes; i += 64)
+        __builtin_prefetch(row + i);
+}
+
+// The indices as offsets in [0, size), negative ones counting from the back
+// if allowed. They are checked here, before any task runs, so that a bad
+// index fails the call instead of reading out of bounds.
+static vector<size_t> loadIndices(const Tensor &indices, int64_t size,
+                                  bool negative = true) {
+    vector<size_t> ret(indices->size());
+    const int64_t lo = negative ? -size : 0;
+    auto load = [&](const auto *src) {
+        for (size_t i = 0; i < ret.size(); ++i) {
+            int64_t index = src[i];
+            IT_ASSERT(index >= lo && index < size, "Index out of range");
+            ret[i] = index < 0 ? index + size : index;
+        }
+    };
+    if (indices->getDType() == DataType::Int32)
+        load(indices->getRawDataPtr<int32_t *>());
+    else
+        load(indices->getRawDataPtr<int64_t *>());
+    return ret;
+}
+
+/**
+ * Gather over data viewed as [outer, size, inner]: the output is
+ * [outer, indices, inner] and each of its rows of inner elements is one
+ * memcpy of the row the index picks, whatever the dtype. Rows are spread
+ * over threads in contiguous runs, so the rows a thread prefetches are the
+ * ones it copies next.
+ */
+class NativeGather : public CpuKernelWithoutConfig {
+    // Outputs below this many bytes are copied by the calling thread.
+    static constexpr size_t parallelThreshold = 1 << 17;
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<GatherObj>(_op);
+        auto data = op->getInputs(0);
+        const auto &dims = data->getDims();
+        const int axis = op->getAxis();
+        size_t outer = 1, rowBytes = data->getDType().getSize();
+        for (int i = 0; i < axis; ++i)
+            outer *= dims[i];
+        for (size_t i = axis + 1; i < dims.size(); ++i)
+            rowBytes *= dims[i];
+        const auto index = loadIndices(op->getInputs(1), dims[axis]);
+        const size_t m = index.size(), rows = outer * m;
+        const size_t planeBytes = dims[axis] * rowBytes;
+        const char *src = data->getRawDataPtr<char *>();
+        char *dst = op->getOutput()->getRawDataPtr<char *>();
+        auto row = [&](size_t t) {
+            return src + t / m * planeBytes + index[t % m] * rowBytes;
+        };
+
+        const size_t grain =
+            evenGrain(rows, rows * rowBytes >= parallelThreshold);
+        parallelFor(rows, grain, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                if (t + prefetchDistance < rows)
+                    prefetchRow(row(t + prefetchDistance), rowBytes);
+                std::memcpy(dst + t * rowBytes, row(t), rowBytes);
+            }
+        });
+    }
+};
+
+/**
+ * EmbeddingBag, one bag per task: the bag's output row is the accumulator
+ * and every gathered row is folded into it straight from the table, with
+ * the rows a few indices ahead prefetched.
+ */
+class NativeEmbeddingBag : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Work below which a call stays on the calling thread.
+    static constexpr size_t chunkSize = 16384;
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        using Mode = EmbeddingBagObj::Mode;
+        auto op = as<EmbeddingBagObj>(_op);
+        const auto &weightDims = op->getInputs(0)->getDims();
+        const size_t dim = weightDims[1];
+        const auto index = loadIndices(op->getInputs(1), weightDims[0]);
+        const size_t n = index.size();
+        // Bag b is index[begin[b], begin[b + 1]).
+        vector<size_t> begin;
+        if (auto offsets = op->getOffsets()) {
+            begin = loadIndices(offsets, n + 1, false);
+            IT_ASSERT(begin.empty() || begin[0] == 0,
+                      "The first offset must be 0");
+            for (size_t b = 1; b < begin.size(); ++b)
+                IT_ASSERT(begin[b - 1] <= begin[b],
+                          "Offsets must not decrease");
+        } else {
+            const auto &dims = op->getInputs(1)->getDims();
+            for (int b = 0; b < dims[0]; ++b)
+                begin.emplace_back((size_t)b * dims[1]);
+        }
+        begin.emplace_back(n);
+        const size_t bags = begin.size() - 1;
+
+        const float *weight = op->getInputs(0)->getRawDataPtr<float *>();
+        float *y = op->getOutput()->getRawDataPtr<float *>();
+        const Mode mode = op->getMode();
+        const auto &fold = mode == Mode::Max ? simd.reduceMax : simd.reduceSum;
+
+        const size_t grain = evenGrain(bags, n * dim >= 2 * chunkSize);
+        parallelFor(bags, grain, [&](size_t b0, size_t b1) {
+            for (size_t b = b0; b < b1; ++b) {
+                float *acc = y + b * dim;
+                const size_t first = begin[b], last = begin[b + 1];
+                if (first == last) {
+                    std::fill_n(acc, dim, 0.f);
+                    continue;
+                }
+                for (size_t i = first; i < last; ++i) {
+                    if (i + prefetchDistance < n)
+                        prefetchRow(reinterpret_cast<const char *>(
+                                        weight +
+                                        index[i + prefetchDistance] * dim),
+                                    dim * sizeof(float));
+                    const float *row = weight + index[i] * dim;
+                    if (i == first)
+                        std::memcpy(acc, row, dim * sizeof(float));
+                    else
+                        fold.accumulate(acc, row, dim);
+                }
+                if (mode == Mode::Mean)
+                    simd.mul.vs(acc, 1.f / float(last - first), acc, dim);
+            }
+        });
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::Gather, NativeGather, "GatherNative_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::EmbeddingBag, NativeEmbeddingBag,
+                "EmbeddingBagNative_CPU");
+
+} // namespace infini
@@ -0,0 +1,506 @@
+#include "kernels/cpu/gemm.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace infini {
+
+namespace {
+
+template <typename T> struct AlignedFree {
+    void operator()(T *p) const { std::free(p); }
+};
+template <typename T> using AlignedBuffer = std::unique_ptr<T, AlignedFree<T>>;
+
+// 64-byte alignment keeps every packed panel on a cache line boundary, which
+// is also what the widest vector loads want.
+template <typename T> AlignedBuffer<T> allocAligned(size_t count) {
+    constexpr size_t alignment = 64;
+    size_t bytes = (count * sizeof(T) + alignment - 1) / alignment * alignment;
+    return AlignedBuffer<T>(
+        static_cast<T *>(std::aligned_alloc(alignment, std::max(bytes, alignment))));
+}
+
+inline int roundUp(int x, int r) { return (x + r - 1) / r * r; }
+inline int ceilDiv(int x, int r) { return (x + r - 1) / r; }
+
+// Reads `n` contiguous values of A or B as the compute type.
+template <typename S, typename T>
+using LoadValues = void (*)(const S *src, T *dst, size_t n);
+
+template <typename T> void copyValues(const T *src, T *dst, size_t n) {
+    std::memcpy(dst, src, n * sizeof(T));
+}
+
+// Longest contiguous run that packing converts at once: a row of a k block.
+constexpr int MaxKc = 512;
+
+// Packs the `mb` x `kb` block of op(A) into row panels of height `mr`. Each
+// panel is stored column by column so that the micro-kernel reads `mr`
+// consecutive values per k step. Rows past `mb` are zero padded.
+template <typename S, typename T>
+void packA(bool transA, const S *A, int lda, int mb, int kb, int mr, T *dst,
+           LoadValues<S, T> load) {
+    for (int ir = 0; ir < mb; ir += mr, dst += (size_t)mr * kb) {
+        int rows = std::min(mr, mb - ir);
+        if (transA) {
+            for (int p = 0; p < kb; ++p) {
+                T *d = dst + (size_t)p * mr;
+                load(A + (size_t)p * lda + ir, d, rows);
+                for (int i = rows; i < mr; ++i)
+                    d[i] = T(0);
+            }
+        } else {
+            for (int i = 0; i < rows; ++i) {
+                const S *src = A + (size_t)(ir + i) * lda;
+                if constexpr (std::is_same_v<S, T>) {
+                    for (int p = 0; p < kb; ++p)
+                        dst[(size_t)p * mr + i] = src[p];
+                } else {
+                    T row[MaxKc];
+                    load(src, row, kb);
+                    for (int p = 0; p < kb; ++p)
+                        dst[(size_t)p * mr + i] = row[p];
+                }
+            }
+            for (int i = rows; i < mr; ++i)
+                for (int p = 0; p < kb; ++p)
+                    dst[(size_t)p * mr + i] = T(0);
+        }
+    }
+}
+
+// Packs one `kb` x `nr` column panel of op(B), row by row. Columns past `cols`
+// are zero padded.
+template <typename S, typename T>
+void packBPanel(bool transB, const S *B, int ldb, int kb, int cols, int nr,
+                T *dst, LoadValues<S, T> load) {
+    if (transB) {
+        for (int j = 0; j < cols; ++j) {
+            const S *src = B + (size_t)j * ldb;
+            if constexpr (std::is_same_v<S, T>) {
+                for (int p = 0; p < kb; ++p)
+                    dst[(size_t)p * nr + j] = src[p];
+            } else {
+                T row[MaxKc];
+                load(src, row, kb);
+                for (int p = 0; p < kb; ++p)
+                    dst[(size_t)p * nr + j] = row[p];
+            }
+        }
+        for (int p = 0; p < kb; ++p)
+            for (int j = cols; j < nr; ++j)
+                dst[(size_t)p * nr + j] = T(0);
+    } else {
+        for (int p = 0; p < kb; ++p) {
+            T *d = dst + (size_t)p * nr;
+            load(B + (size_t)p * ldb, d, cols);
+            for (int j = cols; j < nr; ++j)
+                d[j] = T(0);
+        }
+    }
+}
+
+// Applies `ep` to the `rows` x `cols` tile of C at (row, col), stored at `c`.
+template <typename T>
+void applyEpilogue(const GemmEpilogue<T> &ep, T *c, int ldc, int row, int col,
+                   int rows, int cols) {
+    const SimdKernels &simd = getSimdKernels();
+    for (int i = 0; i < rows; ++i) {
+        T *ci = c + (size_t)i * ldc;
+        if (ep.bias)
+            for (int j = 0; j < cols; ++j)
+                ci[j] += ep.bias[col + j];
+        if (ep.residual) {
+            const T *r = ep.residual + (size_t)(row + i) * ep.ldr + col;
+            for (int j = 0; j < cols; ++j)
+                ci[j] += r[j];
+        }
+        if constexpr (std::is_same_v<T, float>) {
+            switch (ep.act.underlying()) {
+            case OpType::Unknown:
+                break;
+            case OpType::Relu:
+                simd.relu(ci, ci, cols);
+                break;
+            case OpType::Clip:
+                simd.clip(ci, ci, cols, ep.min, ep.max);
+                break;
+            case OpType::Gelu:
+                simd.gelu(ci, ci, cols);
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        } else {
+            // Relu does nothing to unsigned values.
+            IT_ASSERT(ep.act == OpType::Unknown || ep.act == OpType::Relu);
+        }
+    }
+}
+
+template <typename T> GemmBlocking computeBlocking(int mr, int nr) {
+    const auto &cpu = CpuFeatures::getInstance();
+    size_t l1 = cpu.getL1CacheSize(), l2 = cpu.getL2CacheSize(),
+           l3 = cpu.getL3CacheSize();
+    // Slivers of A and B for one micro-kernel call use about 3/4 of L1 so
+    // that the C tile and the prefetched next sliver still fit.
+    int kc = int(l1 * 3 / 4 / ((mr + nr) * sizeof(T))) / 8 * 8;
+    kc = std::clamp(kc, 64, MaxKc);
+    // The packed A block takes half of L2, the packed B panel half of L3.
+    int mc = int(l2 / 2 / (kc * sizeof(T))) / mr * mr;
+    mc = std::clamp(mc, mr, 1024 / mr * mr);
+    int nc = int(l3 / 2 / (kc * sizeof(T))) / nr * nr;
+    nc = std::clamp(nc, nr, 8192 / nr * nr);
+    return {mc, kc, nc};
+}
+
+} // namespace
+
+template <>
+const GemmMicroKernelDesc<float> &getGemmMicroKernel<float>() {
+    return getSimdKernels().sgemm;
+}
+
+template <>
+const GemmMicroKernelDesc<uint32_t> &getGemmMicroKernel<uint32_t>() {
+    static const GemmMicroKernelDesc<uint32_t> desc{
+        4, 8, gemmMicroKernelScalar<uint32_t, 4, 8>};
+    return desc;
+}
+
+template <typename T> const GemmBlocking &getGemmBlocking() {
+    static const GemmBlocking blocking = computeBlocking<T>(
+        getGemmMicroKernel<T>().mr, getGemmMicroKernel<T>().nr);
+    return blocking;
+}
+
+namespace {
+
+// The blocked product behind gemm and gemmHalf: A and B are stored as S and
+// read through `load` while they are packed, everything else is in T.
+template <typename S, typename T>
+void gemmDriver(bool transA, bool transB, int m, int n, int k, const S *A,
+                int lda, const S *B, int ldb, T *C, int ldc,
+                const GemmEpilogue<T> *epilogue, LoadValues<S, T> load) {
+    if (m <= 0 || n <= 0)
+        return;
+    if (k <= 0) {
+        for (int i = 0; i < m; ++i)
+            std::fill_n(C + (size_t)i * ldc, n, T(0));
+        if (epilogue)
+            applyEpilogue(*epilogue, C, ldc, 0, 0, m, n);
+        return;
+    }
+
+    const auto &ukernel = getGemmMicroKernel<T>();
+    const auto &blocking = getGemmBlocking<T>();
+    const int mr = ukernel.mr, nr = ukernel.nr;
+    const int kc = std::min(blocking.kc, k);
+    const int nc = std::min(blocking.nc, roundUp(n, nr));
+    const int mc = std::min(blocking.mc, roundUp(m, mr));
+    const int nIc = ceilDiv(m, mc);
+    const bool parallel = (double)m * n * k >= 32.0 * 32 * 32;
+    const int threads = parallel ? parallelThreads() : 1;
+
+    auto packedB = allocAligned<T>((size_t)kc * nc);
+    T *pB = packedB.get();
+
+    for (int jc = 0; jc < n; jc += nc) {
+        const int nb = std::min(nc, n - jc);
+        const int nPanels = ceilDiv(nb, nr);
+        // When there are fewer A blocks than threads, the B panels are split
+        // into groups as well so that skinny products still use every core.
+        int panelsPerGroup = ceilDiv(nPanels, std::min(
+                                                  nPanels, ceilDiv(threads, nIc)));
+        const int nGroups = ceilDiv(nPanels, panelsPerGroup);
+
+        for (int pc = 0; pc < k; pc += kc) {
+            const int kb = std::min(kc, k - pc);
+            const bool accumulate = pc > 0;
+            const GemmEpilogue<T> *ep = pc + kb == k ? epilogue : nullptr;
+
+            const size_t panelGrain = evenGrain(nPanels, parallel);
+            parallelFor(nPanels, panelGrain, [&](size_t begin, size_t end) {
+                for (int jp = begin; jp < int(end); ++jp) {
+                    int j = jc + jp * nr;
+                    const S *src = transB ? B + (size_t)j * ldb + pc
+                                          : B + (size_t)pc * ldb + j;
+                    packBPanel(transB, src, ldb, kb, std::min(nr, n - j), nr,
+                               pB + (size_t)jp * kb * nr, load);
+                }
+            });
+
+            // (ib, g) pairs in row-major order, dealt evenly as by a static
+            // schedule; a chunk packs each A block once.
+            const size_t blocks = (size_t)nIc * nGroups;
+            const size_t grain = evenGrain(blocks, parallel);
+            parallelFor(blocks, grain, [&](size_t begin, size_t end) {
+                auto packedA = allocAligned<T>((size_t)mc * kb);
+                auto tile = allocAligned<T>((size_t)mr * nr);
+                int packedIb = -1;
+                for (size_t task = begin; task < end; ++task) {
+                    const int ib = int(task / nGroups);
+                    const int g = int(task % nGroups);
+                    const int ic = ib * mc;
+                    const int mb = std::min(mc, m - ic);
+                    if (packedIb != ib) {
+                        const S *src = transA ? A + (size_t)pc * lda + ic
+                                              : A + (size_t)ic * lda + pc;
+                        packA(transA, src, lda, mb, kb, mr, packedA.get(),
+                              load);
+                        packedIb = ib;
+                    }
+                    const int jpEnd =
+                        std::min(nPanels, (g + 1) * panelsPerGroup);
+                    for (int jp = g * panelsPerGroup; jp < jpEnd; ++jp) {
+                        const int j = jc + jp * nr;
+                        const int cols = std::min(nr, n - j);
+                        const T *b = pB + (size_t)jp * kb * nr;
+                        for (int ir = 0; ir < mb; ir += mr) {
+                            const int rows = std::min(mr, mb - ir);
+                            const T *a = packedA.get() + (size_t)ir * kb;
+                            T *c = C + (size_t)(ic + ir) * ldc + j;
+                            if (rows == mr && cols == nr) {
+                                ukernel.kernel(kb, a, b, c, ldc,
+                                               accumulate);
+                            } else {
+                                // Edge tile: compute into a scratch
+                                // tile and copy back the valid part.
+                                T *t = tile.get();
+                                ukernel.kernel(kb, a, b, t, nr, false);
+                                for (int i = 0; i < rows; ++i)
+                                    for (int jj = 0; jj < cols; ++jj)
+                                        c[(size_t)i * ldc + jj] =
+                                            accumulate
+                                                ? c[(size_t)i * ldc + jj] +
+                                                      t[i * nr + jj]
+                                                : t[i * nr + jj];
+                            }
+                            if (ep)
+                                applyEpilogue(*ep, c, ldc, ic + ir, j,
+                                              rows, cols);
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+void gemm(bool transA, bool transB, int m, int n, int k, const T *A, int lda,
+          const T *B, int ldb, T *C, int ldc,
+          const GemmEpilogue<T> *epilogue) {
+    gemmDriver<T, T>(transA, transB, m, n, k, A, lda, B, ldb, C, ldc, epilogue,
+                     copyValues<T>);
+}
+
+void gemmHalf(bool transA, bool transB, int m, int n, int k,
+              const uint16_t *A, int lda, const uint16_t *B, int ldb,
+              uint16_t *C, int ldc,
+              void (*toF32)(const uint16_t *, float *, size_t),
+              void (*fromF32)(const float *, uint16_t *, size_t)) {
+    if (m <= 0 || n <= 0)
+        return;
+    auto acc = allocAligned<float>((size_t)m * n);
+    gemmDriver<uint16_t, float>(transA, transB, m, n, k, A, lda, B, ldb,
+                                acc.get(), n, nullptr, toF32);
+    const size_t grain = evenGrain(m, (double)m * n >= 65536);
+    parallelFor(m, grain, [&](size_t begin, size_t end) {
+        for (int i = begin; i < int(end); ++i)
+            fromF32(acc.get() + (size_t)i * n, C + (size_t)i * ldc, n);
+    });
+}
+
+namespace {
+
+// Packs the `mb` x `kb` block of op(A) into row panels of height `mr` for the
+// int8 micro-kernel: per group of 4 k values, 4 bytes of each row. Bytes are
+// XORed with `flip` (0x80 turns int8 into int8 + 128 as uint8). Rows past
+// `mb` and k values past `kb` are zero padded.
+void packAU8(bool transA, const uint8_t *A, int lda, int mb, int kb, int mr,
+             uint8_t flip, uint8_t *dst) {
+    const int kq = ceilDiv(kb, 4);
+    for (int ir = 0; ir < mb; ir += mr, dst += (size_t)4 * mr * kq) {
+        const int rows = std::min(mr, mb - ir);
+        std::memset(dst, 0, (size_t)4 * mr * kq);
+        for (int i = 0; i < rows; ++i) {
+            for (int p = 0; p < kb; ++p) {
+                const uint8_t v = transA ? A[(size_t)p * lda + ir + i]
+                                         : A[(size_t)(ir + i) * lda + p];
+                dst[(size_t)(p / 4) * 4 * mr + 4 * i + p % 4] = v ^ flip;
+            }
+        }
+    }
+}
+
+// Packs one `kb` x `nr` column panel of op(B) for the int8 micro-kernel: per
+// group of 4 k values, 4 bytes of each column, zero padded like packAU8.
+// Adds the sum of each column to `colSum` when it is given.
+void packBPanelS8(bool transB, const int8_t *B, int ldb, int kb, int cols,
+                  int nr, int8_t *dst, int32_t *colSum) {
+    const int kq = ceilDiv(kb, 4);
+    std::memset(dst, 0, (size_t)4 * nr * kq);
+    for (int j = 0; j < cols; ++j) {
+        int32_t sum = 0;
+        for (int p = 0; p < kb; ++p) {
+            const int8_t v =
+                transB ? B[(size_t)j * ldb + p] : B[(size_t)p * ldb + j];
+            dst[(size_t)(p / 4) * 4 * nr + 4 * j + p % 4] = v;
+            sum += v;
+        }
+        if (colSum)
+            colSum[j] += sum;
+    }
+}
+
+// The blocked int8 product behind gemmS8 and gemmU8S8, with the loop
+// structure of gemmDriver. A is read as bytes XORed with `flip`.
+void gemmU8S8Driver(bool transA, bool transB, int m, int n, int k,
+                    const uint8_t *A, int lda, uint8_t flip, const int8_t *B,
+                    int ldb, int32_t *C, int ldc) {
+    if (m <= 0 || n <= 0)
+        return;
+    if (k <= 0) {
+        for (int i = 0; i < m; ++i)
+            std::fill_n(C + (size_t)i * ldc, n, 0);
+        return;
+    }
+
+    const auto &ukernel = getSimdKernels().u8s8gemm;
+    static const GemmBlocking blocking =
+        computeBlocking<int8_t>(ukernel.mr, ukernel.nr);
+    const int mr = ukernel.mr, nr = ukernel.nr;
+    const int kc = std::min(blocking.kc, k);
+    const int kqMax = ceilDiv(kc, 4);
+    const int nc = std::min(blocking.nc, roundUp(n, nr));
+    const int mc = std::min(blocking.mc, roundUp(m, mr));
+    const int nIc = ceilDiv(m, mc);
+    const bool parallel = (double)m * n * k >= 64.0 * 64 * 64;
+    const int threads = parallel ? parallelThreads() : 1;
+
+    auto packedB = allocAligned<int8_t>((size_t)4 * kqMax * nc);
+    int8_t *pB = packedB.get();
+    // A shifted by +128 adds 128 * sum_k B[k][j] to every C[i][j].
+    AlignedBuffer<int32_t> colSum;
+    if (flip) {
+        colSum = allocAligned<int32_t>(n);
+        std::fill_n(colSum.get(), n, 0);
+    }
+
+    for (int jc = 0; jc < n; jc += nc) {
+        const int nb = std::min(nc, n - jc);
+        const int nPanels = ceilDiv(nb, nr);
+        int panelsPerGroup = ceilDiv(nPanels, std::min(
+                                                  nPanels, ceilDiv(threads, nIc)));
+        const int nGroups = ceilDiv(nPanels, panelsPerGroup);
+
+        for (int pc = 0; pc < k; pc += kc) {
+            const int kb = std::min(kc, k - pc);
+            const int kq = ceilDiv(kb, 4);
+            const bool accumulate = pc > 0;
+            const bool last = pc + kb == k;
+
+            const size_t panelGrain = evenGrain(nPanels, parallel);
+            parallelFor(nPanels, panelGrain, [&](size_t begin, size_t end) {
+                for (int jp = begin; jp < int(end); ++jp) {
+                    int j = jc + jp * nr;
+                    const int8_t *src = transB ? B + (size_t)j * ldb + pc
+                                               : B + (size_t)pc * ldb + j;
+                    packBPanelS8(transB, src, ldb, kb, std::min(nr, n - j), nr,
+                                 pB + (size_t)jp * 4 * kq * nr,
+                                 flip ? colSum.get() + j : nullptr);
+                }
+            });
+
+            // (ib, g) pairs in row-major order, dealt evenly as by a static
+            // schedule; a chunk packs each A block once.
+            const size_t blocks = (size_t)nIc * nGroups;
+            const size_t grain = evenGrain(blocks, parallel);
+            parallelFor(blocks, grain, [&](size_t begin, size_t end) {
+                auto packedA = allocAligned<uint8_t>((size_t)4 * mc * kq);
+                auto tile = allocAligned<int32_t>((size_t)mr * nr);
+                int packedIb = -1;
+                for (size_t task = begin; task < end; ++task) {
+                    const int ib = int(task / nGroups);
+                    const int g = int(task % nGroups);
+                    const int ic = ib * mc;
+                    const int mb = std::min(mc, m - ic);
+                    if (packedIb != ib) {
+                        const uint8_t *src =
+                            transA ? A + (size_t)pc * lda + ic
+                                   : A + (size_t)ic * lda + pc;
+                        packAU8(transA, src, lda, mb, kb, mr, flip,
+                                packedA.get());
+                        packedIb = ib;
+                    }
+                    const int jpEnd =
+                        std::min(nPanels, (g + 1) * panelsPerGroup);
+                    for (int jp = g * panelsPerGroup; jp < jpEnd; ++jp) {
+                        const int j = jc + jp * nr;
+                        const int cols = std::min(nr, n - j);
+                        const int8_t *b = pB + (size_t)jp * 4 * kq * nr;
+                        for (int ir = 0; ir < mb; ir += mr) {
+                            const int rows = std::min(mr, mb - ir);
+                            const uint8_t *a =
+                                packedA.get() + (size_t)ir * 4 * kq;
+                            int32_t *c = C + (size_t)(ic + ir) * ldc + j;
+                            if (rows == mr && cols == nr) {
+                                ukernel.kernel(kq, a, b, c, ldc,
+                                               accumulate);
+                            } else {
+                                int32_t *t = tile.get();
+                                ukernel.kernel(kq, a, b, t, nr, false);
+                                for (int i = 0; i < rows; ++i)
+                                    for (int jj = 0; jj < cols; ++jj)
+                                        c[(size_t)i * ldc + jj] =
+                                            accumulate
+                                                ? c[(size_t)i * ldc + jj] +
+                                                      t[i * nr + jj]
+                                                : t[i * nr + jj];
+                            }
+                            if (last && flip)
+                                for (int i = 0; i < rows; ++i)
+                                    for (int jj = 0; jj < cols; ++jj)
+                                        c[(size_t)i * ldc + jj] -=
+                                            128 * colSum.get()[j + jj];
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+} // namespace
+
+void gemmS8(bool transA, bool transB, int m, int n, int k, const int8_t *A,
+            int lda, const int8_t *B, int ldb, int32_t *C, int ldc) {
+    gemmU8S8Driver(transA, transB, m, n, k,
+                   reinterpret_cast<const uint8_t *>(A), lda, 0x80, B, ldb, C,
+                   ldc);
+}
+
+void gemmU8S8(bool transA, bool transB, int m, int n, int k,
+              const uint8_t *A, int lda, const int8_t *B, int ldb, int32_t *C,
+              int ldc) {
+    gemmU8S8Driver(transA, transB, m, n, k, A, lda, 0, B, ldb, C, ldc);
+}
+
+template const GemmBlocking &getGemmBlocking<float>();
+template const GemmBlocking &getGemmBlocking<uint32_t>();
+template void gemm<float>(bool, bool, int, int, int, const float *, int,
+                          const float *, int, float *, int,
+                          const GemmEpilogue<float> *);
+template void gemm<uint32_t>(bool, bool, int, int, int, const uint32_t *, int,
+                             const uint32_t *, int, uint32_t *, int,
+                             const GemmEpilogue<uint32_t> *);
+
+} // namespace infini
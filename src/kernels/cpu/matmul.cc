@@ -0,0 +1,229 @@
+#include "operators/matmul.h"
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/gemm.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <climits>
+
+namespace infini {
+
+class NativeMatmul : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Float16 and BFloat16 are stored as T = uint16_t and computed in fp32,
+    // with the conversions in `half`. Int8 and UInt8 A with Int8 B
+    // accumulate into TC = int32_t.
+    template <typename T, typename TB, typename TC>
+    static void runGemm(bool transA, bool transB, int m, int n, int k,
+                        const T *A, int lda, const TB *B, int ldb, TC *C,
+                        int ldc, const GemmEpilogue<TC> *epilogue,
+                        const HalfConversions &half) {
+        if constexpr (std::is_same_v<T, uint16_t>) {
+            IT_ASSERT(!epilogue, "Matmul epilogues need Float32");
+            gemmHalf(transA, transB, m, n, k, A, lda, B, ldb, C, ldc,
+                     half.toF32, half.fromF32);
+        } else if constexpr (std::is_same_v<TC, int32_t>) {
+            IT_ASSERT(!epilogue, "Matmul epilogues need Float32");
+            if constexpr (std::is_same_v<T, int8_t>)
+                gemmS8(transA, transB, m, n, k, A, lda, B, ldb, C, ldc);
+            else
+                gemmU8S8(transA, transB, m, n, k, A, lda, B, ldb, C, ldc);
+        } else {
+            gemm<T>(transA, transB, m, n, k, A, lda, B, ldb, C, ldc,
+                    epilogue);
+        }
+    }
+
+    // Sizes, strides and pointers of a call, resolved from the op.
+    template <typename T, typename TB, typename TC> struct Args {
+        bool transA, transB;
+        int m, n, k, lda, ldb, ldc;
+        size_t matA, matB, matC;
+        T *ptrA;
+        TB *ptrB;
+        TC *ptrC;
+        GemmEpilogue<TC> epilogue;
+        bool fused;
+        HalfConversions half;
+        // Batch dims of C as computed by infer_broadcast, and the matching
+        // strides (in matrices) of A and B; broadcast dims get stride 0.
+        Shape batchC;
+        vector<size_t> strideA, strideB;
+        size_t batch, batchB;
+    };
+
+    template <typename T, typename TB, typename TC>
+    Args<T, TB, TC> resolve(const Operator &_op) const {
+        auto op = as<MatmulObj>(_op);
+        const auto &shapeA = op->getInputs(0)->getDims();
+        const auto &shapeB = op->getInputs(1)->getDims();
+        const auto &shapeC = op->getOutput()->getDims();
+        Args<T, TB, TC> args{};
+        args.transA = op->getTransA();
+        args.transB = op->getTransB();
+        const int rankA = shapeA.size(), rankB = shapeB.size(),
+                  rankC = shapeC.size();
+
+        const int m = shapeC[rankC - 2], n = shapeC[rankC - 1];
+        args.m = m;
+        args.n = n;
+        args.k = args.transA ? shapeA[rankA - 2] : shapeA[rankA - 1];
+        args.lda = shapeA[rankA - 1];
+        args.ldb = shapeB[rankB - 1];
+        args.ldc = n;
+        args.matA = (size_t)shapeA[rankA - 2] * shapeA[rankA - 1];
+        args.matB = (size_t)shapeB[rankB - 2] * shapeB[rankB - 1];
+        args.matC = (size_t)m * n;
+
+        args.ptrA = op->getInputs(0)->getRawDataPtr<T *>();
+        args.ptrB = op->getInputs(1)->getRawDataPtr<TB *>();
+        args.ptrC = op->getOutput()->getRawDataPtr<TC *>();
+
+        // The residual has C's shape, so it follows C batch by batch.
+        auto &epilogue = args.epilogue;
+        if (auto bias = op->getBias())
+            epilogue.bias = bias->getRawDataPtr<TC *>();
+        if (auto residual = op->getResidual()) {
+            epilogue.residual = residual->getRawDataPtr<TC *>();
+            epilogue.ldr = n;
+        }
+        epilogue.act = op->getActivation();
+        epilogue.min = op->getClipMin();
+        epilogue.max = op->getClipMax();
+        args.fused = epilogue.bias || epilogue.residual ||
+                     epilogue.act != OpType::Unknown;
+        if constexpr (std::is_same_v<T, uint16_t>)
+            args.half = getHalfConversions(simd, op->getDType());
+
+        const int batchRank = rankC - 2;
+        args.batchC = Shape(shapeC.begin(), shapeC.end() - 2);
+        args.strideA.assign(batchRank, 0);
+        args.strideB.assign(batchRank, 0);
+        size_t accA = 1, accB = 1;
+        args.batch = args.batchB = 1;
+        for (int i = batchRank - 1; i >= 0; --i) {
+            int iA = i - (batchRank - (rankA - 2));
+            int iB = i - (batchRank - (rankB - 2));
+            int dimA = iA >= 0 ? shapeA[iA] : 1;
+            int dimB = iB >= 0 ? shapeB[iB] : 1;
+            args.strideA[i] = dimA == 1 ? 0 : accA;
+            args.strideB[i] = dimB == 1 ? 0 : accB;
+            accA *= dimA;
+            accB *= dimB;
+            args.batch *= args.batchC[i];
+            args.batchB *= dimB;
+        }
+        return args;
+    }
+
+    template <typename T, typename TB, typename TC>
+    static void execute(const Args<T, TB, TC> &args) {
+        const bool transA = args.transA, transB = args.transB;
+        const int m = args.m, n = args.n, k = args.k, lda = args.lda,
+                  ldb = args.ldb, ldc = args.ldc;
+        const size_t batch = args.batch, matC = args.matC;
+        const auto &epilogue = args.epilogue;
+        const bool fused = args.fused;
+
+        // A single B shared by every batch (the usual activations x weights
+        // case): stack the batches of A into one tall matrix, as long as its
+        // row count fits the int of the GEMM.
+        if (!transA && args.batchB == 1 && (size_t)m * batch <= INT_MAX) {
+            runGemm<T, TB, TC>(transA, transB, int(m * batch), n, k,
+                               args.ptrA, lda, args.ptrB, ldb, args.ptrC, ldc,
+                               fused ? &epilogue : nullptr, args.half);
+            return;
+        }
+
+        auto offsets = [&](size_t b) {
+            size_t offA = 0, offB = 0;
+            for (int i = int(args.batchC.size()) - 1; i >= 0; --i) {
+                size_t idx = b % args.batchC[i];
+                b /= args.batchC[i];
+                offA += idx * args.strideA[i];
+                offB += idx * args.strideB[i];
+            }
+            return std::make_pair(offA * args.matA, offB * args.matB);
+        };
+
+        // Many small matrices: one whole gemm per thread rather than
+        // splitting each small gemm across threads.
+        const int threads = parallelThreads();
+        const bool batchParallel = batch >= (size_t)threads &&
+                                   (double)m * n * k < 128.0 * 128 * 128;
+        const size_t grain = evenGrain(batch, batchParallel);
+        parallelFor(batch, grain, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                auto [offA, offB] = offsets(b);
+                GemmEpilogue<TC> ep = epilogue;
+                if (ep.residual)
+                    ep.residual += b * matC;
+                runGemm<T, TB, TC>(transA, transB, m, n, k, args.ptrA + offA,
+                                   lda, args.ptrB + offB, ldb,
+                                   args.ptrC + b * matC, ldc,
+                                   fused ? &ep : nullptr, args.half);
+            }
+        });
+    }
+
+    template <typename T, typename TB = T, typename TC = T>
+    void doCompute(const Operator &_op, const RuntimeObj *context) const {
+        execute(resolve<T, TB, TC>(_op));
+    }
+
+    template <typename T, typename TB = T, typename TC = T>
+    std::function<void()> doPrepare(const Operator &_op) const {
+        return [args = resolve<T, TB, TC>(_op)] { execute(args); };
+    }
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+#define CASE(N)                                                                \
+    case N:                                                                    \
+        doCompute<DT<N>::t>(_op, context)
+
+        int dataTypeIdx = _op->getDType().getIndex();
+        switch (dataTypeIdx) {
+            CASE(1); // DataType::Float32
+            break;
+        case 2: // DataType::UInt8
+            doCompute<uint8_t, int8_t, int32_t>(_op, context);
+            break;
+        case 3: // DataType::Int8
+            doCompute<int8_t, int8_t, int32_t>(_op, context);
+            break;
+            CASE(10); // DataType::Float16
+            break;
+            CASE(12); // DataType::UInt32
+            break;
+            CASE(16); // DataType::BFloat16
+            break;
+        default:
+            IT_TODO_HALT();
+        }
+    }
+
+    std::function<void()> prepare(const Operator &_op,
+                                  const RuntimeObj *context) const override {
+        switch (_op->getDType().getIndex()) {
+        case 1: // DataType::Float32
+            return doPrepare<float>(_op);
+        case 2: // DataType::UInt8
+            return doPrepare<uint8_t, int8_t, int32_t>(_op);
+        case 3: // DataType::Int8
+            return doPrepare<int8_t, int8_t, int32_t>(_op);
+        case 10: // DataType::Float16
+        case 16: // DataType::BFloat16
+            return doPrepare<uint16_t>(_op);
+        case 12: // DataType::UInt32
+            return doPrepare<uint32_t>(_op);
+        default:
+            return Kernel::prepare(_op, context);
+        }
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::MatMul, NativeMatmul, "MatmulNative_CPU");
+
+} // namespace infini
@@ -0,0 +1,60 @@
+#include "operators/normalization.h"
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <cmath>
+
+namespace infini {
+
+/**
+ * LayerNormalization and RMSNormalization, one row per task: the statistics
+ * take one pass over the row and the normalization a second one, while the
+ * row is still in cache, so x is read from memory once.
+ */
+class NativeNormalization : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Work below which a call stays on the calling thread.
+    static constexpr size_t chunkSize = 16384;
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<NormalizationObj>(_op);
+        const auto &dims = op->getInputs(0)->getDims();
+        size_t rows = 1, size = 1;
+        for (int i = 0; i < op->getAxis(); ++i)
+            rows *= dims[i];
+        for (size_t i = op->getAxis(); i < dims.size(); ++i)
+            size *= dims[i];
+        const float *x = op->getInputs(0)->getRawDataPtr<float *>();
+        const float *gamma = op->getScale()->getRawDataPtr<float *>();
+        const float *beta =
+            op->getBias() ? op->getBias()->getRawDataPtr<float *>() : nullptr;
+        float *y = op->getOutput()->getRawDataPtr<float *>();
+        const float eps = op->getEps();
+        const bool rms = op->getOpType() == OpType::RMSNormalization;
+        const auto &k = simd.norm;
+
+        const size_t grain = evenGrain(rows, rows * size >= 2 * chunkSize);
+        parallelFor(rows, grain, [&](size_t begin, size_t end) {
+            for (size_t r = begin; r < end; ++r) {
+                const float *row = x + r * size;
+                float mean = 0.f, square;
+                if (rms)
+                    square = k.sumSquares(row, size) / float(size);
+                else
+                    k.meanVariance(row, size, &mean, &square);
+                k.normalize(row, mean, 1.f / std::sqrt(square + eps), gamma,
+                            beta, y + r * size, size);
+            }
+        });
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::LayerNormalization, NativeNormalization,
+                "LayerNormalizationNative_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::RMSNormalization, NativeNormalization,
+                "RMSNormalizationNative_CPU");
+
+} // namespace infini
@@ -0,0 +1,171 @@
+#include "operators/pooling.h"
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <algorithm>
+#include <limits>
+
+namespace infini {
+
+/**
+ * MaxPool and AveragePool on NCHW tensors, in a channel-blocked layout: a
+ * task packs the input rows of a band of output rows for blockC channels
+ * into [rows, W, blockC], so that every window tap is a vector fold across
+ * the channels (a whole output row of them at once when the stride is 1),
+ * and unpacks its [rows, OW, blockC] result into the output planes. Tasks
+ * are (image, channel block, band) triples.
+ */
+class NativePooling : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Channels per block, one AVX-512 vector.
+    static constexpr int blockC = 16;
+    // Floats of packed input rows one task may hold.
+    static constexpr size_t bandFloats = 32768;
+
+    // Outputs [begin, end) of a row whose input position
+    // o * stride - pad + offset falls in [0, in).
+    static void validRange(int out, int in, int pad, int stride, int offset,
+                           int &begin, int &end) {
+        const int lo = pad - offset, hi = in - 1 + pad - offset;
+        begin = lo <= 0 ? 0 : (lo + stride - 1) / stride;
+        end = hi < 0 ? 0 : std::min(out, hi / stride + 1);
+        end = std::max(begin, end);
+    }
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<PoolingObj>(_op);
+        if (!(op->getDType() == DataType::Float32))
+            IT_TODO_HALT();
+        const auto &xDims = op->getInputs(0)->getDims();
+        const auto &yDims = op->getOutput()->getDims();
+        const int n = xDims[0], c = xDims[1], h = xDims[2], w = xDims[3];
+        const int oh = yDims[2], ow = yDims[3];
+        const int kh = op->getKh(), kw = op->getKw(), dh = op->getDh(),
+                  dw = op->getDw(), ph = op->getPh(), pw = op->getPw(),
+                  sh = op->getSh(), sw = op->getSw();
+        const bool isMax = op->getOpType() == OpType::MaxPool;
+        const auto &fold = isMax ? simd.reduceMax : simd.reduceSum;
+        const float init =
+            isMax ? -std::numeric_limits<float>::infinity() : 0.f;
+        const auto *x = op->getInputs(0)->getRawDataPtr<uint32_t *>();
+        auto *y = op->getOutput()->getRawDataPtr<uint32_t *>();
+
+        vector<int> colBegin(kw), colEnd(kw), colCount(ow, 0);
+        for (int j = 0; j < kw; ++j) {
+            validRange(ow, w, pw, sw, j * dw, colBegin[j], colEnd[j]);
+            for (int ox = colBegin[j]; ox < colEnd[j]; ++ox)
+                ++colCount[ox];
+        }
+        // Output rows per band, so that their input rows fit bandFloats.
+        const int extent = (kh - 1) * dh + 1;
+        const int bandRows = std::clamp<int>(
+            (int(bandFloats / ((size_t)w * blockC)) - extent) / sh + 1, 1,
+            oh);
+        const int bands = (oh + bandRows - 1) / bandRows;
+        const int cBlocks = (c + blockC - 1) / blockC;
+        const size_t work = (size_t)n * c * oh * ow * kh * kw;
+
+        const size_t tasks = (size_t)n * cBlocks * bands;
+        const size_t grain = evenGrain(tasks, work >= 32768);
+        parallelFor(tasks, grain, [&](size_t t0, size_t t1) {
+            for (size_t t = t0; t < t1; ++t) {
+                const int in = int(t / bands / cBlocks);
+                const int cb = int(t / bands % cBlocks);
+                const int band = int(t % bands);
+                const int c0 = cb * blockC;
+                const int cc = std::min(blockC, c - c0);
+                const int oy0 = band * bandRows,
+                          oy1 = std::min(oh, oy0 + bandRows);
+                const int iy0 = std::max(0, oy0 * sh - ph);
+                const int iy1 =
+                    std::min(h, (oy1 - 1) * sh - ph + extent);
+                vector<float> packed((size_t)(iy1 - iy0) * w * blockC);
+                vector<float> acc((size_t)(oy1 - oy0) * ow * blockC,
+                                  init);
+                simd.transpose32(
+                    x + (((size_t)in * c + c0) * h + iy0) * w,
+                    (size_t)h * w,
+                    reinterpret_cast<uint32_t *>(packed.data()), blockC,
+                    cc, (size_t)(iy1 - iy0) * w);
+
+                for (int oy = oy0; oy < oy1; ++oy) {
+                    float *row =
+                        acc.data() + (size_t)(oy - oy0) * ow * blockC;
+                    int rowCount = 0;
+                    for (int i = 0; i < kh; ++i) {
+                        const int iy = oy * sh - ph + i * dh;
+                        if (iy < 0 || iy >= h)
+                            continue;
+                        ++rowCount;
+                        const float *src = packed.data() +
+                                           (size_t)(iy - iy0) * w * blockC;
+                        for (int j = 0; j < kw; ++j) {
+                            const int b = colBegin[j], e = colEnd[j];
+                            const int shift = j * dw - pw;
+                            if (sw == 1) {
+                                fold.accumulate(row + b * blockC,
+                                                src + (b + shift) * blockC,
+                                                (size_t)(e - b) * blockC);
+                                continue;
+                            }
+                            for (int ox = b; ox < e; ++ox)
+                                fold.accumulate(
+                                    row + ox * blockC,
+                                    src + (ox * sw + shift) * blockC,
+                                    blockC);
+                        }
+                    }
+                    // Dilation may skip every tap of a window, whose
+                    // average is then 0, as in ONNX runtimes.
+                    if (!isMax)
+                        for (int ox = 0; ox < ow; ++ox) {
+                            const int count = rowCount * colCount[ox];
+                            simd.mul.vs(row + ox * blockC,
+                                        count ? 1.f / float(count) : 0.f,
+                                        row + ox * blockC, blockC);
+                        }
+                }
+
+                simd.transpose32(
+                    reinterpret_cast<const uint32_t *>(acc.data()),
+                    blockC, y + (((size_t)in * c + c0) * oh + oy0) * ow,
+                    (size_t)oh * ow, (size_t)(oy1 - oy0) * ow, cc);
+            }
+        });
+    }
+};
+
+// The mean of each plane, from the horizontal sum of the reductions.
+class NativeGlobalAvgPool : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<GlobalAvgPoolObj>(_op);
+        if (!(op->getDType() == DataType::Float32))
+            IT_TODO_HALT();
+        const auto &dims = op->getInputs(0)->getDims();
+        const size_t planes = (size_t)dims[0] * dims[1];
+        const size_t plane = (size_t)dims[2] * dims[3];
+        const float *x = op->getInputs(0)->getRawDataPtr<float *>();
+        float *y = op->getOutput()->getRawDataPtr<float *>();
+        const size_t grain = evenGrain(planes, planes * plane >= 32768);
+        parallelFor(planes, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                y[i] = simd.reduceSum.all(x + i * plane, plane) / float(plane);
+        });
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::MaxPool, NativePooling,
+                "MaxPoolNative_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::AveragePool, NativePooling,
+                "AveragePoolNative_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::GlobalAveragePool, NativeGlobalAvgPool,
+                "GlobalAveragePoolNative_CPU");
+
+} // namespace infini
@@ -0,0 +1,128 @@
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "operators/quantize.h"
+#include <limits>
+
+namespace infini {
+
+namespace {
+
+// Elements per parallel chunk, as in the unary kernels.
+constexpr size_t chunkSize = 16384;
+
+// Calls `fn(c, begin, len)` on the runs of consecutive elements that share
+// channel c, for x viewed as [outer, channels, inner]; channels is 1 for
+// per-tensor parameters. Chunks of the flat range run in parallel, so a
+// per-tensor operator is split as well.
+template <typename Fn>
+void forEachChannelRun(const QuantizationObj &op, Fn &&fn) {
+    const auto &dims = op.getInputs(0)->getDims();
+    const size_t n = op.getInputs(0)->size();
+    size_t channels = 1, inner = n;
+    if (op.isPerChannel()) {
+        channels = dims[op.getAxis()];
+        inner = 1;
+        for (size_t i = op.getAxis() + 1; i < dims.size(); ++i)
+            inner *= dims[i];
+    }
+    if (n == 0 || inner == 0)
+        return;
+    parallelFor(n, chunkSize, [&](size_t begin, size_t end) {
+        while (begin < end) {
+            const size_t row = begin / inner;
+            const size_t len = std::min(end, (row + 1) * inner) - begin;
+            fn(row % channels, begin, len);
+            begin += len;
+        }
+    });
+}
+
+} // namespace
+
+class NativeQuantizeLinear : public CpuKernelWithoutConfig {
+    // Rounds half to even with the 1.5 * 2^23 trick, which is exact once the
+    // value is clamped to the range of T and lets the loop vectorize without
+    // SSE4.1 rounding instructions. NaN quantizes to the zero point.
+    template <typename T>
+    static void quantize(const float *x, T *y, size_t n, float scale,
+                         int zeroPoint) {
+        constexpr float magic = 12582912.f;
+        const float lo = float(std::numeric_limits<T>::min() - zeroPoint);
+        const float hi = float(std::numeric_limits<T>::max() - zeroPoint);
+        for (size_t i = 0; i < n; ++i) {
+            float v = x[i] / scale;
+            v = v != v ? 0.f : v < lo ? lo : v > hi ? hi : v;
+            y[i] = T(int((v + magic) - magic) + zeroPoint);
+        }
+    }
+
+    template <typename T> static void doCompute(const QuantizeLinearObj &op) {
+        const float *x = op.getInputs(0)->getRawDataPtr<float *>();
+        const float *scale = op.getScale()->getRawDataPtr<float *>();
+        const T *zeroPoint =
+            op.getZeroPoint() ? op.getZeroPoint()->getRawDataPtr<T *>()
+                              : nullptr;
+        T *y = op.getOutput()->getRawDataPtr<T *>();
+        forEachChannelRun(op, [&](size_t c, size_t begin, size_t len) {
+            quantize(x + begin, y + begin, len, scale[c],
+                     zeroPoint ? int(zeroPoint[c]) : 0);
+        });
+    }
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<QuantizeLinearObj>(_op);
+        auto dtype = op->getOutDType();
+        if (dtype == DataType::Int8)
+            doCompute<int8_t>(*op);
+        else if (dtype == DataType::UInt8)
+            doCompute<uint8_t>(*op);
+        else
+            IT_TODO_HALT();
+    }
+};
+
+class NativeDequantizeLinear : public CpuKernelWithoutConfig {
+    // The subtraction is done in 64 bits so that no Int32 value with its
+    // zero point overflows.
+    template <typename T> static void doCompute(const DequantizeLinearObj &op) {
+        const T *x = op.getInputs(0)->getRawDataPtr<T *>();
+        const float *scale = op.getScale()->getRawDataPtr<float *>();
+        const T *zeroPoint =
+            op.getZeroPoint() ? op.getZeroPoint()->getRawDataPtr<T *>()
+                              : nullptr;
+        float *y = op.getOutput()->getRawDataPtr<float *>();
+        forEachChannelRun(op, [&](size_t c, size_t begin, size_t len) {
+            const float s = scale[c];
+            if (!zeroPoint || zeroPoint[c] == 0) {
+                for (size_t i = begin; i < begin + len; ++i)
+                    y[i] = float(x[i]) * s;
+            } else {
+                const int64_t z = zeroPoint[c];
+                for (size_t i = begin; i < begin + len; ++i)
+                    y[i] = float(int64_t(x[i]) - z) * s;
+            }
+        });
+    }
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<DequantizeLinearObj>(_op);
+        auto dtype = op->getDType();
+        if (dtype == DataType::Int8)
+            doCompute<int8_t>(*op);
+        else if (dtype == DataType::UInt8)
+            doCompute<uint8_t>(*op);
+        else if (dtype == DataType::Int32)
+            doCompute<int32_t>(*op);
+        else
+            IT_TODO_HALT();
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::QuantizeLinear, NativeQuantizeLinear,
+                "QuantizeLinearNative_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::DequantizeLinear, NativeDequantizeLinear,
+                "DequantizeLinearNative_CPU");
+
+} // namespace infini
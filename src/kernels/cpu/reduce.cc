@@ -0,0 +1,229 @@
+#include "operators/reduce.h"
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <cstring>
+
+namespace infini {
+
+namespace {
+
+// One pass folds the middle dimension of an [outer, size, inner] view.
+struct ReducePass {
+    size_t outer, size, inner;
+};
+
+// Merges neighbouring dimensions that are both reduced or both kept and
+// drops the dimensions of size 1, then lists the passes from the innermost
+// reduced dimension outwards; each pass removes one reduced dimension and
+// merges the kept dimensions on either side of it. Empty when nothing is
+// reduced.
+vector<ReducePass> planReduce(const ReduceObj &op) {
+    const auto &dims = op.getInputs(0)->getDims();
+    vector<pair<size_t, bool>> segments; // (size, reduced)
+    for (size_t i = 0; i < dims.size(); ++i) {
+        if (dims[i] == 1)
+            continue;
+        bool reduced = op.isReduced(i);
+        if (!segments.empty() && segments.back().second == reduced)
+            segments.back().first *= dims[i];
+        else
+            segments.emplace_back(dims[i], reduced);
+    }
+    vector<ReducePass> passes;
+    for (;;) {
+        int r = int(segments.size()) - 1;
+        while (r >= 0 && !segments[r].second)
+            --r;
+        if (r < 0)
+            break;
+        size_t outer = 1, inner = 1;
+        for (int i = 0; i < r; ++i)
+            outer *= segments[i].first;
+        for (size_t i = r + 1; i < segments.size(); ++i)
+            inner *= segments[i].first;
+        passes.push_back({outer, segments[r].first, inner});
+        segments.erase(segments.begin() + r);
+        if (r > 0 && r < int(segments.size()) &&
+            segments[r - 1].second == segments[r].second) {
+            segments[r - 1].first *= segments[r].first;
+            segments.erase(segments.begin() + r);
+        }
+    }
+    return passes;
+}
+
+} // namespace
+
+/**
+ * Rows are folded with the horizontal `all` loop when the reduced dimension
+ * is the innermost one, and with the vertical `accumulate` loop into
+ * L1-sized blocks of the output otherwise. Long reductions are split into
+ * partial results whose layout depends only on the shape, never on the
+ * number of threads, and combined in a fixed order, so the result is the
+ * same from run to run.
+ */
+class NativeReduce : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Elements folded by one task, and so the granularity of the partials.
+    static constexpr size_t chunkSize = 16384;
+    // Output columns accumulated at once by the vertical passes.
+    static constexpr size_t blockSize = 2048;
+    // Below this many (row, block) tasks a vertical pass also splits its
+    // rows into groups, at most maxGroups of them and with at most
+    // maxPartials floats of partial results.
+    static constexpr size_t minTasks = 64, maxGroups = 64;
+    static constexpr size_t maxPartials = size_t(1) << 20;
+
+    const ReduceKernels &reduceKernels(OpType type) const {
+        switch (type.underlying()) {
+        case OpType::ReduceSum:
+        case OpType::ReduceMean:
+            return simd.reduceSum;
+        case OpType::ReduceMax:
+            return simd.reduceMax;
+        case OpType::ReduceMin:
+            return simd.reduceMin;
+        default:
+            IT_TODO_HALT();
+        }
+    }
+
+    // [outer, size] to [outer]. Rows longer than a chunk are folded chunk by
+    // chunk in parallel and the partials of a row folded again in order.
+    static void reduceRows(const ReduceKernels &k, const float *x, float *y,
+                           size_t outer, size_t size) {
+        const size_t chunks = std::max<size_t>(1, (size + chunkSize - 1) /
+                                                      chunkSize);
+        const bool parallel = outer * size >= 2 * chunkSize;
+        if (chunks == 1) {
+            const size_t grain = evenGrain(outer, parallel);
+            parallelFor(outer, grain, [&](size_t begin, size_t end) {
+                for (size_t o = begin; o < end; ++o)
+                    y[o] = k.all(x + o * size, size);
+            });
+            return;
+        }
+        vector<float> partial(outer * chunks);
+        const size_t tasks = outer * chunks;
+        const size_t grain = evenGrain(tasks, parallel);
+        parallelFor(tasks, grain, [&](size_t t0, size_t t1) {
+            for (size_t t = t0; t < t1; ++t) {
+                const size_t o = t / chunks, c = t % chunks;
+                size_t begin = c * chunkSize;
+                partial[t] = k.all(x + o * size + begin,
+                                   std::min(chunkSize, size - begin));
+            }
+        });
+        for (size_t o = 0; o < outer; ++o)
+            y[o] = k.all(partial.data() + o * chunks, chunks);
+    }
+
+    // [outer, size, inner] to [outer, inner] for inner > 1. With few
+    // (row, block) tasks, groups of rows fold into separate partials that
+    // are then combined pairwise, as a tree.
+    static void reduceColumns(const ReduceKernels &k, const float *x,
+                              float *y, size_t outer, size_t size,
+                              size_t inner) {
+        if (size == 0) {
+            std::fill_n(y, outer * inner, k.all(nullptr, 0));
+            return;
+        }
+        const size_t blocks = (inner + blockSize - 1) / blockSize;
+        size_t groups = 1;
+        if (outer * blocks < minTasks && size * inner >= 2 * chunkSize)
+            groups = std::max<size_t>(
+                1, std::min({size * inner / chunkSize, size, maxGroups,
+                             maxPartials / (outer * inner)}));
+        const size_t rowsPerGroup = (size + groups - 1) / groups;
+        groups = (size + rowsPerGroup - 1) / rowsPerGroup;
+
+        // Group 0 folds straight into y.
+        vector<float> partial((groups - 1) * outer * inner);
+        auto acc = [&](size_t g, size_t o) {
+            return g == 0 ? y + o * inner
+                          : partial.data() + ((g - 1) * outer + o) * inner;
+        };
+        const bool parallel = outer * size * inner >= 2 * chunkSize;
+        const size_t tasks = groups * outer * blocks;
+        const size_t grain = evenGrain(tasks, parallel);
+        parallelFor(tasks, grain, [&](size_t t0, size_t t1) {
+            for (size_t t = t0; t < t1; ++t) {
+                const size_t g = t / blocks / outer, o = t / blocks % outer,
+                             b = t % blocks;
+                const size_t begin = b * blockSize;
+                const size_t len = std::min(blockSize, inner - begin);
+                const size_t r0 = g * rowsPerGroup;
+                const size_t r1 = std::min(size, r0 + rowsPerGroup);
+                const float *src = x + (o * size + r0) * inner + begin;
+                float *dst = acc(g, o) + begin;
+                std::memcpy(dst, src, len * sizeof(float));
+                for (size_t r = r0 + 1; r < r1; ++r)
+                    k.accumulate(dst, src += inner, len);
+            }
+        });
+        for (size_t step = 1; step < groups; step *= 2) {
+            const size_t pairs = (groups - step - 1) / (2 * step) + 1;
+            const size_t sums = pairs * outer;
+            const size_t grain = evenGrain(sums, parallel && pairs > 1);
+            parallelFor(sums, grain, [&](size_t t0, size_t t1) {
+                for (size_t t = t0; t < t1; ++t) {
+                    const size_t p = t / outer, o = t % outer;
+                    k.accumulate(acc(2 * step * p, o),
+                                 acc(2 * step * p + step, o), inner);
+                }
+            });
+        }
+    }
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        auto op = as<ReduceObj>(_op);
+        if (!(op->getDType() == DataType::Float32))
+            IT_TODO_HALT();
+        const auto &k = reduceKernels(op->getOpType());
+        const float *x = op->getInputs(0)->getRawDataPtr<float *>();
+        float *y = op->getOutput()->getRawDataPtr<float *>();
+        const size_t n = op->getOutput()->size();
+
+        auto passes = planReduce(*op);
+        if (passes.empty())
+            std::memcpy(y, x, n * sizeof(float));
+        vector<float> buffers[2];
+        const float *src = x;
+        for (size_t i = 0; i < passes.size(); ++i) {
+            const auto &[outer, size, inner] = passes[i];
+            float *dst = y;
+            if (i + 1 < passes.size()) {
+                buffers[i % 2].resize(outer * inner);
+                dst = buffers[i % 2].data();
+            }
+            if (inner == 1)
+                reduceRows(k, src, dst, outer, size);
+            else
+                reduceColumns(k, src, dst, outer, size, inner);
+            src = dst;
+        }
+
+        if (op->getOpType() == OpType::ReduceMean) {
+            const auto &dims = op->getInputs(0)->getDims();
+            size_t count = 1;
+            for (int axis : op->getAxes())
+                count *= dims[axis];
+            simd.div.vs(y, float(count), y, n);
+        }
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::ReduceSum, NativeReduce,
+                "ReduceSumNative_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::ReduceMean, NativeReduce,
+                "ReduceMeanNative_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::ReduceMax, NativeReduce,
+                "ReduceMaxNative_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::ReduceMin, NativeReduce,
+                "ReduceMinNative_CPU");
+
+} // namespace infini
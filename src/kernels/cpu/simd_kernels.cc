@@ -0,0 +1,275 @@
+#include "kernels/cpu/simd_kernels.h"
+#include "utils/float16.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+namespace infini {
+
+namespace {
+
+// The std functors inline into the loops, which the compiler vectorizes
+// where the baseline ISA allows it.
+template <typename T, typename Op>
+void binaryScalar(const T *a, const T *b, T *c, size_t n) {
+    Op op;
+    for (size_t i = 0; i < n; ++i)
+        c[i] = op(a[i], b[i]);
+}
+
+template <typename T, typename Op>
+void binaryVecScalar(const T *a, T b, T *c, size_t n) {
+    Op op;
+    for (size_t i = 0; i < n; ++i)
+        c[i] = op(a[i], b);
+}
+
+template <typename T, typename Op>
+void binaryScalarVec(const T *a, T b, T *c, size_t n) {
+    Op op;
+    for (size_t i = 0; i < n; ++i)
+        c[i] = op(b, a[i]);
+}
+
+template <template <typename> class Op, typename T>
+constexpr BinaryKernels<T> binaryKernelsScalar() {
+    return {binaryScalar<T, Op<T>>, binaryVecScalar<T, Op<T>>,
+            binaryScalarVec<T, Op<T>>};
+}
+
+void reluScalar(const float *x, float *y, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        y[i] = std::max(0.f, x[i]);
+}
+
+void clipScalar(const float *x, float *y, size_t n, float lo, float hi) {
+    for (size_t i = 0; i < n; ++i) {
+        float val = x[i];
+        y[i] = val < lo ? lo : val > hi ? hi : val;
+    }
+}
+
+// Sequential folds; max and min propagate NaN.
+struct SumScalar {
+    static constexpr float identity = 0.f;
+    static float apply(float acc, float x) { return acc + x; }
+};
+struct MaxScalar {
+    static constexpr float identity = -std::numeric_limits<float>::infinity();
+    static float apply(float acc, float x) {
+        return acc < x || x != x ? x : acc;
+    }
+};
+struct MinScalar {
+    static constexpr float identity = std::numeric_limits<float>::infinity();
+    static float apply(float acc, float x) {
+        return x < acc || x != x ? x : acc;
+    }
+};
+
+template <typename F> float reduceAllScalar(const float *x, size_t n) {
+    float acc = F::identity;
+    for (size_t i = 0; i < n; ++i)
+        acc = F::apply(acc, x[i]);
+    return acc;
+}
+
+template <typename F>
+void reduceAccumulateScalar(float *acc, const float *x, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        acc[i] = F::apply(acc[i], x[i]);
+}
+
+// Same online normalizer as the ISA levels, with libm exp. m starts at the
+// lowest finite float so that -inf inputs add e^-inf = 0.
+constexpr float softmaxMaxInit = -std::numeric_limits<float>::max();
+
+void softmaxFoldScalar(float &m, float &s, float x) {
+    if (m < x) {
+        s = s * std::exp(m - x) + 1.f;
+        m = x;
+    } else {
+        s += std::exp(x - m);
+    }
+}
+
+void softmaxRowScalar(const float *x, float *y, size_t n) {
+    float m = softmaxMaxInit, s = 0.f;
+    for (size_t i = 0; i < n; ++i)
+        softmaxFoldScalar(m, s, x[i]);
+    const float inv = 1.f / s;
+    for (size_t i = 0; i < n; ++i)
+        y[i] = std::exp(x[i] - m) * inv;
+}
+
+void softmaxFoldColumnsScalar(float *m, float *s, const float *x, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        softmaxFoldScalar(m[i], s[i], x[i]);
+}
+
+void softmaxScaleColumnsScalar(const float *x, const float *m, const float *r,
+                               float *y, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        y[i] = std::exp(x[i] - m[i]) * r[i];
+}
+
+// Welford's algorithm on x - x[0], as in simd_math::meanVariance.
+void meanVarianceScalar(const float *x, size_t n, float *mean, float *var) {
+    const float shift = n > 0 ? x[0] : 0.f;
+    float mu = 0.f, m2 = 0.f;
+    for (size_t i = 0; i < n; ++i) {
+        float v = x[i] - shift, d = v - mu;
+        mu += d / float(i + 1);
+        m2 += d * (v - mu);
+    }
+    *mean = shift + mu;
+    *var = n > 0 ? m2 / float(n) : 0.f;
+}
+
+float sumSquaresScalar(const float *x, size_t n) {
+    float ret = 0.f;
+    for (size_t i = 0; i < n; ++i)
+        ret += x[i] * x[i];
+    return ret;
+}
+
+void normalizeScalar(const float *x, float shift, float scale,
+                     const float *gamma, const float *beta, float *y,
+                     size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        y[i] = (x[i] - shift) * scale * gamma[i] + (beta ? beta[i] : 0.f);
+}
+
+template <typename From, typename To, To (*f)(From)>
+void mapScalar(const From *x, To *y, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        y[i] = f(x[i]);
+}
+
+int32_t floatToInt32(float x) {
+    if (std::isnan(x))
+        return 0;
+    if (x >= 2147483648.f)
+        return INT32_MAX;
+    if (x < -2147483648.f)
+        return INT32_MIN;
+    return int32_t(x);
+}
+
+float int32ToFloat(int32_t x) { return float(x); }
+
+float expScalar(float x) { return std::exp(x); }
+float sigmoidScalar(float x) { return 1.f / (1.f + std::exp(-x)); }
+float tanhScalar(float x) { return std::tanh(x); }
+float geluScalar(float x) {
+    return 0.5f * x * std::erfc(x * -0.70710678118654752f);
+}
+float siluScalar(float x) { return x / (1.f + std::exp(-x)); }
+float erfScalar(float x) { return std::erf(x); }
+
+void transpose32Scalar(const uint32_t *src, size_t lds, uint32_t *dst,
+                       size_t ldd, size_t rows, size_t cols) {
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            dst[j * ldd + i] = src[i * lds + j];
+}
+
+void streamCopyScalar(void *dst, const void *src, size_t bytes) {
+    std::memcpy(dst, src, bytes);
+}
+
+SimdKernels scalarKernels() {
+    SimdKernels table;
+    table.isa = CpuIsa::Scalar;
+    table.sgemm = {4, 8, gemmMicroKernelScalar<float, 4, 8>};
+    table.u8s8gemm = {4, 8, gemmU8S8MicroKernelScalar<4, 8>};
+    table.add = binaryKernelsScalar<std::plus, float>();
+    table.sub = binaryKernelsScalar<std::minus, float>();
+    table.mul = binaryKernelsScalar<std::multiplies, float>();
+    table.div = binaryKernelsScalar<std::divides, float>();
+    // No ISA level has a packed 32-bit integer division, so divU32 always
+    // stays scalar.
+    table.addU32 = binaryKernelsScalar<std::plus, uint32_t>();
+    table.subU32 = binaryKernelsScalar<std::minus, uint32_t>();
+    table.mulU32 = binaryKernelsScalar<std::multiplies, uint32_t>();
+    table.divU32 = binaryKernelsScalar<std::divides, uint32_t>();
+    table.relu = reluScalar;
+    table.clip = clipScalar;
+    table.reduceSum = {reduceAllScalar<SumScalar>,
+                       reduceAccumulateScalar<SumScalar>};
+    table.reduceMax = {reduceAllScalar<MaxScalar>,
+                       reduceAccumulateScalar<MaxScalar>};
+    table.reduceMin = {reduceAllScalar<MinScalar>,
+                       reduceAccumulateScalar<MinScalar>};
+    table.softmax = {softmaxRowScalar, softmaxFoldColumnsScalar,
+                     softmaxScaleColumnsScalar};
+    table.norm = {meanVarianceScalar, sumSquaresScalar, normalizeScalar};
+    table.exp = mapScalar<float, float, expScalar>;
+    table.sigmoid = mapScalar<float, float, sigmoidScalar>;
+    table.tanh = mapScalar<float, float, tanhScalar>;
+    table.gelu = mapScalar<float, float, geluScalar>;
+    table.silu = mapScalar<float, float, siluScalar>;
+    table.erf = mapScalar<float, float, erfScalar>;
+    table.f32ToF16 = mapScalar<float, uint16_t, float_to_float16>;
+    table.f32ToBf16 = mapScalar<float, uint16_t, float_to_bfloat16>;
+    table.f16ToF32 = mapScalar<uint16_t, float, float16_to_float>;
+    table.bf16ToF32 = mapScalar<uint16_t, float, bfloat16_to_float>;
+    table.f32ToI32 = mapScalar<float, int32_t, floatToInt32>;
+    table.i32ToF32 = mapScalar<int32_t, float, int32ToFloat>;
+    table.transpose32 = transpose32Scalar;
+    table.streamCopy = streamCopyScalar;
+    return table;
+}
+
+// Builds the table of `isa` by applying the fill functions of every level up
+// to it on top of the scalar table.
+SimdKernels buildKernels(CpuIsa isa) {
+    SimdKernels table = scalarKernels();
+#if defined(__x86_64__) || defined(__i386__)
+    if (isa >= CpuIsa::SSE4)
+        fillSimdKernelsSse4(table);
+    if (isa >= CpuIsa::AVX2)
+        fillSimdKernelsAvx2(table);
+    if (isa >= CpuIsa::AVX512)
+        fillSimdKernelsAvx512(table);
+    const auto &cpu = CpuFeatures::getInstance();
+    if (isa >= CpuIsa::AVX2 && cpu.hasAvxVnni())
+        fillSimdKernelsAvxVnni(table);
+    if (isa >= CpuIsa::AVX512 && cpu.hasAvx512Vnni())
+        fillSimdKernelsAvx512Vnni(table);
+    table.isa = isa;
+#endif
+    return table;
+}
+
+} // namespace
+
+const SimdKernels *getSimdKernels(CpuIsa isa) {
+    // The fill functions are built with the flags of their level and may
+    // use its instructions themselves, so a table is only built once the
+    // host is known to support it, on first use.
+    if (!CpuFeatures::getInstance().supports(isa))
+        return nullptr;
+    static SimdKernels tables[4];
+    static std::once_flag built[4];
+    const int i = int(isa);
+    std::call_once(built[i], [&] { tables[i] = buildKernels(isa); });
+    return tables[i].isa == isa ? &tables[i] : nullptr;
+}
+
+HalfConversions getHalfConversions(const SimdKernels &table, DataType dtype) {
+    if (dtype == DataType::Float16)
+        return {table.f16ToF32, table.f32ToF16};
+    IT_ASSERT(dtype == DataType::BFloat16,
+              "Not a 16-bit float type: " + dtype.toString());
+    return {table.bf16ToF32, table.f32ToBf16};
+}
+
+const SimdKernels &getSimdKernels() {
+    static const SimdKernels *table =
+        getSimdKernels(CpuFeatures::getInstance().getIsa());
+    return *table;
+}
+
+} // namespace infini
@@ -0,0 +1,102 @@
+#include "operators/softmax.h"
+#include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <limits>
+
+namespace infini {
+
+/**
+ * Softmax over x viewed as [outer, size, inner]. With inner == 1 every row is
+ * contiguous and one task runs the row kernel on it; otherwise a task keeps
+ * the online max and sum of a block of columns, folds the `size` rows of the
+ * block into them and then writes the block's outputs. Either way x is read
+ * twice, and since every element of a row is read before any of it is
+ * written, the output may alias the input.
+ */
+class NativeSoftmax : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Work below which a call stays on the calling thread.
+    static constexpr size_t chunkSize = 16384;
+    // Columns of one task when the axis is not the innermost one.
+    static constexpr size_t blockSize = 512;
+
+    // The input viewed as [outer, size, inner], resolved from the op.
+    struct Args {
+        const float *x;
+        float *y;
+        size_t outer, size, inner;
+    };
+
+    static Args resolve(const Operator &_op) {
+        auto op = as<SoftmaxObj>(_op);
+        if (!(op->getDType() == DataType::Float32))
+            IT_TODO_HALT();
+        const auto &dims = op->getInputs(0)->getDims();
+        const int axis = op->getAxis();
+        size_t outer = 1, inner = 1;
+        for (int i = 0; i < axis; ++i)
+            outer *= dims[i];
+        for (size_t i = axis + 1; i < dims.size(); ++i)
+            inner *= dims[i];
+        return {op->getInputs(0)->getRawDataPtr<float *>(),
+                op->getOutput()->getRawDataPtr<float *>(), outer,
+                size_t(dims[axis]), inner};
+    }
+
+    void execute(const Args &args) const {
+        const float *x = args.x;
+        float *y = args.y;
+        const size_t outer = args.outer, size = args.size, inner = args.inner;
+        const bool parallel = outer * size * inner >= 2 * chunkSize;
+        const auto &k = simd.softmax;
+
+        if (inner == 1) {
+            const size_t grain = evenGrain(outer, parallel);
+            parallelFor(outer, grain, [&](size_t begin, size_t end) {
+                for (size_t o = begin; o < end; ++o)
+                    k.row(x + o * size, y + o * size, size);
+            });
+            return;
+        }
+
+        const size_t blocks = (inner + blockSize - 1) / blockSize;
+        const size_t tasks = outer * blocks;
+        const size_t grain = evenGrain(tasks, parallel);
+        parallelFor(tasks, grain, [&](size_t t0, size_t t1) {
+            for (size_t t = t0; t < t1; ++t) {
+                const size_t o = t / blocks, b = t % blocks;
+                const size_t begin = b * blockSize;
+                const size_t len = std::min(blockSize, inner - begin);
+                const size_t base = o * size * inner + begin;
+                float max[blockSize], sum[blockSize];
+                std::fill_n(max, len, -std::numeric_limits<float>::max());
+                std::fill_n(sum, len, 0.f);
+                for (size_t r = 0; r < size; ++r)
+                    k.foldColumns(max, sum, x + base + r * inner, len);
+                for (size_t i = 0; i < len; ++i)
+                    sum[i] = 1.f / sum[i];
+                for (size_t r = 0; r < size; ++r)
+                    k.scaleColumns(x + base + r * inner, max, sum,
+                                   y + base + r * inner, len);
+            }
+        });
+    }
+
+    void compute(const Operator &_op,
+                 const RuntimeObj *context) const override {
+        execute(resolve(_op));
+    }
+
+    std::function<void()> prepare(const Operator &_op,
+                                  const RuntimeObj *context) const override {
+        return [this, args = resolve(_op)] { execute(args); };
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::Softmax, NativeSoftmax,
+                "SoftmaxNative_CPU");
+
+} // namespace infini
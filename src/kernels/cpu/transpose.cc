@@ -1,52 +1,178 @@
 #include "operators/transpose.h"
 #include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <algorithm>
+#include <cstring>
 
 namespace infini {
 
-inline Shape idx2Pos(const Shape &shape, size_t idx) {
-    Shape pos = Shape(shape.size(), 0);
-    auto rest = idx, curDimId = shape.size() - 1;
-    while (rest > 0) {
-        pos[curDimId] = rest % shape[curDimId];
-        rest /= shape[curDimId];
-        curDimId--;
+namespace {
+
+/**
+ * @brief Transpose with the size-1 dims dropped and the input dims that stay
+ * adjacent and in order in the output merged, e.g. permute [0,2,3,1] of
+ * [N,C,H,W] becomes permute [0,2,1] of [N,C,H*W].
+ */
+struct TransposePlan {
+    static constexpr int MaxRank = 8;
+    int rank = 0;
+    size_t size = 1;
+    // Collapsed input dims, the output takes them in `perm` order.
+    size_t dims[MaxRank];
+    int perm[MaxRank];
+    // Element strides of each collapsed input dim in the input and output.
+    size_t inStride[MaxRank], outStride[MaxRank];
+
+    TransposePlan(const Shape &shape, const vector<int> &permute) {
+        const int rankIn = shape.size();
+        // Input dims kept after dropping size 1, listed in output order.
+        vector<int> order;
+        for (int j = 0; j < rankIn; ++j)
+            if (shape[permute[j]] != 1)
+                order.emplace_back(permute[j]);
+        // Runs of consecutive input dims in the output become one dim.
+        vector<pair<int, size_t>> groups; // (first input dim, size)
+        for (size_t j = 0; j < order.size(); ++j) {
+            if (j > 0 && order[j] == order[j - 1] + 1)
+                groups.back().second *= shape[order[j]];
+            else
+                groups.emplace_back(order[j], shape[order[j]]);
+        }
+        rank = groups.size();
+        IT_ASSERT(rank <= MaxRank, "Transpose has too many dims");
+        vector<int> byInput(rank);
+        for (int g = 0; g < rank; ++g)
+            byInput[g] = g;
+        std::sort(byInput.begin(), byInput.end(), [&](int x, int y) {
+            return groups[x].first < groups[y].first;
+        });
+        for (int d = 0; d < rank; ++d) {
+            dims[d] = groups[byInput[d]].second;
+            perm[byInput[d]] = d;
+            size *= dims[d];
+        }
+        size_t p = 1;
+        for (int d = rank - 1; d >= 0; p *= dims[d--])
+            inStride[d] = p;
+        p = 1;
+        for (int j = rank - 1; j >= 0; p *= dims[perm[j--]])
+            outStride[perm[j]] = p;
     }
-    return pos;
+};
+
+template <typename T>
+void transposeBlock(const T *src, size_t lds, T *dst, size_t ldd, size_t rows,
+                    size_t cols) {
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            dst[j * ldd + i] = src[i * lds + j];
 }
 
-class NaiveTranspose : public CpuKernelWithoutConfig {
+} // namespace
+
+class NativeTranspose : public CpuKernelWithoutConfig {
+    // ISA-specific loops, chosen when the kernel is registered.
+    const SimdKernels &simd = getSimdKernels();
+
+    // Side of the square blocks of the 2-D swap, so that the source and
+    // destination blocks of 4-byte elements stay in L1 together.
+    static constexpr size_t blockSize = 64;
+    // Tensors below this many elements are moved by the calling thread.
+    static constexpr size_t parallelThreshold = 32768;
+
+    // The innermost dim stays innermost: copy whole rows.
     template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
-        auto op = as<TransposeObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
-        const auto &inDim = inputs[0]->getDims();
-        const auto &perm = op->getPermute();
-
-        size_t inSize = inputs[0]->size();
-        auto inPtr = inputs[0]->getRawDataPtr<T *>(),
-             outPtr = outputs[0]->getRawDataPtr<T *>();
-        // #pragma omp parallel for
-        for (size_t inIdx = 0; inIdx < inSize; ++inIdx) {
-            auto posInput = idx2Pos(inDim, inIdx);
-            int outIdx = 0;
-            for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
-                outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
+    static void copyRows(const TransposePlan &plan, const T *in, T *out) {
+        const int last = plan.rank - 1;
+        const size_t inner = plan.dims[last];
+        const size_t rows = plan.size / inner;
+        const size_t grain = evenGrain(rows, plan.size >= parallelThreshold);
+        parallelFor(rows, grain, [&](size_t begin, size_t end) {
+            for (size_t r = begin; r < end; ++r) {
+                size_t offset = 0, rest = r;
+                for (int j = last - 1; j >= 0; --j) {
+                    int d = plan.perm[j];
+                    offset += rest % plan.dims[d] * plan.inStride[d];
+                    rest /= plan.dims[d];
+                }
+                std::memcpy(out + r * inner, in + offset, inner * sizeof(T));
             }
-            outPtr[outIdx] = inPtr[inIdx];
-        }
+        });
+    }
+
+    // The innermost dims of the input (a) and the output (b) differ: each
+    // outer index is a 2-D swap of the (b, a) plane, split into blocks.
+    template <typename T>
+    static void swapPlanes(const TransposePlan &plan, const T *in, T *out,
+                           void (*block)(const T *, size_t, T *, size_t,
+                                         size_t, size_t)) {
+        const int a = plan.rank - 1, b = plan.perm[plan.rank - 1];
+        const size_t lds = plan.inStride[b], ldd = plan.outStride[a];
+        const size_t rowBlocks = (plan.dims[b] + blockSize - 1) / blockSize;
+        const size_t colBlocks = (plan.dims[a] + blockSize - 1) / blockSize;
+        const size_t planes = plan.size / (plan.dims[a] * plan.dims[b]);
+        const size_t tasks = planes * rowBlocks * colBlocks;
+        const size_t grain = evenGrain(tasks, plan.size >= parallelThreshold);
+        parallelFor(tasks, grain, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                size_t colBlock = t % colBlocks;
+                size_t rowBlock = t / colBlocks % rowBlocks;
+                size_t rest = t / colBlocks / rowBlocks;
+                size_t inOffset = 0, outOffset = 0;
+                for (int d = plan.rank - 1; d >= 0; --d) {
+                    if (d == a || d == b)
+                        continue;
+                    size_t index = rest % plan.dims[d];
+                    rest /= plan.dims[d];
+                    inOffset += index * plan.inStride[d];
+                    outOffset += index * plan.outStride[d];
+                }
+                size_t i = rowBlock * blockSize, j = colBlock * blockSize;
+                block(in + inOffset + i * lds + j, lds,
+                      out + outOffset + j * ldd + i, ldd,
+                      std::min(blockSize, plan.dims[b] - i),
+                      std::min(blockSize, plan.dims[a] - j));
+            }
+        });
+    }
+
+    // Elements are moved as opaque words of their byte size.
+    template <typename T>
+    void doCompute(const TransposePlan &plan, const void *input, void *output,
+                   void (*block)(const T *, size_t, T *, size_t, size_t,
+                                 size_t)) const {
+        auto in = static_cast<const T *>(input);
+        auto out = static_cast<T *>(output);
+        if (plan.rank <= 1)
+            std::memcpy(out, in, plan.size * sizeof(T));
+        else if (plan.perm[plan.rank - 1] == plan.rank - 1)
+            copyRows(plan, in, out);
+        else
+            swapPlanes(plan, in, out, block);
     }
 
     void compute(const Operator &_op,
                  const RuntimeObj *context) const override {
-#define CASE(N)                                                                \
-    case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
-
-        int dataTypeIdx = _op->getDType().getIndex();
-        switch (dataTypeIdx) {
-            CASE(1); // DataType::Float32
+        auto op = as<TransposeObj>(_op);
+        auto input = op->getInputs(0), output = op->getOutput();
+        if (input->size() == 0)
+            return;
+        TransposePlan plan(input->getDims(), op->getPermute());
+        auto inPtr = input->getRawDataPtr<void *>();
+        auto outPtr = output->getRawDataPtr<void *>();
+        switch (input->getDType().getSize()) {
+        case 1:
+            doCompute<uint8_t>(plan, inPtr, outPtr, transposeBlock<uint8_t>);
+            break;
+        case 2:
+            doCompute<uint16_t>(plan, inPtr, outPtr, transposeBlock<uint16_t>);
+            break;
+        case 4:
+            doCompute<uint32_t>(plan, inPtr, outPtr, simd.transpose32);
             break;
-            CASE(12); // DataType::UInt32
+        case 8:
+            doCompute<uint64_t>(plan, inPtr, outPtr, transposeBlock<uint64_t>);
             break;
         default:
             IT_TODO_HALT();
@@ -54,7 +180,7 @@ class NaiveTranspose : public CpuKernelWithoutConfig {
     }
 };
 
-REGISTER_KERNEL(Device::CPU, OpType::Transpose, NaiveTranspose,
-                "TransposeNaive_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::Transpose, NativeTranspose,
+                "TransposeNative_CPU");
 
 } // namespace infini
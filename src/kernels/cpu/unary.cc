@@ -1,41 +1,128 @@
 #include "operators/unary.h"
 #include "core/kernel.h"
+#include "core/thread_pool.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <limits>
 
 namespace infini
 {
-    class NativeUnary : public CpuKernelWithoutConfig
+    namespace
     {
-        template <typename T>
-        static T reluCompute(T val)
+        // Float16 and BFloat16 are converted to fp32 in blocks of this many
+        // elements, on the stack.
+        constexpr size_t halfBlockSize = 1024;
+
+        // Calls `fn(begin, len)` on consecutive blocks of n elements, split
+        // into parallel chunks like the Float32 loops.
+        template <typename Fn>
+        void forEachHalfBlock(size_t n, size_t chunkSize, Fn &&fn)
         {
-            return std::max(T(0), val);
+            parallelFor(n, chunkSize, [&](size_t chunkBegin, size_t end)
+            {
+                for (size_t begin = chunkBegin; begin < end;
+                     begin += halfBlockSize)
+                    fn(begin, std::min(halfBlockSize, end - begin));
+            });
         }
+    } // namespace
+
+    class NativeUnary : public CpuKernelWithoutConfig
+    {
+        // ISA-specific loops, chosen when the kernel is registered.
+        const SimdKernels &simd = getSimdKernels();
+
+        // Elements per parallel chunk: enough work to amortize the
+        // scheduling, so small tensors stay on the calling thread.
+        static constexpr size_t chunkSize = 16384;
 
         template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        static void reluCompute(const T *x, T *y, size_t n)
         {
-            auto op = as<UnaryObj>(_op);
-            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
-
-            auto outDim = op->getOutput()->getDims();
-            auto n = op->getOutput()->size();
+            for (size_t i = 0; i < n; ++i)
+                y[i] = std::max(T(0), x[i]);
+        }
 
-            T (*_doCompute)
-            (T val);
-            switch (op->getOpType().underlying())
+        UnaryF32Kernel simdKernel(OpType type) const
+        {
+            switch (type.underlying())
             {
             case OpType::Relu:
-                _doCompute = reluCompute<T>;
-                break;
+                return simd.relu;
+            case OpType::Exp:
+                return simd.exp;
+            case OpType::Sigmoid:
+                return simd.sigmoid;
+            case OpType::Tanh:
+                return simd.tanh;
+            case OpType::Gelu:
+                return simd.gelu;
+            case OpType::Silu:
+                return simd.silu;
+            case OpType::Erf:
+                return simd.erf;
             default:
                 IT_TODO_HALT();
             }
+        }
+
+        // What a Float32 or UInt32 call needs, resolved from the op.
+        template <typename T>
+        struct Args
+        {
+            void (*kernel)(const T *, T *, size_t);
+            const T *x;
+            T *y;
+            size_t n;
+        };
+
+        template <typename T>
+        Args<T> resolve(const Operator &_op) const
+        {
+            auto op = as<UnaryObj>(_op);
+            void (*kernel)(const T *, T *, size_t);
+            if constexpr (std::is_same_v<T, float>)
+                kernel = simdKernel(op->getOpType());
+            else if (op->getOpType() == OpType::Relu)
+                kernel = reluCompute<T>;
+            else
+                IT_TODO_HALT();
+            return {kernel, op->getInputs(0)->getRawDataPtr<T *>(),
+                    op->getOutput()->getRawDataPtr<T *>(),
+                    op->getOutput()->size()};
+        }
 
-            for (size_t offset = 0; offset < n; offset++)
+        template <typename T>
+        static void execute(const Args<T> &args)
+        {
+            parallelFor(args.n, chunkSize, [&](size_t begin, size_t end)
             {
-                outptr[offset] = _doCompute(inptr[offset]);
-            }
+                args.kernel(args.x + begin, args.y + begin, end - begin);
+            });
+        }
+
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            execute(resolve<T>(_op));
+        }
+
+        // Float16 and BFloat16 run the Float32 loop on blocks converted on
+        // the stack.
+        void doComputeHalf(const Operator &_op) const
+        {
+            auto op = as<UnaryObj>(_op);
+            auto half = getHalfConversions(simd, op->getDType());
+            auto kernel = simdKernel(op->getOpType());
+            const uint16_t *x = op->getInputs(0)->getRawDataPtr<uint16_t *>();
+            uint16_t *y = op->getOutput()->getRawDataPtr<uint16_t *>();
+            forEachHalfBlock(op->getOutput()->size(), chunkSize,
+                             [&](size_t begin, size_t len)
+            {
+                float buf[halfBlockSize];
+                half.toF32(x + begin, buf, len);
+                kernel(buf, buf, len);
+                half.fromF32(buf, y + begin, len);
+            });
         }
 
         void compute(const Operator &_op,
@@ -52,31 +139,108 @@ namespace infini
                 break;
                 CASE(12); // DataType::UInt32
                 break;
+            case 10: // DataType::Float16
+            case 16: // DataType::BFloat16
+                doComputeHalf(_op);
+                break;
             default:
                 IT_TODO_HALT();
             }
         }
+
+        std::function<void()> prepare(const Operator &_op,
+                                      const RuntimeObj *context) const override
+        {
+            switch (_op->getDType().getIndex())
+            {
+            case 1: // DataType::Float32
+                return [args = resolve<float>(_op)] { execute(args); };
+            case 12: // DataType::UInt32
+                return [args = resolve<uint32_t>(_op)] { execute(args); };
+            default:
+                return Kernel::prepare(_op, context);
+            }
+        }
     };
 
     class Clip : public CpuKernelWithoutConfig
     {
+        const SimdKernels &simd = getSimdKernels();
+
+        static constexpr size_t chunkSize = 16384;
+
+        void doComputeHalf(const Operator &_op) const
+        {
+            auto op = as<ClipObj>(_op);
+            auto half = getHalfConversions(simd, op->getDType());
+            const float lo =
+                op->getMin().value_or(-std::numeric_limits<float>::infinity());
+            const float hi =
+                op->getMax().value_or(std::numeric_limits<float>::infinity());
+            const uint16_t *x = op->getInputs(0)->getRawDataPtr<uint16_t *>();
+            uint16_t *y = op->getOutput()->getRawDataPtr<uint16_t *>();
+            forEachHalfBlock(op->getOutput()->size(), chunkSize,
+                             [&](size_t begin, size_t len)
+            {
+                float buf[halfBlockSize];
+                half.toF32(x + begin, buf, len);
+                simd.clip(buf, buf, len, lo, hi);
+                half.fromF32(buf, y + begin, len);
+            });
+        }
+
         template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        static void clipCompute(const T *x, T *y, size_t n, float lo,
+                                float hi)
+        {
+            for (size_t i = 0; i < n; ++i)
+                y[i] = x[i] < lo ? T(lo) : x[i] > hi ? T(hi) : x[i];
+        }
+
+        // What a Float32 or UInt32 call needs, resolved from the op. A
+        // missing bound is an infinite one.
+        template <typename T>
+        struct Args
+        {
+            void (*kernel)(const T *, T *, size_t, float, float);
+            const T *x;
+            T *y;
+            size_t n;
+            float lo, hi;
+        };
+
+        template <typename T>
+        Args<T> resolve(const Operator &_op) const
         {
             auto op = as<ClipObj>(_op);
-            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
-            auto minValue = op->getMin();
-            auto maxValue = op->getMax();
+            void (*kernel)(const T *, T *, size_t, float, float);
+            if constexpr (std::is_same_v<T, float>)
+                kernel = simd.clip;
+            else
+                kernel = clipCompute<T>;
+            return {kernel, op->getInputs(0)->getRawDataPtr<T *>(),
+                    op->getOutput()->getRawDataPtr<T *>(),
+                    op->getOutput()->size(),
+                    op->getMin().value_or(
+                        -std::numeric_limits<float>::infinity()),
+                    op->getMax().value_or(
+                        std::numeric_limits<float>::infinity())};
+        }
 
-            auto n = op->getOutput()->size();
-            for (size_t offset = 0; offset < n; offset++)
+        template <typename T>
+        static void execute(const Args<T> &args)
+        {
+            parallelFor(args.n, chunkSize, [&](size_t begin, size_t end)
             {
-                auto val = *inptr++;
-                *outptr++ = (minValue && val < *minValue)   ? *minValue
-                            : (maxValue && val > *maxValue) ? *maxValue
-                                                            : val;
-            }
+                args.kernel(args.x + begin, args.y + begin, end - begin,
+                            args.lo, args.hi);
+            });
+        }
+
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            execute(resolve<T>(_op));
         }
 
         void compute(const Operator &_op,
@@ -93,13 +257,38 @@ namespace infini
                 break;
                 CASE(12); // DataType::UInt32
                 break;
+            case 10: // DataType::Float16
+            case 16: // DataType::BFloat16
+                doComputeHalf(_op);
+                break;
             default:
                 IT_TODO_HALT();
             }
         }
+
+        std::function<void()> prepare(const Operator &_op,
+                                      const RuntimeObj *context) const override
+        {
+            switch (_op->getDType().getIndex())
+            {
+            case 1: // DataType::Float32
+                return [args = resolve<float>(_op)] { execute(args); };
+            case 12: // DataType::UInt32
+                return [args = resolve<uint32_t>(_op)] { execute(args); };
+            default:
+                return Kernel::prepare(_op, context);
+            }
+        }
     };
 
     REGISTER_KERNEL(Device::CPU, OpType::Relu, NativeUnary, "reluNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Exp, NativeUnary, "expNative_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Sigmoid, NativeUnary,
+                    "sigmoidNative_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Tanh, NativeUnary, "tanhNative_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Gelu, NativeUnary, "geluNative_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Silu, NativeUnary, "siluNative_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Erf, NativeUnary, "erfNative_CPU");
     REGISTER_KERNEL(Device::CPU, OpType::Clip, Clip, "Clip_CPU");
 
 }; // namespace infini
@@ -0,0 +1,435 @@
+#include "kernels/cpu/simd_kernels.h"
+#include "kernels/cpu/simd_math.h"
+#include <cstring>
+#include <immintrin.h>
+
+// Built with -mavx2 -mfma -mf16c. Everything except the fill function has
+// internal linkage so that no AVX2 code can be picked up by the linker for
+// a baseline caller.
+namespace infini {
+
+namespace {
+
+// Each op has a float, a uint32_t and a scalar form so the same loops serve
+// both data types.
+struct AddOp {
+    __m256 operator()(__m256 a, __m256 b) const { return _mm256_add_ps(a, b); }
+    __m256i operator()(__m256i a, __m256i b) const {
+        return _mm256_add_epi32(a, b);
+    }
+    template <typename T> T operator()(T a, T b) const { return a + b; }
+};
+struct SubOp {
+    __m256 operator()(__m256 a, __m256 b) const { return _mm256_sub_ps(a, b); }
+    __m256i operator()(__m256i a, __m256i b) const {
+        return _mm256_sub_epi32(a, b);
+    }
+    template <typename T> T operator()(T a, T b) const { return a - b; }
+};
+struct MulOp {
+    __m256 operator()(__m256 a, __m256 b) const { return _mm256_mul_ps(a, b); }
+    __m256i operator()(__m256i a, __m256i b) const {
+        return _mm256_mullo_epi32(a, b);
+    }
+    template <typename T> T operator()(T a, T b) const { return a * b; }
+};
+struct DivOp {
+    __m256 operator()(__m256 a, __m256 b) const { return _mm256_div_ps(a, b); }
+    float operator()(float a, float b) const { return a / b; }
+};
+// Swaps the operands, for the scalar-op-vector loops.
+template <typename Op> struct Reversed {
+    template <typename V> V operator()(V a, V b) const { return Op()(b, a); }
+};
+
+inline __m256 load(const float *p) { return _mm256_loadu_ps(p); }
+inline __m256i load(const uint32_t *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+inline void store(float *p, __m256 v) { _mm256_storeu_ps(p, v); }
+inline void store(uint32_t *p, __m256i v) {
+    _mm256_storeu_si256((__m256i *)p, v);
+}
+inline __m256 broadcast(float v) { return _mm256_set1_ps(v); }
+inline __m256i broadcast(uint32_t v) { return _mm256_set1_epi32(int(v)); }
+
+template <typename T, typename Op>
+void binaryAvx2(const T *a, const T *b, T *c, size_t n) {
+    Op op;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        auto r0 = op(load(a + i), load(b + i));
+        auto r1 = op(load(a + i + 8), load(b + i + 8));
+        store(c + i, r0);
+        store(c + i + 8, r1);
+    }
+    for (; i < n; ++i)
+        c[i] = op(a[i], b[i]);
+}
+
+template <typename T, typename Op>
+void binaryScalarAvx2(const T *a, T b, T *c, size_t n) {
+    Op op;
+    const auto vb = broadcast(b);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        auto r0 = op(load(a + i), vb);
+        auto r1 = op(load(a + i + 8), vb);
+        store(c + i, r0);
+        store(c + i + 8, r1);
+    }
+    for (; i < n; ++i)
+        c[i] = op(a[i], b);
+}
+
+template <typename T, typename Op>
+constexpr BinaryKernels<T> binaryKernelsAvx2() {
+    return {binaryAvx2<T, Op>, binaryScalarAvx2<T, Op>,
+            binaryScalarAvx2<T, Reversed<Op>>};
+}
+
+void reluAvx2(const float *x, float *y, size_t n) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(y + i, _mm256_max_ps(_mm256_loadu_ps(x + i), zero));
+    for (; i < n; ++i)
+        y[i] = x[i] > 0.f ? x[i] : 0.f;
+}
+
+void clipAvx2(const float *x, float *y, size_t n, float lo, float hi) {
+    const __m256 vlo = _mm256_set1_ps(lo), vhi = _mm256_set1_ps(hi);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(
+            y + i, _mm256_min_ps(vhi, _mm256_max_ps(vlo, _mm256_loadu_ps(x + i))));
+    for (; i < n; ++i) {
+        float val = x[i];
+        y[i] = val < lo ? lo : val > hi ? hi : val;
+    }
+}
+
+// Vector abstraction for kernels/cpu/simd_math.h.
+struct Avx2Math {
+    using V = __m256;
+    using I = __m256i;
+    using M = __m256;
+    static constexpr size_t W = 8;
+    static V load(const float *p) { return _mm256_loadu_ps(p); }
+    static void store(float *p, V v) { _mm256_storeu_ps(p, v); }
+    static V set1(float v) { return _mm256_set1_ps(v); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V fma(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    static V highHalf(V a) {
+        return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-4096)));
+    }
+    static V copySign(V mag, V sgn) {
+        const V sign = _mm256_set1_ps(-0.f);
+        return _mm256_or_ps(_mm256_andnot_ps(sign, mag),
+                            _mm256_and_ps(sign, sgn));
+    }
+    static M lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static V select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+    static M isNan(V a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+    static M maskOr(M a, M b) { return _mm256_or_ps(a, b); }
+    static V round(V v) {
+        return _mm256_round_ps(v,
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    static I toInt(V v) { return _mm256_cvtps_epi32(v); }
+    static I halve(I i) { return _mm256_srai_epi32(i, 1); }
+    static I subInt(I a, I b) { return _mm256_sub_epi32(a, b); }
+    static V exp2Int(I i) {
+        return _mm256_castsi256_ps(
+            _mm256_slli_epi32(_mm256_add_epi32(i, _mm256_set1_epi32(127)), 23));
+    }
+};
+
+// Runs `body` on full blocks of W elements; the tail goes through a zero
+// padded stack buffer so that it takes the same vector code path.
+template <size_t W, typename From, typename To, typename Body>
+void convertLoop(const From *x, To *y, size_t n, Body body) {
+    size_t i = 0;
+    for (; i + W <= n; i += W)
+        body(x + i, y + i);
+    if (i < n) {
+        From in[W] = {};
+        To out[W];
+        std::memcpy(in, x + i, (n - i) * sizeof(From));
+        body(in, out);
+        std::memcpy(y + i, out, (n - i) * sizeof(To));
+    }
+}
+
+// F16C rounds to nearest even and handles subnormals, infinities and NaN
+// exactly like float_to_float16.
+void f32ToF16Avx2(const float *x, uint16_t *y, size_t n) {
+    convertLoop<16>(x, y, n, [](const float *src, uint16_t *dst) {
+        __m128i h0 = _mm256_cvtps_ph(_mm256_loadu_ps(src),
+                                     _MM_FROUND_TO_NEAREST_INT);
+        __m128i h1 = _mm256_cvtps_ph(_mm256_loadu_ps(src + 8),
+                                     _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i *)dst, h0);
+        _mm_storeu_si128((__m128i *)(dst + 8), h1);
+    });
+}
+
+void f16ToF32Avx2(const uint16_t *x, float *y, size_t n) {
+    convertLoop<16>(x, y, n, [](const uint16_t *src, float *dst) {
+        _mm256_storeu_ps(dst,
+                         _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)src)));
+        _mm256_storeu_ps(dst + 8, _mm256_cvtph_ps(_mm_loadu_si128(
+                                      (const __m128i *)(src + 8))));
+    });
+}
+
+// Round to nearest even on the upper 16 bits; NaN is quieted instead.
+inline __m256i bf16Round(__m256i w) {
+    __m256i nan =
+        _mm256_cmpgt_epi32(_mm256_and_si256(w, _mm256_set1_epi32(0x7fffffff)),
+                           _mm256_set1_epi32(0x7f800000));
+    __m256i hi = _mm256_srli_epi32(w, 16);
+    __m256i bias = _mm256_add_epi32(_mm256_set1_epi32(0x7fff),
+                                    _mm256_and_si256(hi, _mm256_set1_epi32(1)));
+    __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(w, bias), 16);
+    return _mm256_blendv_epi8(
+        rounded, _mm256_or_si256(hi, _mm256_set1_epi32(0x40)), nan);
+}
+
+void f32ToBf16Avx2(const float *x, uint16_t *y, size_t n) {
+    convertLoop<16>(x, y, n, [](const float *src, uint16_t *dst) {
+        __m256i r0 = bf16Round(_mm256_castps_si256(_mm256_loadu_ps(src)));
+        __m256i r1 = bf16Round(_mm256_castps_si256(_mm256_loadu_ps(src + 8)));
+        // packus works per 128-bit lane, the permute restores the order.
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(r0, r1),
+                                                  0xd8);
+        _mm256_storeu_si256((__m256i *)dst, packed);
+    });
+}
+
+void bf16ToF32Avx2(const uint16_t *x, float *y, size_t n) {
+    convertLoop<8>(x, y, n, [](const uint16_t *src, float *dst) {
+        __m256i h = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)src));
+        _mm256_storeu_ps(dst, _mm256_castsi256_ps(_mm256_slli_epi32(h, 16)));
+    });
+}
+
+void f32ToI32Avx2(const float *x, int32_t *y, size_t n) {
+    convertLoop<8>(x, y, n, [](const float *src, int32_t *dst) {
+        __m256 v = _mm256_loadu_ps(src);
+        // cvtt yields INT32_MIN for NaN and out of range values, which is
+        // already right for large negative inputs.
+        __m256i r = _mm256_cvttps_epi32(v);
+        __m256 tooLarge =
+            _mm256_cmp_ps(v, _mm256_set1_ps(2147483648.f), _CMP_GE_OQ);
+        r = _mm256_blendv_epi8(r, _mm256_set1_epi32(INT32_MAX),
+                               _mm256_castps_si256(tooLarge));
+        r = _mm256_and_si256(
+            r, _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_ORD_Q)));
+        _mm256_storeu_si256((__m256i *)dst, r);
+    });
+}
+
+void i32ToF32Avx2(const int32_t *x, float *y, size_t n) {
+    convertLoop<8>(x, y, n, [](const int32_t *src, float *dst) {
+        _mm256_storeu_ps(
+            dst, _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)src)));
+    });
+}
+
+// 8x8 tile of 32-bit elements; shuffles move the bits unchanged.
+inline void transposeTile(const uint32_t *src, size_t lds, uint32_t *dst,
+                          size_t ldd) {
+    __m256 r[8], t[8];
+    for (int k = 0; k < 8; ++k)
+        r[k] = _mm256_loadu_ps((const float *)(src + k * lds));
+    for (int k = 0; k < 8; k += 2) {
+        t[k] = _mm256_unpacklo_ps(r[k], r[k + 1]);
+        t[k + 1] = _mm256_unpackhi_ps(r[k], r[k + 1]);
+    }
+    for (int k = 0; k < 8; k += 4) {
+        r[k] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(1, 0, 1, 0));
+        r[k + 1] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(3, 2, 3, 2));
+        r[k + 2] =
+            _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(1, 0, 1, 0));
+        r[k + 3] =
+            _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int k = 0; k < 4; ++k) {
+        t[k] = _mm256_permute2f128_ps(r[k], r[k + 4], 0x20);
+        t[k + 4] = _mm256_permute2f128_ps(r[k], r[k + 4], 0x31);
+    }
+    for (int k = 0; k < 8; ++k)
+        _mm256_storeu_ps((float *)(dst + k * ldd), t[k]);
+}
+
+// Whole tiles go through registers, the right and bottom edges are copied
+// element by element.
+void transpose32Avx2(const uint32_t *src, size_t lds, uint32_t *dst,
+                     size_t ldd, size_t rows, size_t cols) {
+    size_t i = 0;
+    for (; i + 8 <= rows; i += 8) {
+        size_t j = 0;
+        for (; j + 8 <= cols; j += 8)
+            transposeTile(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+        for (; j < cols; ++j)
+            for (size_t k = 0; k < 8; ++k)
+                dst[j * ldd + i + k] = src[(i + k) * lds + j];
+    }
+    for (; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            dst[j * ldd + i] = src[i * lds + j];
+}
+
+// Copies up to the first 32-byte aligned destination address with memcpy,
+// streams whole vectors from there and copies the tail with memcpy again.
+void streamCopyAvx2(void *dst, const void *src, size_t bytes) {
+    auto d = static_cast<char *>(dst);
+    auto s = static_cast<const char *>(src);
+    size_t head = size_t(-uintptr_t(d) & 31);
+    head = head < bytes ? head : bytes;
+    std::memcpy(d, s, head);
+    size_t i = head;
+    for (; i + 128 <= bytes; i += 128) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)(s + i + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i *)(s + i + 64));
+        __m256i v3 = _mm256_loadu_si256((const __m256i *)(s + i + 96));
+        _mm256_stream_si256((__m256i *)(d + i), v0);
+        _mm256_stream_si256((__m256i *)(d + i + 32), v1);
+        _mm256_stream_si256((__m256i *)(d + i + 64), v2);
+        _mm256_stream_si256((__m256i *)(d + i + 96), v3);
+    }
+    for (; i + 32 <= bytes; i += 32)
+        _mm256_stream_si256((__m256i *)(d + i),
+                            _mm256_loadu_si256((const __m256i *)(s + i)));
+    std::memcpy(d + i, s + i, bytes - i);
+    _mm_sfence();
+}
+
+// 6x16 tile: 12 accumulators, 2 B vectors and 1 broadcast of the 16 YMM
+// registers, two FMAs per broadcast.
+void sgemmMicroKernelAvx2(int kc, const float *a, const float *b, float *C,
+                          int ldc, bool accumulate) {
+#define INIT(i)                                                                \
+    __m256 c##i##0 = _mm256_setzero_ps(), c##i##1 = _mm256_setzero_ps();
+#define STEP(i)                                                                \
+    {                                                                          \
+        __m256 ai = _mm256_broadcast_ss(a + i);                                \
+        c##i##0 = _mm256_fmadd_ps(ai, b0, c##i##0);                            \
+        c##i##1 = _mm256_fmadd_ps(ai, b1, c##i##1);                            \
+    }
+#define STORE(i)                                                               \
+    {                                                                          \
+        float *row = C + i * ldc;                                              \
+        if (accumulate) {                                                      \
+            c##i##0 = _mm256_add_ps(c##i##0, _mm256_loadu_ps(row));            \
+            c##i##1 = _mm256_add_ps(c##i##1, _mm256_loadu_ps(row + 8));        \
+        }                                                                      \
+        _mm256_storeu_ps(row, c##i##0);                                        \
+        _mm256_storeu_ps(row + 8, c##i##1);                                    \
+    }
+    INIT(0) INIT(1) INIT(2) INIT(3) INIT(4) INIT(5)
+    for (int p = 0; p < kc; ++p, a += 6, b += 16) {
+        __m256 b0 = _mm256_loadu_ps(b), b1 = _mm256_loadu_ps(b + 8);
+        STEP(0) STEP(1) STEP(2) STEP(3) STEP(4) STEP(5)
+    }
+    STORE(0) STORE(1) STORE(2) STORE(3) STORE(4) STORE(5)
+#undef INIT
+#undef STEP
+#undef STORE
+}
+
+// 6x8 int8 tile for hosts without VNNI. Each group of 4 bytes is widened to
+// 16 bits and multiplied pairwise with vpmaddwd, which is exact where
+// vpmaddubsw could saturate; the accumulators hold the sums of pairs and are
+// reduced to one value per column before the store.
+void u8s8gemmMicroKernelAvx2(int kq, const uint8_t *a, const int8_t *b,
+                             int32_t *C, int ldc, bool accumulate) {
+#define INIT(i)                                                                \
+    __m256i c##i##0 = _mm256_setzero_si256(), c##i##1 = _mm256_setzero_si256();
+#define STEP(i)                                                                \
+    {                                                                          \
+        int32_t ai;                                                            \
+        std::memcpy(&ai, a + 4 * i, 4);                                        \
+        __m256i aw = _mm256_cvtepu8_epi16(_mm_set1_epi32(ai));                 \
+        c##i##0 = _mm256_add_epi32(c##i##0, _mm256_madd_epi16(aw, b0));        \
+        c##i##1 = _mm256_add_epi32(c##i##1, _mm256_madd_epi16(aw, b1));        \
+    }
+// hadd leaves columns {0, 1, 4, 5 | 2, 3, 6, 7}; the permute restores order.
+#define STORE(i)                                                               \
+    {                                                                          \
+        int32_t *row = C + i * ldc;                                            \
+        __m256i ci = _mm256_permute4x64_epi64(                                 \
+            _mm256_hadd_epi32(c##i##0, c##i##1), 0xd8);                        \
+        if (accumulate)                                                        \
+            ci = _mm256_add_epi32(ci,                                          \
+                                  _mm256_loadu_si256((const __m256i *)row));   \
+        _mm256_storeu_si256((__m256i *)row, ci);                               \
+    }
+    INIT(0) INIT(1) INIT(2) INIT(3) INIT(4) INIT(5)
+    for (int q = 0; q < kq; ++q, a += 24, b += 32) {
+        __m256i bv = _mm256_loadu_si256((const __m256i *)b);
+        __m256i b0 = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(bv));
+        __m256i b1 = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(bv, 1));
+        STEP(0) STEP(1) STEP(2) STEP(3) STEP(4) STEP(5)
+    }
+    STORE(0) STORE(1) STORE(2) STORE(3) STORE(4) STORE(5)
+#undef INIT
+#undef STEP
+#undef STORE
+}
+
+} // namespace
+
+void fillSimdKernelsAvx2(SimdKernels &table) {
+    table.sgemm = {6, 16, sgemmMicroKernelAvx2};
+    table.u8s8gemm = {6, 8, u8s8gemmMicroKernelAvx2};
+    table.add = binaryKernelsAvx2<float, AddOp>();
+    table.sub = binaryKernelsAvx2<float, SubOp>();
+    table.mul = binaryKernelsAvx2<float, MulOp>();
+    table.div = binaryKernelsAvx2<float, DivOp>();
+    table.addU32 = binaryKernelsAvx2<uint32_t, AddOp>();
+    table.subU32 = binaryKernelsAvx2<uint32_t, SubOp>();
+    table.mulU32 = binaryKernelsAvx2<uint32_t, MulOp>();
+    table.relu = reluAvx2;
+    table.clip = clipAvx2;
+    table.f32ToF16 = f32ToF16Avx2;
+    table.f16ToF32 = f16ToF32Avx2;
+    table.f32ToBf16 = f32ToBf16Avx2;
+    table.bf16ToF32 = bf16ToF32Avx2;
+    table.f32ToI32 = f32ToI32Avx2;
+    table.i32ToF32 = i32ToF32Avx2;
+    table.transpose32 = transpose32Avx2;
+    table.streamCopy = streamCopyAvx2;
+    table.exp = simd_math::unaryLoop<Avx2Math, simd_math::exp<Avx2Math>>;
+    table.sigmoid =
+        simd_math::unaryLoop<Avx2Math, simd_math::sigmoid<Avx2Math>>;
+    table.tanh = simd_math::unaryLoop<Avx2Math, simd_math::tanh<Avx2Math>>;
+    table.gelu = simd_math::unaryLoop<Avx2Math, simd_math::gelu<Avx2Math>>;
+    table.silu = simd_math::unaryLoop<Avx2Math, simd_math::silu<Avx2Math>>;
+    table.erf = simd_math::unaryLoop<Avx2Math, simd_math::erf<Avx2Math>>;
+    table.reduceSum = {
+        simd_math::reduceAll<Avx2Math, simd_math::SumFold>,
+        simd_math::reduceAccumulate<Avx2Math, simd_math::SumFold>};
+    table.reduceMax = {
+        simd_math::reduceAll<Avx2Math, simd_math::MaxFold>,
+        simd_math::reduceAccumulate<Avx2Math, simd_math::MaxFold>};
+    table.reduceMin = {
+        simd_math::reduceAll<Avx2Math, simd_math::MinFold>,
+        simd_math::reduceAccumulate<Avx2Math, simd_math::MinFold>};
+    table.softmax = {simd_math::softmaxRow<Avx2Math>,
+                     simd_math::softmaxFoldColumns<Avx2Math>,
+                     simd_math::softmaxScaleColumns<Avx2Math>};
+    table.norm = {simd_math::meanVariance<Avx2Math>,
+                  simd_math::sumSquares<Avx2Math>,
+                  simd_math::normalizeRow<Avx2Math>};
+}
+
+} // namespace infini
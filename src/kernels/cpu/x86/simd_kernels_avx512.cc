@@ -0,0 +1,321 @@
+#include "kernels/cpu/simd_kernels.h"
+#include "kernels/cpu/simd_math.h"
+#include <immintrin.h>
+
+// GCC 12 reports the `_mm512_undefined_ps()` pass-through of the unmasked
+// AVX-512 intrinsics as (maybe-)uninitialized.
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+
+// Built with -mavx512f -mavx512bw -mavx512dq -mavx512vl -mfma -mf16c.
+// Everything except the fill function has internal linkage so that no
+// AVX-512 code can be picked up by the linker for a baseline caller.
+namespace infini {
+
+namespace {
+
+// Each op has a float and a uint32_t form so the same loops serve both data
+// types.
+struct AddOp {
+    __m512 operator()(__m512 a, __m512 b) const { return _mm512_add_ps(a, b); }
+    __m512i operator()(__m512i a, __m512i b) const {
+        return _mm512_add_epi32(a, b);
+    }
+};
+struct SubOp {
+    __m512 operator()(__m512 a, __m512 b) const { return _mm512_sub_ps(a, b); }
+    __m512i operator()(__m512i a, __m512i b) const {
+        return _mm512_sub_epi32(a, b);
+    }
+};
+struct MulOp {
+    __m512 operator()(__m512 a, __m512 b) const { return _mm512_mul_ps(a, b); }
+    __m512i operator()(__m512i a, __m512i b) const {
+        return _mm512_mullo_epi32(a, b);
+    }
+};
+struct DivOp {
+    __m512 operator()(__m512 a, __m512 b) const { return _mm512_div_ps(a, b); }
+};
+// Swaps the operands, for the scalar-op-vector loops.
+template <typename Op> struct Reversed {
+    template <typename V> V operator()(V a, V b) const { return Op()(b, a); }
+};
+
+inline __mmask16 tailMask(size_t rest) {
+    return rest >= 16 ? __mmask16(0xffff) : __mmask16((1u << rest) - 1);
+}
+
+inline __m512 load(const float *p) { return _mm512_loadu_ps(p); }
+inline __m512i load(const uint32_t *p) { return _mm512_loadu_si512(p); }
+// Masked-off float lanes are 1 so that a divisor cannot raise.
+inline __m512 loadMasked(__mmask16 k, const float *p) {
+    return _mm512_mask_loadu_ps(_mm512_set1_ps(1.f), k, p);
+}
+inline __m512i loadMasked(__mmask16 k, const uint32_t *p) {
+    return _mm512_maskz_loadu_epi32(k, p);
+}
+inline void store(float *p, __m512 v) { _mm512_storeu_ps(p, v); }
+inline void store(uint32_t *p, __m512i v) { _mm512_storeu_si512(p, v); }
+inline void storeMasked(float *p, __mmask16 k, __m512 v) {
+    _mm512_mask_storeu_ps(p, k, v);
+}
+inline void storeMasked(uint32_t *p, __mmask16 k, __m512i v) {
+    _mm512_mask_storeu_epi32(p, k, v);
+}
+inline __m512 broadcast(float v) { return _mm512_set1_ps(v); }
+inline __m512i broadcast(uint32_t v) { return _mm512_set1_epi32(int(v)); }
+
+// The tail is handled with a masked load/store instead of a scalar loop.
+template <typename T, typename Op>
+void binaryAvx512(const T *a, const T *b, T *c, size_t n) {
+    Op op;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto r0 = op(load(a + i), load(b + i));
+        auto r1 = op(load(a + i + 16), load(b + i + 16));
+        store(c + i, r0);
+        store(c + i + 16, r1);
+    }
+    for (; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        storeMasked(c + i, k, op(loadMasked(k, a + i), loadMasked(k, b + i)));
+    }
+}
+
+template <typename T, typename Op>
+void binaryScalarAvx512(const T *a, T b, T *c, size_t n) {
+    Op op;
+    const auto vb = broadcast(b);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto r0 = op(load(a + i), vb);
+        auto r1 = op(load(a + i + 16), vb);
+        store(c + i, r0);
+        store(c + i + 16, r1);
+    }
+    for (; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        storeMasked(c + i, k, op(loadMasked(k, a + i), vb));
+    }
+}
+
+template <typename T, typename Op>
+constexpr BinaryKernels<T> binaryKernelsAvx512() {
+    return {binaryAvx512<T, Op>, binaryScalarAvx512<T, Op>,
+            binaryScalarAvx512<T, Reversed<Op>>};
+}
+
+void reluAvx512(const float *x, float *y, size_t n) {
+    const __m512 zero = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        __m512 v = _mm512_maskz_loadu_ps(k, x + i);
+        _mm512_mask_storeu_ps(y + i, k, _mm512_max_ps(v, zero));
+    }
+}
+
+void clipAvx512(const float *x, float *y, size_t n, float lo, float hi) {
+    const __m512 vlo = _mm512_set1_ps(lo), vhi = _mm512_set1_ps(hi);
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        __m512 v = _mm512_maskz_loadu_ps(k, x + i);
+        _mm512_mask_storeu_ps(y + i, k,
+                              _mm512_min_ps(vhi, _mm512_max_ps(vlo, v)));
+    }
+}
+
+// Vector abstraction for kernels/cpu/simd_math.h.
+struct Avx512Math {
+    using V = __m512;
+    using I = __m512i;
+    using M = __mmask16;
+    static constexpr size_t W = 16;
+    static V load(const float *p) { return _mm512_loadu_ps(p); }
+    static void store(float *p, V v) { _mm512_storeu_ps(p, v); }
+    static V set1(float v) { return _mm512_set1_ps(v); }
+    static V add(V a, V b) { return _mm512_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm512_div_ps(a, b); }
+    static V fma(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+    static V min(V a, V b) { return _mm512_min_ps(a, b); }
+    static V max(V a, V b) { return _mm512_max_ps(a, b); }
+    static V abs(V a) { return _mm512_abs_ps(a); }
+    static V highHalf(V a) {
+        return _mm512_castsi512_ps(_mm512_and_si512(
+            _mm512_castps_si512(a), _mm512_set1_epi32(-4096)));
+    }
+    static V copySign(V mag, V sgn) {
+        const __m512i sign = _mm512_set1_epi32(int(0x80000000u));
+        return _mm512_castsi512_ps(_mm512_ternarylogic_epi32(
+            sign, _mm512_castps_si512(mag), _mm512_castps_si512(sgn), 0xac));
+    }
+    static M lt(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static V select(M m, V a, V b) { return _mm512_mask_blend_ps(m, b, a); }
+    static M isNan(V a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+    static M maskOr(M a, M b) { return _kor_mask16(a, b); }
+    static V round(V v) {
+        return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEAREST_INT |
+                                           _MM_FROUND_NO_EXC);
+    }
+    static I toInt(V v) { return _mm512_cvtps_epi32(v); }
+    static I halve(I i) { return _mm512_srai_epi32(i, 1); }
+    static I subInt(I a, I b) { return _mm512_sub_epi32(a, b); }
+    static V exp2Int(I i) {
+        return _mm512_castsi512_ps(
+            _mm512_slli_epi32(_mm512_add_epi32(i, _mm512_set1_epi32(127)), 23));
+    }
+};
+
+void f32ToF16Avx512(const float *x, uint16_t *y, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        __m256i h = _mm512_cvtps_ph(_mm512_maskz_loadu_ps(k, x + i),
+                                    _MM_FROUND_TO_NEAREST_INT);
+        _mm256_mask_storeu_epi16(y + i, k, h);
+    }
+}
+
+void f16ToF32Avx512(const uint16_t *x, float *y, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        __m512 v = _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(k, x + i));
+        _mm512_mask_storeu_ps(y + i, k, v);
+    }
+}
+
+// Integer round to nearest even rather than VCVTNEPS2BF16, which flushes
+// subnormals and would not match the other ISA levels.
+void f32ToBf16Avx512(const float *x, uint16_t *y, size_t n) {
+    const __m512i absMask = _mm512_set1_epi32(0x7fffffff),
+                  inf = _mm512_set1_epi32(0x7f800000),
+                  round = _mm512_set1_epi32(0x7fff),
+                  one = _mm512_set1_epi32(1), quiet = _mm512_set1_epi32(0x40);
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        __m512i w = _mm512_castps_si512(_mm512_maskz_loadu_ps(k, x + i));
+        __mmask16 nan = _mm512_cmpgt_epi32_mask(_mm512_and_si512(w, absMask),
+                                                inf);
+        __m512i hi = _mm512_srli_epi32(w, 16);
+        __m512i bias = _mm512_add_epi32(round, _mm512_and_si512(hi, one));
+        __m512i rounded = _mm512_srli_epi32(_mm512_add_epi32(w, bias), 16);
+        rounded = _mm512_mask_blend_epi32(nan, rounded,
+                                          _mm512_or_si512(hi, quiet));
+        _mm256_mask_storeu_epi16(y + i, k, _mm512_cvtepi32_epi16(rounded));
+    }
+}
+
+void bf16ToF32Avx512(const uint16_t *x, float *y, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        __m512i h = _mm512_cvtepu16_epi32(_mm256_maskz_loadu_epi16(k, x + i));
+        _mm512_mask_storeu_ps(y + i, k,
+                              _mm512_castsi512_ps(_mm512_slli_epi32(h, 16)));
+    }
+}
+
+void f32ToI32Avx512(const float *x, int32_t *y, size_t n) {
+    const __m512 limit = _mm512_set1_ps(2147483648.f);
+    const __m512i maxInt = _mm512_set1_epi32(INT32_MAX);
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        __m512 v = _mm512_maskz_loadu_ps(k, x + i);
+        // cvtt yields INT32_MIN for NaN and out of range values, which is
+        // already right for large negative inputs.
+        __m512i r = _mm512_cvttps_epi32(v);
+        r = _mm512_mask_mov_epi32(r, _mm512_cmp_ps_mask(v, limit, _CMP_GE_OQ),
+                                  maxInt);
+        r = _mm512_maskz_mov_epi32(_mm512_cmp_ps_mask(v, v, _CMP_ORD_Q), r);
+        _mm512_mask_storeu_epi32(y + i, k, r);
+    }
+}
+
+void i32ToF32Avx512(const int32_t *x, float *y, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = tailMask(n - i);
+        __m512i v = _mm512_maskz_loadu_epi32(k, x + i);
+        _mm512_mask_storeu_ps(y + i, k, _mm512_cvtepi32_ps(v));
+    }
+}
+
+// 12x32 tile: 24 accumulators, 2 B vectors and 1 broadcast of the 32 ZMM
+// registers.
+void sgemmMicroKernelAvx512(int kc, const float *a, const float *b, float *C,
+                            int ldc, bool accumulate) {
+#define INIT(i)                                                                \
+    __m512 c##i##0 = _mm512_setzero_ps(), c##i##1 = _mm512_setzero_ps();
+#define STEP(i)                                                                \
+    {                                                                          \
+        __m512 ai = _mm512_set1_ps(a[i]);                                      \
+        c##i##0 = _mm512_fmadd_ps(ai, b0, c##i##0);                            \
+        c##i##1 = _mm512_fmadd_ps(ai, b1, c##i##1);                            \
+    }
+#define STORE(i)                                                               \
+    {                                                                          \
+        float *row = C + i * ldc;                                              \
+        if (accumulate) {                                                      \
+            c##i##0 = _mm512_add_ps(c##i##0, _mm512_loadu_ps(row));            \
+            c##i##1 = _mm512_add_ps(c##i##1, _mm512_loadu_ps(row + 16));       \
+        }                                                                      \
+        _mm512_storeu_ps(row, c##i##0);                                        \
+        _mm512_storeu_ps(row + 16, c##i##1);                                   \
+    }
+    INIT(0) INIT(1) INIT(2) INIT(3) INIT(4) INIT(5)
+    INIT(6) INIT(7) INIT(8) INIT(9) INIT(10) INIT(11)
+    for (int p = 0; p < kc; ++p, a += 12, b += 32) {
+        __m512 b0 = _mm512_loadu_ps(b), b1 = _mm512_loadu_ps(b + 16);
+        STEP(0) STEP(1) STEP(2) STEP(3) STEP(4) STEP(5)
+        STEP(6) STEP(7) STEP(8) STEP(9) STEP(10) STEP(11)
+    }
+    STORE(0) STORE(1) STORE(2) STORE(3) STORE(4) STORE(5)
+    STORE(6) STORE(7) STORE(8) STORE(9) STORE(10) STORE(11)
+#undef INIT
+#undef STEP
+#undef STORE
+}
+
+} // namespace
+
+void fillSimdKernelsAvx512(SimdKernels &table) {
+    table.sgemm = {12, 32, sgemmMicroKernelAvx512};
+    table.add = binaryKernelsAvx512<float, AddOp>();
+    table.sub = binaryKernelsAvx512<float, SubOp>();
+    table.mul = binaryKernelsAvx512<float, MulOp>();
+    table.div = binaryKernelsAvx512<float, DivOp>();
+    table.addU32 = binaryKernelsAvx512<uint32_t, AddOp>();
+    table.subU32 = binaryKernelsAvx512<uint32_t, SubOp>();
+    table.mulU32 = binaryKernelsAvx512<uint32_t, MulOp>();
+    table.relu = reluAvx512;
+    table.clip = clipAvx512;
+    table.f32ToF16 = f32ToF16Avx512;
+    table.f16ToF32 = f16ToF32Avx512;
+    table.f32ToBf16 = f32ToBf16Avx512;
+    table.bf16ToF32 = bf16ToF32Avx512;
+    table.f32ToI32 = f32ToI32Avx512;
+    table.i32ToF32 = i32ToF32Avx512;
+    table.exp = simd_math::unaryLoop<Avx512Math, simd_math::exp<Avx512Math>>;
+    table.sigmoid =
+        simd_math::unaryLoop<Avx512Math, simd_math::sigmoid<Avx512Math>>;
+    table.tanh = simd_math::unaryLoop<Avx512Math, simd_math::tanh<Avx512Math>>;
+    table.gelu = simd_math::unaryLoop<Avx512Math, simd_math::gelu<Avx512Math>>;
+    table.silu = simd_math::unaryLoop<Avx512Math, simd_math::silu<Avx512Math>>;
+    table.erf = simd_math::unaryLoop<Avx512Math, simd_math::erf<Avx512Math>>;
+    table.reduceSum = {
+        simd_math::reduceAll<Avx512Math, simd_math::SumFold>,
+        simd_math::reduceAccumulate<Avx512Math, simd_math::SumFold>};
+    table.reduceMax = {
+        simd_math::reduceAll<Avx512Math, simd_math::MaxFold>,
+        simd_math::reduceAccumulate<Avx512Math, simd_math::MaxFold>};
+    table.reduceMin = {
+        simd_math::reduceAll<Avx512Math, simd_math::MinFold>,
+        simd_math::reduceAccumulate<Avx512Math, simd_math::MinFold>};
+    table.softmax = {simd_math::softmaxRow<Avx512Math>,
+                     simd_math::softmaxFoldColumns<Avx512Math>,
+                     simd_math::softmaxScaleColumns<Avx512Math>};
+    table.norm = {simd_math::meanVariance<Avx512Math>,
+                  simd_math::sumSquares<Avx512Math>,
+                  simd_math::normalizeRow<Avx512Math>};
+}
+
+} // namespace infini
@@ -0,0 +1,62 @@
+#include "kernels/cpu/simd_kernels.h"
+#include <cstring>
+#include <immintrin.h>
+
+// GCC 12 reports the `_mm512_undefined_epi32()` pass-through of the unmasked
+// AVX-512 intrinsics as (maybe-)uninitialized.
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+
+// Built with the AVX-512 flags plus -mavx512vnni. Everything except the fill
+// function has internal linkage so that no VNNI code can be picked up by the
+// linker for a caller on a host without it.
+namespace infini {
+
+namespace {
+
+// 12x32 int8 tile: 24 accumulators, 2 B vectors and 1 broadcast of the 32
+// ZMM registers. vpdpbusd adds the 4 products of one k group to each int32
+// lane.
+void u8s8gemmMicroKernelAvx512Vnni(int kq, const uint8_t *a, const int8_t *b,
+                                   int32_t *C, int ldc, bool accumulate) {
+#define INIT(i)                                                                \
+    __m512i c##i##0 = _mm512_setzero_si512(), c##i##1 = _mm512_setzero_si512();
+#define STEP(i)                                                                \
+    {                                                                          \
+        int32_t ai;                                                            \
+        std::memcpy(&ai, a + 4 * i, 4);                                        \
+        __m512i av = _mm512_set1_epi32(ai);                                    \
+        c##i##0 = _mm512_dpbusd_epi32(c##i##0, av, b0);                        \
+        c##i##1 = _mm512_dpbusd_epi32(c##i##1, av, b1);                        \
+    }
+#define STORE(i)                                                               \
+    {                                                                          \
+        int32_t *row = C + i * ldc;                                            \
+        if (accumulate) {                                                      \
+            c##i##0 = _mm512_add_epi32(c##i##0, _mm512_loadu_si512(row));      \
+            c##i##1 = _mm512_add_epi32(c##i##1, _mm512_loadu_si512(row + 16)); \
+        }                                                                      \
+        _mm512_storeu_si512(row, c##i##0);                                     \
+        _mm512_storeu_si512(row + 16, c##i##1);                                \
+    }
+    INIT(0) INIT(1) INIT(2) INIT(3) INIT(4) INIT(5)
+    INIT(6) INIT(7) INIT(8) INIT(9) INIT(10) INIT(11)
+    for (int q = 0; q < kq; ++q, a += 48, b += 128) {
+        __m512i b0 = _mm512_loadu_si512(b), b1 = _mm512_loadu_si512(b + 64);
+        STEP(0) STEP(1) STEP(2) STEP(3) STEP(4) STEP(5)
+        STEP(6) STEP(7) STEP(8) STEP(9) STEP(10) STEP(11)
+    }
+    STORE(0) STORE(1) STORE(2) STORE(3) STORE(4) STORE(5)
+    STORE(6) STORE(7) STORE(8) STORE(9) STORE(10) STORE(11)
+#undef INIT
+#undef STEP
+#undef STORE
+}
+
+} // namespace
+
+void fillSimdKernelsAvx512Vnni(SimdKernels &table) {
+    table.u8s8gemm = {12, 32, u8s8gemmMicroKernelAvx512Vnni};
+}
+
+} // namespace infini
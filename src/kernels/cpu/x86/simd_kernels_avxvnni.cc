@@ -0,0 +1,54 @@
+#include "kernels/cpu/simd_kernels.h"
+#include <cstring>
+#include <immintrin.h>
+
+// Built with -mavx2 -mfma -mf16c -mavxvnni. Everything except the fill
+// function has internal linkage so that no VNNI code can be picked up by the
+// linker for a caller on a host without it.
+namespace infini {
+
+namespace {
+
+// 6x16 int8 tile: 12 accumulators, 2 B vectors and 1 broadcast of the 16 YMM
+// registers. vpdpbusd adds the 4 products of one k group to each int32 lane.
+void u8s8gemmMicroKernelAvxVnni(int kq, const uint8_t *a, const int8_t *b,
+                                int32_t *C, int ldc, bool accumulate) {
+#define INIT(i)                                                                \
+    __m256i c##i##0 = _mm256_setzero_si256(), c##i##1 = _mm256_setzero_si256();
+#define STEP(i)                                                                \
+    {                                                                          \
+        int32_t ai;                                                            \
+        std::memcpy(&ai, a + 4 * i, 4);                                        \
+        __m256i av = _mm256_set1_epi32(ai);                                    \
+        c##i##0 = _mm256_dpbusd_avx_epi32(c##i##0, av, b0);                    \
+        c##i##1 = _mm256_dpbusd_avx_epi32(c##i##1, av, b1);                    \
+    }
+#define STORE(i)                                                               \
+    {                                                                          \
+        __m256i *row = (__m256i *)(C + i * ldc);                               \
+        if (accumulate) {                                                      \
+            c##i##0 = _mm256_add_epi32(c##i##0, _mm256_loadu_si256(row));      \
+            c##i##1 = _mm256_add_epi32(c##i##1, _mm256_loadu_si256(row + 1));  \
+        }                                                                      \
+        _mm256_storeu_si256(row, c##i##0);                                     \
+        _mm256_storeu_si256(row + 1, c##i##1);                                 \
+    }
+    INIT(0) INIT(1) INIT(2) INIT(3) INIT(4) INIT(5)
+    for (int q = 0; q < kq; ++q, a += 24, b += 64) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)b);
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(b + 32));
+        STEP(0) STEP(1) STEP(2) STEP(3) STEP(4) STEP(5)
+    }
+    STORE(0) STORE(1) STORE(2) STORE(3) STORE(4) STORE(5)
+#undef INIT
+#undef STEP
+#undef STORE
+}
+
+} // namespace
+
+void fillSimdKernelsAvxVnni(SimdKernels &table) {
+    table.u8s8gemm = {6, 16, u8s8gemmMicroKernelAvxVnni};
+}
+
+} // namespace infini
@@ -0,0 +1,325 @@
+#include "kernels/cpu/simd_kernels.h"
+#include "kernels/cpu/simd_math.h"
+#include <cstring>
+#include <immintrin.h>
+
+// Built with -msse4.1 -msse4.2. Everything except the fill function has
+// internal linkage so that no SSE4 code can be picked up by the linker for
+// a baseline caller.
+namespace infini {
+
+namespace {
+
+// Each op has a float, a uint32_t and a scalar form so the same loops serve
+// both data types.
+struct AddOp {
+    __m128 operator()(__m128 a, __m128 b) const { return _mm_add_ps(a, b); }
+    __m128i operator()(__m128i a, __m128i b) const {
+        return _mm_add_epi32(a, b);
+    }
+    template <typename T> T operator()(T a, T b) const { return a + b; }
+};
+struct SubOp {
+    __m128 operator()(__m128 a, __m128 b) const { return _mm_sub_ps(a, b); }
+    __m128i operator()(__m128i a, __m128i b) const {
+        return _mm_sub_epi32(a, b);
+    }
+    template <typename T> T operator()(T a, T b) const { return a - b; }
+};
+struct MulOp {
+    __m128 operator()(__m128 a, __m128 b) const { return _mm_mul_ps(a, b); }
+    __m128i operator()(__m128i a, __m128i b) const {
+        return _mm_mullo_epi32(a, b);
+    }
+    template <typename T> T operator()(T a, T b) const { return a * b; }
+};
+struct DivOp {
+    __m128 operator()(__m128 a, __m128 b) const { return _mm_div_ps(a, b); }
+    float operator()(float a, float b) const { return a / b; }
+};
+// Swaps the operands, for the scalar-op-vector loops.
+template <typename Op> struct Reversed {
+    template <typename V> V operator()(V a, V b) const { return Op()(b, a); }
+};
+
+inline __m128 load(const float *p) { return _mm_loadu_ps(p); }
+inline __m128i load(const uint32_t *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+}
+inline void store(float *p, __m128 v) { _mm_storeu_ps(p, v); }
+inline void store(uint32_t *p, __m128i v) {
+    _mm_storeu_si128((__m128i *)p, v);
+}
+inline __m128 broadcast(float v) { return _mm_set1_ps(v); }
+inline __m128i broadcast(uint32_t v) { return _mm_set1_epi32(int(v)); }
+
+template <typename T, typename Op>
+void binarySse4(const T *a, const T *b, T *c, size_t n) {
+    Op op;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        auto r0 = op(load(a + i), load(b + i));
+        auto r1 = op(load(a + i + 4), load(b + i + 4));
+        store(c + i, r0);
+        store(c + i + 4, r1);
+    }
+    for (; i < n; ++i)
+        c[i] = op(a[i], b[i]);
+}
+
+template <typename T, typename Op>
+void binaryScalarSse4(const T *a, T b, T *c, size_t n) {
+    Op op;
+    const auto vb = broadcast(b);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        auto r0 = op(load(a + i), vb);
+        auto r1 = op(load(a + i + 4), vb);
+        store(c + i, r0);
+        store(c + i + 4, r1);
+    }
+    for (; i < n; ++i)
+        c[i] = op(a[i], b);
+}
+
+template <typename T, typename Op>
+constexpr BinaryKernels<T> binaryKernelsSse4() {
+    return {binarySse4<T, Op>, binaryScalarSse4<T, Op>,
+            binaryScalarSse4<T, Reversed<Op>>};
+}
+
+void reluSse4(const float *x, float *y, size_t n) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(y + i, _mm_max_ps(_mm_loadu_ps(x + i), zero));
+    for (; i < n; ++i)
+        y[i] = x[i] > 0.f ? x[i] : 0.f;
+}
+
+// max/min return their second operand on NaN, so a NaN input passes
+// through unchanged like in the scalar kernel.
+void clipSse4(const float *x, float *y, size_t n, float lo, float hi) {
+    const __m128 vlo = _mm_set1_ps(lo), vhi = _mm_set1_ps(hi);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(y + i,
+                      _mm_min_ps(vhi, _mm_max_ps(vlo, _mm_loadu_ps(x + i))));
+    for (; i < n; ++i) {
+        float val = x[i];
+        y[i] = val < lo ? lo : val > hi ? hi : val;
+    }
+}
+
+// Vector abstraction for kernels/cpu/simd_math.h. SSE4 has no FMA, so fma
+// rounds twice.
+struct Sse4Math {
+    using V = __m128;
+    using I = __m128i;
+    using M = __m128;
+    static constexpr size_t W = 4;
+    static V load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, V v) { _mm_storeu_ps(p, v); }
+    static V set1(float v) { return _mm_set1_ps(v); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    static V fma(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+    static V abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    static V highHalf(V a) {
+        return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-4096)));
+    }
+    static V copySign(V mag, V sgn) {
+        const V sign = _mm_set1_ps(-0.f);
+        return _mm_or_ps(_mm_andnot_ps(sign, mag), _mm_and_ps(sign, sgn));
+    }
+    static M lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static V select(M m, V a, V b) { return _mm_blendv_ps(b, a, m); }
+    static M isNan(V a) { return _mm_cmpunord_ps(a, a); }
+    static M maskOr(M a, M b) { return _mm_or_ps(a, b); }
+    static V round(V v) {
+        return _mm_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    static I toInt(V v) { return _mm_cvtps_epi32(v); }
+    static I halve(I i) { return _mm_srai_epi32(i, 1); }
+    static I subInt(I a, I b) { return _mm_sub_epi32(a, b); }
+    static V exp2Int(I i) {
+        return _mm_castsi128_ps(
+            _mm_slli_epi32(_mm_add_epi32(i, _mm_set1_epi32(127)), 23));
+    }
+};
+
+// Runs `body` on full blocks of W elements; the tail goes through a zero
+// padded stack buffer so that it takes the same vector code path.
+template <size_t W, typename From, typename To, typename Body>
+void convertLoop(const From *x, To *y, size_t n, Body body) {
+    size_t i = 0;
+    for (; i + W <= n; i += W)
+        body(x + i, y + i);
+    if (i < n) {
+        From in[W] = {};
+        To out[W];
+        std::memcpy(in, x + i, (n - i) * sizeof(From));
+        body(in, out);
+        std::memcpy(y + i, out, (n - i) * sizeof(To));
+    }
+}
+
+// Round to nearest even on the upper 16 bits; NaN is quieted instead.
+inline __m128i bf16Round(__m128i w) {
+    __m128i nan = _mm_cmpgt_epi32(_mm_and_si128(w, _mm_set1_epi32(0x7fffffff)),
+                                  _mm_set1_epi32(0x7f800000));
+    __m128i hi = _mm_srli_epi32(w, 16);
+    __m128i bias = _mm_add_epi32(_mm_set1_epi32(0x7fff),
+                                 _mm_and_si128(hi, _mm_set1_epi32(1)));
+    __m128i rounded = _mm_srli_epi32(_mm_add_epi32(w, bias), 16);
+    return _mm_blendv_epi8(rounded, _mm_or_si128(hi, _mm_set1_epi32(0x40)),
+                           nan);
+}
+
+void f32ToBf16Sse4(const float *x, uint16_t *y, size_t n) {
+    convertLoop<8>(x, y, n, [](const float *src, uint16_t *dst) {
+        __m128i r0 = bf16Round(_mm_castps_si128(_mm_loadu_ps(src)));
+        __m128i r1 = bf16Round(_mm_castps_si128(_mm_loadu_ps(src + 4)));
+        _mm_storeu_si128((__m128i *)dst, _mm_packus_epi32(r0, r1));
+    });
+}
+
+void bf16ToF32Sse4(const uint16_t *x, float *y, size_t n) {
+    convertLoop<4>(x, y, n, [](const uint16_t *src, float *dst) {
+        __m128i h = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)src));
+        _mm_storeu_ps(dst, _mm_castsi128_ps(_mm_slli_epi32(h, 16)));
+    });
+}
+
+void f32ToI32Sse4(const float *x, int32_t *y, size_t n) {
+    convertLoop<4>(x, y, n, [](const float *src, int32_t *dst) {
+        __m128 v = _mm_loadu_ps(src);
+        // cvtt yields INT32_MIN for NaN and out of range values, which is
+        // already right for large negative inputs.
+        __m128i r = _mm_cvttps_epi32(v);
+        __m128 tooLarge = _mm_cmpge_ps(v, _mm_set1_ps(2147483648.f));
+        r = _mm_blendv_epi8(r, _mm_set1_epi32(INT32_MAX),
+                            _mm_castps_si128(tooLarge));
+        r = _mm_and_si128(r, _mm_castps_si128(_mm_cmpord_ps(v, v)));
+        _mm_storeu_si128((__m128i *)dst, r);
+    });
+}
+
+void i32ToF32Sse4(const int32_t *x, float *y, size_t n) {
+    convertLoop<4>(x, y, n, [](const int32_t *src, float *dst) {
+        _mm_storeu_ps(dst,
+                      _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)src)));
+    });
+}
+
+// 4x4 tile of 32-bit elements; shuffles move the bits unchanged.
+inline void transposeTile(const uint32_t *src, size_t lds, uint32_t *dst,
+                          size_t ldd) {
+    __m128 r0 = _mm_loadu_ps((const float *)src);
+    __m128 r1 = _mm_loadu_ps((const float *)(src + lds));
+    __m128 r2 = _mm_loadu_ps((const float *)(src + 2 * lds));
+    __m128 r3 = _mm_loadu_ps((const float *)(src + 3 * lds));
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps((float *)dst, r0);
+    _mm_storeu_ps((float *)(dst + ldd), r1);
+    _mm_storeu_ps((float *)(dst + 2 * ldd), r2);
+    _mm_storeu_ps((float *)(dst + 3 * ldd), r3);
+}
+
+// Whole tiles go through registers, the right and bottom edges are copied
+// element by element.
+void transpose32Sse4(const uint32_t *src, size_t lds, uint32_t *dst,
+                     size_t ldd, size_t rows, size_t cols) {
+    size_t i = 0;
+    for (; i + 4 <= rows; i += 4) {
+        size_t j = 0;
+        for (; j + 4 <= cols; j += 4)
+            transposeTile(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+        for (; j < cols; ++j)
+            for (size_t k = 0; k < 4; ++k)
+                dst[j * ldd + i + k] = src[(i + k) * lds + j];
+    }
+    for (; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            dst[j * ldd + i] = src[i * lds + j];
+}
+
+// 6x8 tile: 12 accumulators, 2 B vectors and 1 broadcast of the 16 XMM
+// registers.
+void sgemmMicroKernelSse4(int kc, const float *a, const float *b, float *C,
+                          int ldc, bool accumulate) {
+#define INIT(i) __m128 c##i##0 = _mm_setzero_ps(), c##i##1 = _mm_setzero_ps();
+#define STEP(i)                                                                \
+    {                                                                          \
+        __m128 ai = _mm_set1_ps(a[i]);                                         \
+        c##i##0 = _mm_add_ps(c##i##0, _mm_mul_ps(ai, b0));                     \
+        c##i##1 = _mm_add_ps(c##i##1, _mm_mul_ps(ai, b1));                     \
+    }
+#define STORE(i)                                                               \
+    {                                                                          \
+        float *row = C + i * ldc;                                              \
+        if (accumulate) {                                                      \
+            c##i##0 = _mm_add_ps(c##i##0, _mm_loadu_ps(row));                  \
+            c##i##1 = _mm_add_ps(c##i##1, _mm_loadu_ps(row + 4));              \
+        }                                                                      \
+        _mm_storeu_ps(row, c##i##0);                                           \
+        _mm_storeu_ps(row + 4, c##i##1);                                       \
+    }
+    INIT(0) INIT(1) INIT(2) INIT(3) INIT(4) INIT(5)
+    for (int p = 0; p < kc; ++p, a += 6, b += 8) {
+        __m128 b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4);
+        STEP(0) STEP(1) STEP(2) STEP(3) STEP(4) STEP(5)
+    }
+    STORE(0) STORE(1) STORE(2) STORE(3) STORE(4) STORE(5)
+#undef INIT
+#undef STEP
+#undef STORE
+}
+
+} // namespace
+
+void fillSimdKernelsSse4(SimdKernels &table) {
+    table.sgemm = {6, 8, sgemmMicroKernelSse4};
+    table.add = binaryKernelsSse4<float, AddOp>();
+    table.sub = binaryKernelsSse4<float, SubOp>();
+    table.mul = binaryKernelsSse4<float, MulOp>();
+    table.div = binaryKernelsSse4<float, DivOp>();
+    table.addU32 = binaryKernelsSse4<uint32_t, AddOp>();
+    table.subU32 = binaryKernelsSse4<uint32_t, SubOp>();
+    table.mulU32 = binaryKernelsSse4<uint32_t, MulOp>();
+    table.relu = reluSse4;
+    table.clip = clipSse4;
+    table.f32ToBf16 = f32ToBf16Sse4;
+    table.bf16ToF32 = bf16ToF32Sse4;
+    table.f32ToI32 = f32ToI32Sse4;
+    table.i32ToF32 = i32ToF32Sse4;
+    table.transpose32 = transpose32Sse4;
+    table.exp = simd_math::unaryLoop<Sse4Math, simd_math::exp<Sse4Math>>;
+    table.sigmoid =
+        simd_math::unaryLoop<Sse4Math, simd_math::sigmoid<Sse4Math>>;
+    table.tanh = simd_math::unaryLoop<Sse4Math, simd_math::tanh<Sse4Math>>;
+    table.gelu = simd_math::unaryLoop<Sse4Math, simd_math::gelu<Sse4Math>>;
+    table.silu = simd_math::unaryLoop<Sse4Math, simd_math::silu<Sse4Math>>;
+    table.erf = simd_math::unaryLoop<Sse4Math, simd_math::erf<Sse4Math>>;
+    table.reduceSum = {
+        simd_math::reduceAll<Sse4Math, simd_math::SumFold>,
+        simd_math::reduceAccumulate<Sse4Math, simd_math::SumFold>};
+    table.reduceMax = {
+        simd_math::reduceAll<Sse4Math, simd_math::MaxFold>,
+        simd_math::reduceAccumulate<Sse4Math, simd_math::MaxFold>};
+    table.reduceMin = {
+        simd_math::reduceAll<Sse4Math, simd_math::MinFold>,
+        simd_math::reduceAccumulate<Sse4Math, simd_math::MinFold>};
+    table.softmax = {simd_math::softmaxRow<Sse4Math>,
+                     simd_math::softmaxFoldColumns<Sse4Math>,
+                     simd_math::softmaxScaleColumns<Sse4Math>};
+    table.norm = {simd_math::meanVariance<Sse4Math>,
+                  simd_math::sumSquares<Sse4Math>,
+                  simd_math::normalizeRow<Sse4Math>};
+}
+
+} // namespace infini
@@ -0,0 +1,58 @@
+#include "operators/conv.h"
+
+namespace infini {
+ConvObj::ConvObj(GraphObj *graph, Tensor input, Tensor weight, Tensor output,
+                 int ph, int pw, int sh, int sw, int dh, int dw, Tensor bias)
+    : OperatorObj(OpType::Conv,
+                  bias ? TensorVec{input, weight, bias}
+                       : TensorVec{input, weight},
+                  {output}),
+      ph(ph), pw(pw), sh(sh), sw(sw), dh(dh), dw(dw) {
+    IT_ASSERT(ph >= 0 && pw >= 0);
+    IT_ASSERT(sh > 0 && sw > 0 && dh > 0 && dw > 0);
+    for (const auto &t : inputs)
+        IT_ASSERT(t->getDType() == input->getDType());
+    IT_ASSERT(checkValid(graph));
+}
+
+int ConvObj::getNumGroups() const {
+    return inputs[0]->getDims()[1] / inputs[1]->getDims()[1];
+}
+
+optional<vector<Shape>> ConvObj::inferShape(const TensorVec &inputs) {
+    const auto &x = inputs[0]->getDims(), &w = inputs[1]->getDims();
+    if (x.size() != 4 || w.size() != 4)
+        return {};
+    const int n = x[0], c = x[1], h = x[2], wi = x[3];
+    const int f = w[0], cpg = w[1], r = w[2], s = w[3];
+    if (cpg <= 0 || c % cpg != 0 || f % (c / cpg) != 0)
+        return {};
+    if (inputs.size() > 2 && inputs[2]->getDims() != Shape{f})
+        return {};
+    // A negative span means the dilated kernel does not fit in the padded
+    // input; the division would round it towards zero, to one output.
+    const int spanH = h + 2 * ph - dh * (r - 1) - 1;
+    const int spanW = wi + 2 * pw - dw * (s - 1) - 1;
+    if (spanH < 0 || spanW < 0)
+        return {};
+    return {{{n, f, spanH / sh + 1, spanW / sw + 1}}};
+}
+
+std::string ConvObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    os << vecToString(inputs[1]->getDims()) << ",";
+    os << "p=[" << ph << "," << pw << "],";
+    os << "s=[" << sh << "," << sw << "],";
+    os << "d=[" << dh << "," << dw << "],";
+    os << "input=" << inputs[0]->getGuid() << ",";
+    os << "weight=" << inputs[1]->getGuid() << ",";
+    if (auto bias = getBias())
+        os << "bias=" << bias->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+} // namespace infini
@@ -0,0 +1,68 @@
+#include "operators/fused_element_wise.h"
+#include "utils/operator_utils.h"
+
+namespace infini {
+FusedElementWiseObj::FusedElementWiseObj(GraphObj *graph, TensorVec inputs,
+                                         Tensor output,
+                                         vector<FusedStep> _steps,
+                                         int _numRegisters)
+    : OperatorObj(OpType::FusedElementWise, inputs, {output}),
+      steps(std::move(_steps)), numRegisters(_numRegisters) {
+    IT_ASSERT(!steps.empty());
+    const int numIn = inputs.size();
+    for (const auto &step : steps) {
+        IT_ASSERT(canFuse(step.type));
+        IT_ASSERT(step.out >= numIn && step.out < numRegisters);
+        IT_ASSERT(step.in0 >= 0 && step.in0 < numRegisters);
+        IT_ASSERT(step.in1 < numRegisters);
+    }
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<Shape>>
+FusedElementWiseObj::inferShape(const TensorVec &inputs) {
+    // Every step has the output shape, which is therefore the broadcast of
+    // all the inputs.
+    Shape dims = inputs[0]->getDims();
+    for (size_t i = 1; i < inputs.size(); ++i)
+        dims = infer_broadcast(dims, inputs[i]->getDims());
+    return {{dims}};
+}
+
+std::string FusedElementWiseObj::toString() const {
+    std::ostringstream os;
+    os << "FusedElementWise[" << getGuid() << "]";
+    os << "(";
+    for (auto input : inputs)
+        os << vecToString(input->getDims()) << ",";
+    os << "steps=";
+    for (const auto &step : steps)
+        os << step.type.toString() << ",";
+    os << "input=";
+    for (auto input : inputs)
+        os << input->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+bool FusedElementWiseObj::canFuse(OpType type) {
+    switch (type.underlying()) {
+    case OpType::Add:
+    case OpType::Sub:
+    case OpType::Mul:
+    case OpType::Div:
+    case OpType::Clip:
+    case OpType::Relu:
+    case OpType::Erf:
+    case OpType::Exp:
+    case OpType::Gelu:
+    case OpType::Sigmoid:
+    case OpType::Silu:
+    case OpType::Tanh:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,85 @@
+#include "operators/gather.h"
+#include "utils/operator_utils.h"
+
+namespace infini {
+static bool isIndexType(DataType dtype) {
+    return dtype == DataType::Int32 || dtype == DataType::Int64;
+}
+
+GatherObj::GatherObj(GraphObj *graph, Tensor data, Tensor indices,
+                     Tensor output, int axis)
+    : OperatorObj(OpType::Gather, {data, indices}, {output}),
+      axis(get_real_axis(axis, data->getRank())) {
+    IT_ASSERT(isIndexType(indices->getDType()));
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<Shape>> GatherObj::inferShape(const TensorVec &inputs) {
+    const auto &data = inputs[0]->getDims();
+    const auto &indices = inputs[1]->getDims();
+    Shape ret(data.begin(), data.begin() + axis);
+    ret.insert(ret.end(), indices.begin(), indices.end());
+    ret.insert(ret.end(), data.begin() + axis + 1, data.end());
+    return {{ret}};
+}
+
+std::string GatherObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    os << vecToString(inputs[1]->getDims()) << ",";
+    os << "axis=" << axis << ",";
+    os << "input=" << inputs[0]->getGuid() << "," << inputs[1]->getGuid()
+       << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+EmbeddingBagObj::EmbeddingBagObj(GraphObj *graph, Tensor weight,
+                                 Tensor indices, Tensor offsets, Tensor output,
+                                 Mode mode)
+    : OperatorObj(OpType::EmbeddingBag,
+                  offsets ? TensorVec{weight, indices, offsets}
+                          : TensorVec{weight, indices},
+                  {output}),
+      mode(mode) {
+    IT_ASSERT(weight->getDType() == DataType::Float32);
+    IT_ASSERT(isIndexType(indices->getDType()));
+    IT_ASSERT(!offsets || isIndexType(offsets->getDType()));
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<Shape>>
+EmbeddingBagObj::inferShape(const TensorVec &inputs) {
+    const auto &weight = inputs[0]->getDims();
+    const auto &indices = inputs[1]->getDims();
+    if (weight.size() != 2)
+        return {};
+    if (inputs.size() > 2) {
+        const auto &offsets = inputs[2]->getDims();
+        if (indices.size() != 1 || offsets.size() != 1)
+            return {};
+        return {{{offsets[0], weight[1]}}};
+    }
+    if (indices.size() != 2)
+        return {};
+    return {{{indices[0], weight[1]}}};
+}
+
+std::string EmbeddingBagObj::toString() const {
+    static const char *modes[] = {"sum", "mean", "max"};
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    for (auto input : inputs)
+        os << vecToString(input->getDims()) << ",";
+    os << "mode=" << modes[int(mode)] << ",";
+    os << "input=";
+    for (auto input : inputs)
+        os << input->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+} // namespace infini
@@ -7,7 +7,7 @@ namespace infini
     MatmulObj::MatmulObj(GraphObj *graph, Tensor A, Tensor B, Tensor C, bool transA,
                          bool transB)
         : OperatorObj(OpType::MatMul, TensorVec{A, B}, {C}),
-          transA(transA), transB(transB)
+          transA(transA), transB(transB), m(0), n(0), k(0)
     {
         IT_ASSERT(checkValid(graph));
     }
@@ -17,12 +17,59 @@ namespace infini
         std::ostringstream os;
         os << "Matmul([" << (transA ? "A^T" : "A") << "," << (transB ? "B^T" : "B]")
            << ",A=" << inputs[0]->getGuid()
-           << ",B=" << inputs[1]->getGuid() << ",C=" << outputs[0]->getGuid()
+           << ",B=" << inputs[1]->getGuid();
+        if (hasBias)
+            os << ",bias=" << getBias()->getGuid();
+        if (hasResidual)
+            os << ",residual=" << getResidual()->getGuid();
+        if (act != OpType::Unknown)
+            os << ",act=" << act.toString();
+        os << ",C=" << outputs[0]->getGuid()
            << ",mnk=[" << m << "," << n << "," << k << "])";
         return os.str();
     }
 
-   
+    void MatmulObj::setBias(Tensor bias)
+    {
+        IT_ASSERT(!hasBias && !hasResidual && act == OpType::Unknown);
+        const auto &dims = bias->getDims();
+        IT_ASSERT(!dims.empty() && dims.back() == outputs[0]->getDims().back());
+        for (size_t i = 0; i + 1 < dims.size(); ++i)
+            IT_ASSERT(dims[i] == 1, "Matmul bias must be a row vector");
+        inputs.emplace_back(bias);
+        hasBias = true;
+    }
+
+    void MatmulObj::setResidual(Tensor residual)
+    {
+        IT_ASSERT(!hasResidual && act == OpType::Unknown);
+        IT_ASSERT(residual->getDims() == outputs[0]->getDims());
+        inputs.emplace_back(residual);
+        hasResidual = true;
+    }
+
+    void MatmulObj::setActivation(OpType act, float min, float max)
+    {
+        IT_ASSERT(this->act == OpType::Unknown);
+        IT_ASSERT(act == OpType::Relu || act == OpType::Clip ||
+                  act == OpType::Gelu);
+        this->act = act;
+        clipMin = min;
+        clipMax = max;
+    }
+
+    vector<DataType> MatmulObj::inferDataType(const TensorVec &inputs) const
+    {
+        auto dtype = inputs[0]->getDType();
+        if (dtype == DataType::Int8 || dtype == DataType::UInt8)
+        {
+            IT_ASSERT(inputs[1]->getDType() == DataType::Int8,
+                      "Quantized Matmul needs an Int8 B");
+            return {DataType::Int32};
+        }
+        return {dtype};
+    }
+
     optional<vector<Shape>> MatmulObj::inferShape(const TensorVec &inputs) {
         // =================================== 作业 ===================================
         // TODO：返回经过 matmul 操作后的 shape
@@ -45,6 +92,9 @@ namespace infini
 
         // 校验 K 维度是否匹配 
         IT_ASSERT(KA == KB, "MatMul dimension mismatch on K!");
+        m = M;
+        n = N;
+        k = KA;
 
         // 处理 Batch 维度（即除了最后两维以外的所有维度）
         Shape batchA(shapeA.begin(), shapeA.end() - 2);
@@ -0,0 +1,64 @@
+#include "operators/normalization.h"
+#include "utils/operator_utils.h"
+#include <algorithm>
+
+namespace infini {
+NormalizationObj::NormalizationObj(OpType type, GraphObj *graph,
+                                   TensorVec inputs, Tensor y, int axis,
+                                   float eps)
+    : OperatorObj(type, std::move(inputs), {y}),
+      axis(get_real_axis(axis, this->inputs[0]->getRank())), eps(eps) {
+    for (const auto &input : this->inputs)
+        IT_ASSERT(input->getDType() == DataType::Float32);
+}
+
+optional<vector<Shape>>
+NormalizationObj::inferShape(const TensorVec &inputs) {
+    const auto &dims = inputs[0]->getDims();
+    const Shape row(dims.begin() + axis, dims.end());
+    for (size_t i = 1; i < inputs.size(); ++i) {
+        const auto &param = inputs[i]->getDims();
+        // Only leading 1s of the row may be left out.
+        if (param.size() > row.size())
+            return {};
+        const size_t skipped = row.size() - param.size();
+        for (size_t j = 0; j < skipped; ++j)
+            if (row[j] != 1)
+                return {};
+        if (!std::equal(param.begin(), param.end(), row.begin() + skipped))
+            return {};
+    }
+    return {{dims}};
+}
+
+std::string NormalizationObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    os << "axis=" << axis << ",";
+    os << "eps=" << eps << ",";
+    os << "input=" << inputs[0]->getGuid() << ",";
+    os << "scale=" << inputs[1]->getGuid() << ",";
+    if (auto bias = getBias())
+        os << "bias=" << bias->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+LayerNormObj::LayerNormObj(GraphObj *graph, Tensor x, Tensor scale,
+                           Tensor bias, Tensor y, int axis, float eps)
+    : NormalizationObj(OpType::LayerNormalization, graph,
+                       bias ? TensorVec{x, scale, bias} : TensorVec{x, scale},
+                       y, axis, eps) {
+    IT_ASSERT(checkValid(graph));
+}
+
+RMSNormObj::RMSNormObj(GraphObj *graph, Tensor x, Tensor scale, Tensor y,
+                       int axis, float eps)
+    : NormalizationObj(OpType::RMSNormalization, graph, {x, scale}, y, axis,
+                       eps) {
+    IT_ASSERT(checkValid(graph));
+}
+
+} // namespace infini
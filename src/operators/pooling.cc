@@ -0,0 +1,74 @@
+#include "operators/pooling.h"
+
+namespace infini {
+PoolingObj::PoolingObj(OpType type, GraphObj *graph, Tensor input,
+                       Tensor output, int kh, int kw, int dh, int dw, int ph,
+                       int pw, int sh, int sw, bool ceilMode)
+    : OperatorObj(type, {input}, {output}), kh(kh), kw(kw), dh(dh), dw(dw),
+      ph(ph), pw(pw), sh(sh), sw(sw), ceilMode(ceilMode) {
+    IT_ASSERT(kh > 0 && kw > 0 && dh > 0 && dw > 0 && sh > 0 && sw > 0);
+    // A window that is all padding would have no value.
+    IT_ASSERT(ph >= 0 && pw >= 0 && ph < (kh - 1) * dh + 1 &&
+              pw < (kw - 1) * dw + 1);
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<Shape>> PoolingObj::inferShape(const TensorVec &inputs) {
+    const auto &x = inputs[0]->getDims();
+    if (x.size() != 4)
+        return {};
+    auto outSize = [&](int in, int k, int d, int p, int s) {
+        const int span = in + 2 * p - d * (k - 1) - 1;
+        if (span < 0)
+            return 0;
+        int out = (ceilMode ? (span + s - 1) / s : span / s) + 1;
+        if (ceilMode && (out - 1) * s >= in + p)
+            --out;
+        return out;
+    };
+    const int oh = outSize(x[2], kh, dh, ph, sh);
+    const int ow = outSize(x[3], kw, dw, pw, sw);
+    if (oh <= 0 || ow <= 0)
+        return {};
+    return {{{x[0], x[1], oh, ow}}};
+}
+
+std::string PoolingObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    os << "k=[" << kh << "," << kw << "],";
+    os << "p=[" << ph << "," << pw << "],";
+    os << "s=[" << sh << "," << sw << "],";
+    os << "d=[" << dh << "," << dw << "],";
+    os << "ceil=" << ceilMode << ",";
+    os << "input=" << inputs[0]->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+GlobalAvgPoolObj::GlobalAvgPoolObj(GraphObj *graph, Tensor input,
+                                   Tensor output)
+    : OperatorObj(OpType::GlobalAveragePool, {input}, {output}) {
+    IT_ASSERT(checkValid(graph));
+}
+
+optional<vector<Shape>> GlobalAvgPoolObj::inferShape(const TensorVec &inputs) {
+    const auto &x = inputs[0]->getDims();
+    if (x.size() != 4)
+        return {};
+    return {{{x[0], x[1], 1, 1}}};
+}
+
+std::string GlobalAvgPoolObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    os << "input=" << inputs[0]->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+} // namespace infini
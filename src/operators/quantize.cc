@@ -0,0 +1,80 @@
+#include "operators/quantize.h"
+#include "utils/operator_utils.h"
+
+namespace infini {
+QuantizationObj::QuantizationObj(OpType type, GraphObj *graph, Tensor x,
+                                 Tensor scale, Tensor zeroPoint, Tensor y,
+                                 int axis)
+    : OperatorObj(type,
+                  zeroPoint ? TensorVec{x, scale, zeroPoint}
+                            : TensorVec{x, scale},
+                  {y}),
+      axis(axis) {
+    IT_ASSERT(scale->getDType() == DataType::Float32);
+    // The axis only matters, and only has to be valid, per channel.
+    if (isPerChannel())
+        this->axis = get_real_axis(axis, x->getRank());
+}
+
+bool QuantizationObj::isPerChannel() const { return getScale()->size() > 1; }
+
+optional<vector<Shape>>
+QuantizationObj::inferShape(const TensorVec &inputs) {
+    const auto &x = inputs[0], &scale = inputs[1];
+    if (scale->getRank() > 1)
+        return {};
+    if (scale->size() > 1 && scale->getDims() != Shape{x->getDims()[axis]})
+        return {};
+    if (inputs.size() > 2 && inputs[2]->getDims() != scale->getDims())
+        return {};
+    return {{x->getDims()}};
+}
+
+std::string QuantizationObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    if (isPerChannel())
+        os << "axis=" << axis << ",";
+    os << "input=" << inputs[0]->getGuid() << ",";
+    os << "scale=" << inputs[1]->getGuid() << ",";
+    if (auto zeroPoint = getZeroPoint())
+        os << "zeroPoint=" << zeroPoint->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+QuantizeLinearObj::QuantizeLinearObj(GraphObj *graph, Tensor x, Tensor scale,
+                                     Tensor zeroPoint, Tensor y, int axis)
+    : QuantizationObj(OpType::QuantizeLinear, graph, x, scale, zeroPoint, y,
+                      axis) {
+    IT_ASSERT(x->getDType() == DataType::Float32);
+    IT_ASSERT(!zeroPoint || zeroPoint->getDType() == DataType::Int8 ||
+              zeroPoint->getDType() == DataType::UInt8);
+    IT_ASSERT(checkValid(graph));
+}
+
+vector<DataType>
+QuantizeLinearObj::inferDataType(const TensorVec &inputs) const {
+    return {inputs.size() > 2 ? inputs[2]->getDType() : DataType::Int8};
+}
+
+DequantizeLinearObj::DequantizeLinearObj(GraphObj *graph, Tensor x,
+                                         Tensor scale, Tensor zeroPoint,
+                                         Tensor y, int axis)
+    : QuantizationObj(OpType::DequantizeLinear, graph, x, scale, zeroPoint, y,
+                      axis) {
+    auto dtype = x->getDType();
+    IT_ASSERT(dtype == DataType::Int8 || dtype == DataType::UInt8 ||
+              dtype == DataType::Int32);
+    IT_ASSERT(!zeroPoint || zeroPoint->getDType() == dtype);
+    IT_ASSERT(checkValid(graph));
+}
+
+vector<DataType>
+DequantizeLinearObj::inferDataType(const TensorVec &inputs) const {
+    return {DataType::Float32};
+}
+
+} // namespace infini
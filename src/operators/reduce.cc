@@ -0,0 +1,53 @@
+#include "operators/reduce.h"
+#include "utils/operator_utils.h"
+#include <algorithm>
+
+namespace infini {
+ReduceObj::ReduceObj(OpType type, GraphObj *graph, Tensor input,
+                     Tensor output, const optional<vector<int>> &_axes,
+                     bool keepDims)
+    : OperatorObj(type, {input}, {output}), keepDims(keepDims) {
+    IT_ASSERT(type == OpType::ReduceSum || type == OpType::ReduceMean ||
+              type == OpType::ReduceMax || type == OpType::ReduceMin);
+    int rank = input->getRank();
+    if (_axes) {
+        for (int axis : *_axes)
+            axes.emplace_back(get_real_axis(axis, rank));
+        std::sort(axes.begin(), axes.end());
+        axes.erase(std::unique(axes.begin(), axes.end()), axes.end());
+    } else {
+        for (int i = 0; i < rank; ++i)
+            axes.emplace_back(i);
+    }
+    IT_ASSERT(checkValid(graph));
+}
+
+bool ReduceObj::isReduced(int axis) const {
+    return std::binary_search(axes.begin(), axes.end(), axis);
+}
+
+optional<vector<Shape>> ReduceObj::inferShape(const TensorVec &inputs) {
+    const auto &dims = inputs[0]->getDims();
+    Shape ret;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        if (!isReduced(i))
+            ret.emplace_back(dims[i]);
+        else if (keepDims)
+            ret.emplace_back(1);
+    }
+    return {{ret}};
+}
+
+std::string ReduceObj::toString() const {
+    std::ostringstream os;
+    os << type.toString() << "[" << getGuid() << "]";
+    os << "(";
+    os << vecToString(inputs[0]->getDims()) << ",";
+    os << "axes=" << vecToString(axes) << ",";
+    os << "keepDims=" << keepDims << ",";
+    os << "input=" << inputs[0]->getGuid() << ",";
+    os << "output=" << outputs[0]->getGuid() << ")";
+    return os.str();
+}
+
+} // namespace infini
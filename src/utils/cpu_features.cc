@@ -0,0 +1,134 @@
+#include "utils/cpu_features.h"
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace infini {
+
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__)
+struct CpuidRegs {
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+};
+
+CpuidRegs cpuid(unsigned leaf, unsigned subleaf = 0) {
+    CpuidRegs r;
+    if (!__get_cpuid_count(leaf, subleaf, &r.eax, &r.ebx, &r.ecx, &r.edx))
+        r = CpuidRegs();
+    return r;
+}
+
+uint64_t xgetbv0() {
+    unsigned eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (uint64_t(edx) << 32) | eax;
+}
+
+inline bool bit(unsigned reg, int i) { return (reg >> i) & 1u; }
+#endif
+
+size_t cacheSize(int name, size_t fallback) {
+    long size = sysconf(name);
+    return size > 0 ? size_t(size) : fallback;
+}
+
+} // namespace
+
+const char *cpu_isa_to_str(CpuIsa isa) {
+    switch (isa) {
+    case CpuIsa::Scalar:
+        return "scalar";
+    case CpuIsa::SSE4:
+        return "sse4";
+    case CpuIsa::AVX2:
+        return "avx2";
+    case CpuIsa::AVX512:
+        return "avx512";
+    default:
+        IT_TODO_HALT();
+    }
+}
+
+CpuFeatures::CpuFeatures() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned maxLeaf = cpuid(0).eax;
+    auto l1 = cpuid(1);
+    sse41 = bit(l1.ecx, 19);
+    sse42 = bit(l1.ecx, 20);
+    bool osxsave = bit(l1.ecx, 27);
+    // The OS has to save the YMM (and for AVX-512 also the opmask and ZMM)
+    // state on context switches, otherwise the instructions are unusable.
+    uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+    bool ymmState = (xcr0 & 0x6) == 0x6;
+    bool zmmState = ymmState && (xcr0 & 0xe0) == 0xe0;
+    avx = ymmState && bit(l1.ecx, 28);
+    fma = avx && bit(l1.ecx, 12);
+    f16c = avx && bit(l1.ecx, 29);
+    if (maxLeaf >= 7) {
+        auto l7 = cpuid(7, 0);
+        auto l7s1 = cpuid(7, 1);
+        avx2 = avx && bit(l7.ebx, 5);
+        avx512f = zmmState && bit(l7.ebx, 16);
+        avx512dq = avx512f && bit(l7.ebx, 17);
+        avx512bw = avx512f && bit(l7.ebx, 30);
+        avx512vl = avx512f && bit(l7.ebx, 31);
+        avx512vnni = avx512f && bit(l7.ecx, 11);
+        avx512bf16 = avx512f && bit(l7s1.eax, 5);
+        avxvnni = avx2 && bit(l7s1.eax, 4);
+    }
+#endif
+    l1CacheSize = cacheSize(_SC_LEVEL1_DCACHE_SIZE, 32 << 10);
+    l2CacheSize = cacheSize(_SC_LEVEL2_CACHE_SIZE, 256 << 10);
+    l3CacheSize = cacheSize(_SC_LEVEL3_CACHE_SIZE, 8 << 20);
+
+    isa = CpuIsa::Scalar;
+    for (auto level : {CpuIsa::SSE4, CpuIsa::AVX2, CpuIsa::AVX512})
+        if (supports(level))
+            isa = level;
+    if (const char *env = std::getenv("INFINI_CPU_ISA")) {
+        for (auto level : {CpuIsa::Scalar, CpuIsa::SSE4, CpuIsa::AVX2,
+                           CpuIsa::AVX512})
+            if (std::strcmp(env, cpu_isa_to_str(level)) == 0 && level < isa)
+                isa = level;
+    }
+}
+
+const CpuFeatures &CpuFeatures::getInstance() {
+    static const CpuFeatures instance;
+    return instance;
+}
+
+bool CpuFeatures::supports(CpuIsa level) const {
+    switch (level) {
+    case CpuIsa::Scalar:
+        return true;
+    case CpuIsa::SSE4:
+        return sse41 && sse42;
+    case CpuIsa::AVX2:
+        return supports(CpuIsa::SSE4) && avx2 && fma && f16c;
+    case CpuIsa::AVX512:
+        return supports(CpuIsa::AVX2) && avx512f && avx512bw && avx512dq &&
+               avx512vl;
+    default:
+        return false;
+    }
+}
+
+string CpuFeatures::toString() const {
+    std::ostringstream os;
+    os << "CpuFeatures(isa=" << cpu_isa_to_str(isa);
+    os << ",sse4.1=" << sse41 << ",sse4.2=" << sse42 << ",avx=" << avx;
+    os << ",avx2=" << avx2 << ",fma=" << fma << ",f16c=" << f16c;
+    os << ",avx512f=" << avx512f << ",avx512bw=" << avx512bw;
+    os << ",avx512dq=" << avx512dq << ",avx512vl=" << avx512vl;
+    os << ",avx512vnni=" << avx512vnni << ",avx512bf16=" << avx512bf16;
+    os << ",avxvnni=" << avxvnni << ",l1=" << l1CacheSize;
+    os << ",l2=" << l2CacheSize << ",l3=" << l3CacheSize << ")";
+    return os.str();
+}
+
+} // namespace infini
@@ -51,6 +51,26 @@ namespace infini
         EXPECT_EQ(offsetC, offsetD);
     }
 
+    TEST(Allocator, testFreeMergesBothNeighbours)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Allocator allocator = Allocator(runtime);
+        const size_t size = 48;
+        // allocate a->b->c->d->e
+        allocator.alloc(size);
+        size_t offsetB = allocator.alloc(size);
+        size_t offsetC = allocator.alloc(size);
+        size_t offsetD = allocator.alloc(size);
+        allocator.alloc(size);
+        // free b and d, then c between them: the three merge into one block
+        allocator.free(offsetB, size);
+        allocator.free(offsetD, size);
+        allocator.free(offsetC, size);
+        EXPECT_EQ(allocator.alloc(3 * size), offsetB);
+        // nothing is left free between a and e
+        EXPECT_EQ(allocator.alloc(size), 5 * size);
+    }
+
     TEST(Allocator, testGetPtr)
     {
         Shape shape = Shape{1, 2, 2, 3};
@@ -0,0 +1,132 @@
+#include "core/execution_plan.h"
+#include "core/graph.h"
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/data_generator.h"
+
+#include "test.h"
+
+namespace infini {
+
+// softmax(relu(a x transpose(b) + bias)), with the kernels that resolve
+// their arguments ahead and the Transpose one that does not.
+TEST(ExecutionPlan, MatchesRun) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor({2, 16, 24}, DataType::Float32);
+    auto b = g->addTensor({24, 32}, DataType::Float32);
+    auto bias = g->addTensor({32}, DataType::Float32);
+    auto bt = g->addOp<TransposeObj>(b, nullptr, vector<int>{1, 0})
+                  ->getOutput();
+    auto c = g->addOp<MatmulObj>(a, bt, nullptr, false, true)->getOutput();
+    auto d = g->addOp<AddObj>(c, bias, nullptr)->getOutput();
+    auto e = g->addOp<ReluObj>(d, nullptr)->getOutput();
+    auto y = g->addOp<SoftmaxObj>(e, nullptr)->getOutput();
+    g->dataMalloc();
+    a->setData(RandomGenerator(-1, 1, 1));
+    b->setData(RandomGenerator(-1, 1, 2));
+    bias->setData(RandomGenerator(-1, 1, 3));
+
+    auto plan = runtime->compile(g);
+    ASSERT_EQ(plan.size(), 5u);
+    EXPECT_EQ(*plan.getSteps()[1].kernel, "MatmulNative_CPU");
+
+    runtime->run(g);
+    const float *out = y->getRawDataPtr<float *>();
+    vector<float> expected(out, out + y->size());
+    std::fill_n(y->getRawDataPtr<float *>(), y->size(), 0.f);
+    runtime->run(plan);
+    EXPECT_TRUE(y->equalData(expected));
+
+    // The plan binds pointers, not values: new inputs are picked up.
+    a->setData(RandomGenerator(-1, 1, 4));
+    runtime->run(g);
+    expected.assign(out, out + y->size());
+    std::fill_n(y->getRawDataPtr<float *>(), y->size(), 0.f);
+    runtime->run(plan);
+    EXPECT_TRUE(y->equalData(expected));
+}
+
+TEST(ExecutionPlan, Profiler) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor({8, 8}, DataType::Float32);
+    auto b = g->addTensor({8, 8}, DataType::Float32);
+    g->addOp<MulObj>(a, b, nullptr);
+    g->dataMalloc();
+    auto plan = runtime->compile(g);
+
+    auto profiler = make_ref<Profiler>();
+    runtime->setProfiler(profiler);
+    for (int i = 0; i < 3; ++i)
+        runtime->run(plan);
+    runtime->setProfiler(nullptr);
+    auto stats = profiler->getStats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].kernel, "mulNaive_CPU");
+    EXPECT_EQ(stats[0].calls, 3u);
+}
+
+// Two towers of x that only meet at the end.
+static Graph buildTowers(Runtime runtime, bool reuse) {
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({64, 64}, DataType::Float32);
+    auto w0 = g->addTensor({64, 64}, DataType::Float32);
+    auto w1 = g->addTensor({64, 64}, DataType::Float32);
+    TensorVec towers;
+    for (auto w : {w0, w1}) {
+        auto t = x;
+        for (int i = 0; i < 4; ++i) {
+            t = g->addOp<MatmulObj>(t, w, nullptr)->getOutput();
+            t = g->addOp<TanhObj>(t, nullptr)->getOutput();
+        }
+        towers.emplace_back(t);
+    }
+    g->addOp<ConcatObj>(towers, nullptr, 0);
+    g->dataMalloc(true, reuse);
+    x->setData(RandomGenerator(-1, 1, 1));
+    w0->setData(RandomGenerator(-0.2, 0.2, 2));
+    w1->setData(RandomGenerator(-0.2, 0.2, 3));
+    return g;
+}
+
+// With buffer reuse, the second tower takes over buffers of the first one
+// in graph order and must wait for their last readers; without, the towers
+// are independent.
+TEST(ExecutionPlan, Concurrent) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    for (bool reuse : {true, false}) {
+        Graph g = buildTowers(runtime, reuse);
+        auto y = g->getOperators().back()->getOutput();
+        runtime->run(g);
+        const float *out = y->getRawDataPtr<float *>();
+        const vector<float> expected(out, out + y->size());
+
+        auto plan = runtime->compile(g);
+        EXPECT_EQ(plan.getSteps()[0].numPredecessors, 0);
+        if (!reuse) {
+            EXPECT_EQ(plan.getSteps()[8].numPredecessors, 0);
+        }
+
+        runtime->setThreads(4, 1);
+        EXPECT_EQ(runtime->getInterOpThreads(), 4);
+        for (int i = 0; i < 20; ++i) {
+            std::fill_n(y->getRawDataPtr<float *>(), y->size(), 0.f);
+            runtime->run(plan);
+            EXPECT_TRUE(y->equalData(expected));
+        }
+        std::fill_n(y->getRawDataPtr<float *>(), y->size(), 0.f);
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(expected));
+        runtime->setThreads(1);
+        EXPECT_EQ(runtime->getInterOpThreads(), 1);
+    }
+}
+
+} // namespace infini
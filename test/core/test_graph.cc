@@ -1,8 +1,13 @@
 #include "core/graph.h"
 #include "core/kernel.h"
 #include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/fused_element_wise.h"
 #include "operators/matmul.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
+#include <cstring>
 
 #include "test.h"
 
@@ -37,4 +42,249 @@ namespace infini
         EXPECT_EQ(op->getTransA(), false);
         EXPECT_EQ(op->getTransB(), true);
     }
-}
\ No newline at end of file
+
+    TEST(Graph, ZeroCopyConcat)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i1 = g->addTensor({1, 2, 3}, DataType::Float32);
+        Tensor i2 = g->addTensor({1, 2, 3}, DataType::Float32);
+        auto add = g->addOp<AddObj>(i1, i2, nullptr);
+        auto mul = g->addOp<MulObj>(i1, i2, nullptr);
+        auto sub = g->addOp<SubObj>(i1, i2, nullptr);
+        // add and mul are only read by the inner Concat, which is only read
+        // by the outer one; i2 is a graph input and sub has two readers.
+        auto inner = g->addOp<ConcatObj>(
+            TensorVec{add->getOutput(), mul->getOutput(), i2}, nullptr, 1);
+        auto outer = g->addOp<ConcatObj>(
+            TensorVec{sub->getOutput(), inner->getOutput()}, nullptr, 1);
+        auto twice = g->addOp<AddObj>(sub->getOutput(), sub->getOutput(),
+                                      nullptr);
+        // The outer dim of this Concat is 2, so its slices are not contiguous.
+        auto strided = g->addOp<ConcatObj>(
+            TensorVec{g->addOp<AddObj>(i1, i1, nullptr)->getOutput(), i2},
+            nullptr, 2);
+        g->dataMalloc();
+        i1->setData(IncrementalGenerator());
+        i2->setData(OneGenerator());
+        runtime->run(g);
+
+        auto base = outer->getOutput()->getRawDataPtr<float *>();
+        EXPECT_EQ(inner->getOutput()->getRawDataPtr<float *>(), base + 6);
+        EXPECT_EQ(add->getOutput()->getRawDataPtr<float *>(), base + 6);
+        EXPECT_EQ(mul->getOutput()->getRawDataPtr<float *>(), base + 12);
+        EXPECT_NE(sub->getOutput()->getRawDataPtr<float *>(), base);
+        EXPECT_NE(strided->getInputs(0)->getRawDataPtr<float *>(),
+                  strided->getOutput()->getRawDataPtr<float *>());
+        EXPECT_TRUE(outer->getOutput()->equalData(
+            vector<float>{-1, 0, 1, 2, 3, 4, 1, 2, 3, 4, 5, 6,
+                          0, 1, 2, 3, 4, 5, 1, 1, 1, 1, 1, 1}));
+        EXPECT_TRUE(twice->getOutput()->equalData(
+            vector<float>{-2, 0, 2, 4, 6, 8}));
+        EXPECT_TRUE(strided->getOutput()->equalData(
+            vector<float>{0, 2, 4, 1, 1, 1, 6, 8, 10, 1, 1, 1}));
+    }
+
+    TEST(Graph, InPlace)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        for (bool inPlace : {true, false})
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            Tensor i = g->addTensor({2, 3}, DataType::Float32);
+            Tensor bias = g->addTensor({3}, DataType::Float32);
+            auto relu = g->addOp<ReluObj>(i, nullptr);
+            auto clip = g->addOp<ClipObj>(relu->getOutput(), nullptr,
+                                          std::nullopt, 3.f);
+            // The larger input of a broadcast can be overwritten, and bias,
+            // read again below, is a graph input in any case.
+            auto add = g->addOp<AddObj>(bias, clip->getOutput(), nullptr);
+            auto cast = g->addOp<CastObj>(add->getOutput(), nullptr,
+                                          CastType::Float2Int32);
+            // relu's output is still read here, so clip cannot take it but
+            // the Mul can.
+            auto mul = g->addOp<MulObj>(relu->getOutput(), bias, nullptr);
+            g->dataMalloc(inPlace);
+            i->setData(IncrementalGenerator());
+            bias->setData(OneGenerator());
+            runtime->run(g);
+
+            auto ptr = [](const Operator &op)
+            { return op->getOutput()->getRawDataPtr<void *>(); };
+            EXPECT_EQ(ptr(clip) == ptr(add), inPlace);
+            EXPECT_EQ(ptr(add) == ptr(cast), inPlace);
+            EXPECT_NE(ptr(relu), ptr(clip));
+            EXPECT_EQ(ptr(relu) == ptr(mul), inPlace);
+            EXPECT_NE(i->getRawDataPtr<void *>(), ptr(relu));
+            EXPECT_TRUE(cast->getOutput()->equalData(
+                vector<int32_t>{1, 2, 3, 4, 4, 4}));
+            EXPECT_TRUE(mul->getOutput()->equalData(
+                vector<float>{0, 1, 2, 3, 4, 5}));
+        }
+    }
+
+    TEST(Graph, FuseElementWise)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        vector<vector<float>> results;
+        for (bool fuse : {false, true})
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            Tensor x = g->addTensor({2, 3, 4}, DataType::Float32);
+            Tensor bias = g->addTensor({4}, DataType::Float32);
+            Tensor scale = g->addTensor({3, 1}, DataType::Float32);
+            auto add = g->addOp<AddObj>(x, bias, nullptr);
+            auto mul = g->addOp<MulObj>(add->getOutput(), scale, nullptr);
+            auto relu = g->addOp<ReluObj>(mul->getOutput(), nullptr);
+            auto clip = g->addOp<ClipObj>(relu->getOutput(), nullptr,
+                                          std::nullopt, 6.f);
+            // Two fused chains meet at the Sub.
+            auto tanh = g->addOp<TanhObj>(x, nullptr);
+            auto sub = g->addOp<SubObj>(clip->getOutput(), tanh->getOutput(),
+                                        nullptr);
+            // sub has two readers, so it stays materialized.
+            auto exp = g->addOp<ExpObj>(sub->getOutput(), nullptr);
+            auto sigmoid = g->addOp<SigmoidObj>(sub->getOutput(), nullptr);
+            if (fuse)
+            {
+                g->optimize();
+                EXPECT_EQ(g->getOperators().size(), 3);
+                EXPECT_EQ(g->getTensors().size(), 6);
+                auto fused =
+                    as<FusedElementWiseObj>(sub->getOutput()->getSource());
+                EXPECT_EQ(fused->getOpType(), OpType::FusedElementWise);
+                EXPECT_EQ(fused->numInputs(), 3);
+                EXPECT_EQ(fused->getSteps().size(), 6);
+                // Registers are reused, so the chain needs fewer than one
+                // per step.
+                EXPECT_LT(fused->getNumRegisters(), 3 + 6);
+                EXPECT_TRUE(fused->getPredecessors().empty());
+                EXPECT_EQ(fused->getSuccessors().size(), 2);
+                for (const Operator &op : OpVec{exp, sigmoid})
+                    EXPECT_EQ(op->getPredecessors(), OpVec{fused});
+                EXPECT_TRUE(g->checkValid());
+            }
+            g->dataMalloc();
+            x->setData(IncrementalGenerator());
+            bias->setData(OneGenerator());
+            float scales[] = {-1, 0.5, 2};
+            std::memcpy(scale->getRawDataPtr<float *>(), scales,
+                        sizeof(scales));
+            runtime->run(g);
+            for (auto &out : {exp->getOutput(), sigmoid->getOutput()})
+            {
+                auto ptr = out->getRawDataPtr<float *>();
+                results.emplace_back(ptr, ptr + out->size());
+            }
+        }
+        for (size_t i = 0; i < 2; ++i)
+            for (size_t k = 0; k < results[i].size(); ++k)
+                EXPECT_FLOAT_EQ(results[i][k], results[i + 2][k]);
+    }
+
+    TEST(Graph, OptimizeKeepsOutputs)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3}, DataType::Float32);
+        g->addOp<ReluObj>(i, nullptr);
+        g->optimize();
+        EXPECT_EQ(g->getOperators().size(), 1);
+        EXPECT_EQ(g->getTensors().size(), 2);
+    }
+
+    TEST(Graph, FoldMatmulEpilogue)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        vector<vector<float>> results;
+        for (bool fold : {false, true})
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            Tensor a = g->addTensor({2, 3, 4}, DataType::Float32);
+            Tensor w = g->addTensor({4, 5}, DataType::Float32);
+            Tensor bias = g->addTensor({5}, DataType::Float32);
+            Tensor x = g->addTensor({2, 3, 5}, DataType::Float32);
+            auto matmul = g->addOp<MatmulObj>(a, w, nullptr);
+            auto addBias =
+                g->addOp<AddObj>(bias, matmul->getOutput(), nullptr);
+            auto addX = g->addOp<AddObj>(addBias->getOutput(), x, nullptr);
+            auto clip = g->addOp<ClipObj>(addX->getOutput(), nullptr, -3.f,
+                                          20.f);
+            // The activation is taken, so this Relu stays.
+            auto relu = g->addOp<ReluObj>(clip->getOutput(), nullptr);
+            if (fold)
+            {
+                g->optimize();
+                EXPECT_EQ(g->getOperators().size(), 2);
+                EXPECT_EQ(g->getTensors().size(), 6);
+                EXPECT_EQ(clip->getOutput()->getSource(), matmul);
+                EXPECT_EQ(matmul->getBias(), bias);
+                EXPECT_EQ(matmul->getResidual(), x);
+                EXPECT_EQ(matmul->getActivation(), OpType::Clip);
+                EXPECT_EQ(matmul->getClipMax(), 20.f);
+            }
+            g->dataMalloc();
+            a->setData(IncrementalGenerator());
+            w->setData(IncrementalGenerator());
+            bias->setData(IncrementalGenerator());
+            x->setData(OneGenerator());
+            runtime->run(g);
+            auto out = relu->getOutput();
+            auto ptr = out->getRawDataPtr<float *>();
+            results.emplace_back(ptr, ptr + out->size());
+        }
+        EXPECT_EQ(results[0], results[1]);
+    }
+
+    // The op links of the consumers and of the producer of the bias move to
+    // the MatMul with the tensors.
+    TEST(Graph, FoldMatmulEpilogueLinks)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({3, 4}, DataType::Float32);
+        Tensor w = g->addTensor({4, 5}, DataType::Float32);
+        Tensor b = g->addTensor({5}, DataType::Float32);
+        auto matmul = g->addOp<MatmulObj>(a, w, nullptr);
+        auto biasOp = g->addOp<SigmoidObj>(b, nullptr);
+        auto add = g->addOp<AddObj>(matmul->getOutput(), biasOp->getOutput(),
+                                    nullptr);
+        auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+        auto tanh = g->addOp<TanhObj>(relu->getOutput(), nullptr);
+        g->optimize();
+        ASSERT_EQ(g->getOperators().size(), 3);
+        EXPECT_EQ(matmul->getBias(), biasOp->getOutput());
+        EXPECT_EQ(matmul->getActivation(), OpType::Relu);
+        EXPECT_EQ(tanh->getPredecessors(), OpVec{matmul});
+        EXPECT_EQ(matmul->getSuccessors(), OpVec{tanh});
+        EXPECT_EQ(matmul->getPredecessors(), OpVec{biasOp});
+        EXPECT_EQ(biasOp->getSuccessors(), OpVec{matmul});
+        EXPECT_TRUE(g->checkValid());
+    }
+
+    // Graph inputs outlive their last reader: a later buffer placed over x
+    // would feed the second run the tanh of the first.
+    TEST(Graph, RunTwice)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3}, DataType::Float32);
+        auto relu = g->addOp<ReluObj>(x, nullptr);
+        auto tanh = g->addOp<TanhObj>(relu->getOutput(), nullptr);
+        g->dataMalloc(false);
+        EXPECT_NE(tanh->getOutput()->getRawDataPtr<void *>(),
+                  x->getRawDataPtr<void *>());
+        x->setData(IncrementalGenerator());
+        vector<float> first;
+        for (int run = 0; run < 2; ++run)
+        {
+            runtime->run(g);
+            EXPECT_TRUE(x->equalData(vector<float>{0, 1, 2, 3, 4, 5}));
+            auto out = tanh->getOutput()->getRawDataPtr<float *>();
+            if (run == 0)
+                first.assign(out, out + 6);
+            else
+                EXPECT_EQ(vector<float>(out, out + 6), first);
+        }
+    }
+}
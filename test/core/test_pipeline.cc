@@ -0,0 +1,96 @@
+#include "core/graph.h"
+#include "core/pipeline.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+#include "utils/data_generator.h"
+#include <cstring>
+
+#include "test.h"
+
+namespace infini {
+
+// tanh(tanh(x w) w), with x set per request and w shared.
+static Graph buildGraph(Runtime runtime, Tensor &x, Tensor &y) {
+    Graph g = make_ref<GraphObj>(runtime);
+    x = g->addTensor({16, 32}, DataType::Float32);
+    auto w = g->addTensor({32, 32}, DataType::Float32);
+    auto t = x;
+    for (int i = 0; i < 2; ++i) {
+        t = g->addOp<MatmulObj>(t, w, nullptr)->getOutput();
+        t = g->addOp<TanhObj>(t, nullptr)->getOutput();
+    }
+    y = t;
+    g->dataMalloc();
+    w->setData(RandomGenerator(-0.5, 0.5, 1));
+    return g;
+}
+
+static Pipeline::Buffer toBuffer(const vector<float> &values) {
+    Pipeline::Buffer buffer(values.size() * sizeof(float));
+    std::memcpy(buffer.data(), values.data(), buffer.size());
+    return buffer;
+}
+
+static vector<float> toFloats(const Pipeline::Buffer &buffer) {
+    vector<float> values(buffer.size() / sizeof(float));
+    std::memcpy(values.data(), buffer.data(), buffer.size());
+    return values;
+}
+
+// Every request gets the outputs of a synchronous run on its inputs, with
+// more requests than slots so that some of them queue.
+TEST(Pipeline, MatchesRun) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Tensor x, y;
+    Graph g = buildGraph(runtime, x, y);
+    const int n = 12;
+    vector<vector<float>> inputs(n), expected(n);
+    for (int r = 0; r < n; ++r) {
+        x->setData(RandomGenerator(-1, 1, 100 + r));
+        runtime->run(g);
+        const float *in = x->getRawDataPtr<float *>();
+        const float *out = y->getRawDataPtr<float *>();
+        inputs[r].assign(in, in + x->size());
+        expected[r].assign(out, out + y->size());
+    }
+
+    for (int depth : {1, 3}) {
+        Pipeline pipeline(runtime, g, {x}, depth);
+        EXPECT_EQ(pipeline.getDepth(), depth);
+        ASSERT_EQ(pipeline.getOutputs().size(), 1u);
+        vector<std::future<vector<Pipeline::Buffer>>> futures;
+        for (int r = 0; r < n; ++r)
+            futures.emplace_back(pipeline.submit({toBuffer(inputs[r])}));
+        for (int r = 0; r < n; ++r) {
+            auto outputs = futures[r].get();
+            ASSERT_EQ(outputs.size(), 1u);
+            EXPECT_EQ(toFloats(outputs[0]), expected[r]);
+        }
+    }
+}
+
+TEST(Pipeline, Callback) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Tensor x, y;
+    Graph g = buildGraph(runtime, x, y);
+    std::atomic<int> done{0};
+    {
+        Pipeline pipeline(runtime, g, {x}, 2);
+        for (int r = 0; r < 8; ++r)
+            pipeline.submit({toBuffer(vector<float>(x->size(), 0.f))},
+                            [&](vector<Pipeline::Buffer> outputs,
+                                std::exception_ptr error) {
+                                EXPECT_FALSE(error);
+                                // tanh(0 w) w = 0
+                                for (float v : toFloats(outputs[0]))
+                                    EXPECT_EQ(v, 0.f);
+                                ++done;
+                            });
+        pipeline.wait();
+        EXPECT_EQ(done, 8);
+        EXPECT_THROW(pipeline.submit({Pipeline::Buffer(4)}), Exception);
+    }
+}
+
+} // namespace infini
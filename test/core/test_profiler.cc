@@ -0,0 +1,128 @@
+#include "core/graph.h"
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/softmax.h"
+#include <thread>
+
+#include "test.h"
+
+namespace infini {
+
+static Graph buildGraph(Runtime runtime) {
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor({64, 128}, DataType::Float32);
+    auto b = g->addTensor({128, 32}, DataType::Float32);
+    auto c = g->addOp<MatmulObj>(a, b, nullptr)->getOutput();
+    g->addOp<SoftmaxObj>(c, nullptr);
+    g->dataMalloc();
+    return g;
+}
+
+TEST(Profiler, Percentile) {
+    Profiler::OpStats s;
+    for (int i = 100; i >= 1; --i)
+        s.add(i);
+    EXPECT_EQ(s.calls, 100u);
+    EXPECT_EQ(s.total(), 5050);
+    EXPECT_EQ(s.percentile(50), 50);
+    EXPECT_EQ(s.percentile(99), 99);
+    EXPECT_EQ(s.percentile(100), 100);
+    EXPECT_EQ(s.percentile(0), 1);
+}
+
+// Past maxSamples calls the memory stays bounded, the count and the total
+// stay exact and the percentiles close.
+TEST(Profiler, SampledPercentile) {
+    Profiler::OpStats s;
+    const size_t n = 1000000;
+    // 1 to n, in an order unrelated to the values.
+    for (size_t i = 0; i < n; ++i)
+        s.add(i * 7919 % n + 1);
+    EXPECT_EQ(s.samples.size(), Profiler::OpStats::maxSamples);
+    EXPECT_EQ(s.calls, n);
+    EXPECT_EQ(s.total(), double(n) * (n + 1) / 2);
+    EXPECT_NEAR(s.percentile(50), 0.5 * n, 0.03 * n);
+    EXPECT_NEAR(s.percentile(99), 0.99 * n, 0.005 * n);
+}
+
+TEST(Profiler, Run) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = buildGraph(runtime);
+    auto profiler = make_ref<Profiler>();
+    runtime->setProfiler(profiler);
+    for (int i = 0; i < 10; ++i)
+        runtime->run(g);
+    runtime->setProfiler(nullptr);
+    // Detached, the runtime records nothing.
+    runtime->run(g);
+
+    auto stats = profiler->getStats();
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(profiler->getNumEvents(), 20u);
+    for (size_t i = 0; i < stats.size(); ++i) {
+        EXPECT_EQ(stats[i].calls, 10u);
+        if (i > 0) {
+            EXPECT_GE(stats[i - 1].total(), stats[i].total());
+        }
+    }
+    auto matmul =
+        std::find_if(stats.begin(), stats.end(), [](const auto &s) {
+            return s.kernel == "MatmulNative_CPU";
+        });
+    ASSERT_NE(matmul, stats.end());
+    EXPECT_EQ(matmul->name.rfind("MatMul[", 0), 0u);
+    EXPECT_EQ(matmul->inputs, (vector<Shape>{{64, 128}, {128, 32}}));
+    EXPECT_EQ(matmul->outputs, (vector<Shape>{{64, 32}}));
+    EXPECT_EQ(matmul->bytes, (64 * 128 + 128 * 32 + 64 * 32) * 4u);
+    EXPECT_EQ(matmul->flops, 2. * 64 * 32 * 128);
+    EXPECT_LE(matmul->percentile(50), matmul->percentile(99));
+
+    auto summary = profiler->summary();
+    EXPECT_NE(summary.find("MatmulNative_CPU"), string::npos);
+    EXPECT_NE(summary.find("SoftmaxNative_CPU"), string::npos);
+
+    auto trace = profiler->chromeTrace();
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\"", 0), 0u);
+    size_t count = 0;
+    for (size_t i = trace.find("\"ph\":\"X\""); i != string::npos;
+         i = trace.find("\"ph\":\"X\"", i + 1))
+        ++count;
+    EXPECT_EQ(count, 20u);
+
+    profiler->clear();
+    EXPECT_TRUE(profiler->getStats().empty());
+}
+
+TEST(Profiler, EventCap) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = buildGraph(runtime);
+    auto profiler = make_ref<Profiler>(5);
+    runtime->setProfiler(profiler);
+    for (int i = 0; i < 4; ++i)
+        runtime->run(g);
+    runtime->setProfiler(nullptr);
+    EXPECT_EQ(profiler->getNumEvents(), 5u);
+    for (const auto &s : profiler->getStats())
+        EXPECT_EQ(s.calls, 4u);
+    EXPECT_NE(profiler->chromeTrace().find("\"droppedEvents\":3"),
+              string::npos);
+}
+
+TEST(Profiler, Threads) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g1 = buildGraph(runtime), g2 = buildGraph(runtime);
+    auto profiler = make_ref<Profiler>();
+    runtime->setProfiler(profiler);
+    std::thread t1([&] { runtime->run(g1); });
+    std::thread t2([&] { runtime->run(g2); });
+    t1.join();
+    t2.join();
+    runtime->setProfiler(nullptr);
+    EXPECT_EQ(profiler->getStats().size(), 4u);
+    auto trace = profiler->chromeTrace();
+    EXPECT_NE(trace.find("\"tid\":0"), string::npos);
+    EXPECT_NE(trace.find("\"tid\":1"), string::npos);
+}
+
+} // namespace infini
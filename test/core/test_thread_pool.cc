@@ -0,0 +1,181 @@
+#include "core/runtime.h"
+#include "core/thread_pool.h"
+#include <set>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "test.h"
+
+namespace infini {
+
+TEST(ThreadPool, RunsEveryTask) {
+    std::atomic<int> count{0};
+    std::set<int> workers;
+    std::mutex mutex;
+    {
+        ThreadPool pool(4, [&](int index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            workers.insert(index);
+        });
+        EXPECT_EQ(pool.size(), 4);
+        EXPECT_EQ(pool.currentWorker(), -1);
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&] { ++count; });
+    }
+    // The destructor drains the queues.
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(workers, (std::set<int>{0, 1, 2, 3}));
+}
+
+// Tasks submitted by a worker go to its own deque; idle workers steal them.
+TEST(ThreadPool, Steal) {
+    std::atomic<int> count{0};
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    {
+        ThreadPool pool(4);
+        pool.submit([&] {
+            EXPECT_GE(pool.currentWorker(), 0);
+            for (int i = 0; i < 64; ++i)
+                pool.submit([&] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                    ++count;
+                });
+        });
+    }
+    EXPECT_EQ(count, 64);
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(ThreadPool, ParallelFor) {
+    ThreadPool pool(3);
+    ThreadPool::Scope scope(&pool);
+    EXPECT_EQ(parallelThreads(), 4);
+    for (size_t grain : {1, 7, 1000, 5000}) {
+        vector<std::atomic<int>> hits(1000);
+        parallelFor(hits.size(), grain, [&](size_t begin, size_t end) {
+            EXPECT_LE(end - begin, grain);
+            for (size_t i = begin; i < end; ++i)
+                ++hits[i];
+        });
+        for (auto &hit : hits)
+            EXPECT_EQ(hit, 1);
+    }
+    EXPECT_EQ(evenGrain(10), 3u);
+    EXPECT_EQ(evenGrain(10, false), 10u);
+}
+
+// A parallelFor inside another one runs inline, on the calling thread.
+TEST(ThreadPool, NestedParallelFor) {
+    ThreadPool pool(3);
+    ThreadPool::Scope scope(&pool);
+    std::atomic<int> count{0};
+    parallelFor(8, 1, [&](size_t, size_t) {
+        EXPECT_EQ(parallelThreads(), 1);
+        const auto id = std::this_thread::get_id();
+        parallelFor(16, 1, [&](size_t, size_t) {
+            EXPECT_EQ(std::this_thread::get_id(), id);
+            ++count;
+        });
+    });
+    EXPECT_EQ(count, 8 * 16);
+}
+
+TEST(ThreadPool, ParallelForThrows) {
+    ThreadPool pool(3);
+    ThreadPool::Scope scope(&pool);
+    EXPECT_THROW(parallelFor(100, 1,
+                             [](size_t begin, size_t) {
+                                 if (begin == 42)
+                                     throw std::runtime_error("chunk 42");
+                             }),
+                 std::runtime_error);
+    // The pool is still usable.
+    std::atomic<int> count{0};
+    parallelFor(100, 1, [&](size_t, size_t) { ++count; });
+    EXPECT_EQ(count, 100);
+}
+
+TEST(ThreadPool, Parallelism) {
+    ThreadPool pool(3);
+    ThreadPool::Scope scope(&pool);
+    pool.setParallelism(2);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    parallelFor(64, 1, [&](size_t, size_t) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    EXPECT_LE(threads.size(), 2u);
+    pool.setParallelism(0);
+    EXPECT_EQ(pool.getParallelism(), 4);
+}
+
+// A Scope limits its own thread only, below the limit of the pool.
+TEST(ThreadPool, ScopeParallelism) {
+    ThreadPool pool(3);
+    {
+        ThreadPool::Scope scope(&pool, 2);
+        EXPECT_EQ(parallelThreads(), 2);
+        {
+            ThreadPool::Scope inner(&pool);
+            EXPECT_EQ(parallelThreads(), 4);
+        }
+        EXPECT_EQ(parallelThreads(), 2);
+        pool.setParallelism(1);
+        EXPECT_EQ(parallelThreads(), 1);
+        pool.setParallelism(0);
+        std::thread other([&] {
+            ThreadPool::Scope scope(&pool);
+            EXPECT_EQ(parallelThreads(), 4);
+        });
+        other.join();
+    }
+    EXPECT_EQ(ThreadPool::current(), nullptr);
+}
+
+TEST(ThreadPool, SharedByRuntimes) {
+    auto r1 = make_ref<NativeCpuRuntimeObj>();
+    auto r2 = make_ref<NativeCpuRuntimeObj>();
+    EXPECT_EQ(&r1->getThreadPool(), ThreadPool::getDefault().get());
+    EXPECT_EQ(&r1->getThreadPool(), &r2->getThreadPool());
+    // Limits of one runtime leave the pool and the others alone.
+    r1->setThreads(2, 1);
+    EXPECT_EQ(r1->getThreadPool().getParallelism(),
+              r1->getThreadPool().size() + 1);
+    r1->setThreadPool(ThreadPoolConfig{2});
+    EXPECT_NE(&r1->getThreadPool(), &r2->getThreadPool());
+    EXPECT_EQ(r1->getThreadPool().size(), 2);
+    EXPECT_EQ(&r2->getThreadPool(), ThreadPool::getDefault().get());
+}
+
+#ifdef __linux__
+TEST(ThreadPool, Pinning) {
+    cpu_set_t allowed;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &allowed))
+        ++cpu;
+    ThreadPoolConfig config;
+    config.numThreads = 2;
+    config.cpus = {cpu};
+    std::atomic<int> pinned{0};
+    {
+        ThreadPool pool(config);
+        for (int i = 0; i < 2; ++i)
+            pool.submit([&] {
+                cpu_set_t set;
+                sched_getaffinity(0, sizeof(set), &set);
+                if (CPU_COUNT(&set) == 1 && CPU_ISSET(cpu, &set))
+                    ++pinned;
+            });
+    }
+    EXPECT_EQ(pinned, 2);
+}
+#endif
+
+} // namespace infini
@@ -0,0 +1,151 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "kernels/cpu/simd_kernels.h"
+#include "operators/unary.h"
+#include "utils/float16.h"
+
+#include "test.h"
+
+namespace infini {
+
+template <typename From, typename To>
+static vector<To> runCast(CastType type, DataType inputType,
+                          const vector<From> &input) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({(int)input.size()}, inputType);
+    auto op = g->addOp<CastObj>(i, nullptr, type);
+    g->dataMalloc();
+    std::memcpy(i->getRawDataPtr<void *>(), input.data(),
+                input.size() * sizeof(From));
+    runtime->run(g);
+    auto o = op->getOutput();
+    EXPECT_EQ(o->getDType().getSize(), sizeof(To));
+    auto ptr = o->getRawDataPtr<To *>();
+    return vector<To>(ptr, ptr + o->size());
+}
+
+static const float inf = std::numeric_limits<float>::infinity();
+static const float nan = std::numeric_limits<float>::quiet_NaN();
+
+TEST(Cast, FloatToInt) {
+    vector<float> input{0.f, 1.9f, -1.9f, 127.5f, -200.f, 3e9f, -3e9f,
+                        nan, inf, -inf};
+    EXPECT_EQ((runCast<float, int32_t>(CastType::Float2Int32,
+                                       DataType::Float32, input)),
+              (vector<int32_t>{0, 1, -1, 127, -200, INT32_MAX, INT32_MIN, 0,
+                               INT32_MAX, INT32_MIN}));
+    EXPECT_EQ((runCast<float, int8_t>(CastType::Float2Int8, DataType::Float32,
+                                      input)),
+              (vector<int8_t>{0, 1, -1, 127, -128, 127, -128, 0, 127, -128}));
+    EXPECT_EQ((runCast<float, int64_t>(CastType::Float2Int64,
+                                       DataType::Float32, input)),
+              (vector<int64_t>{0, 1, -1, 127, -200, 3000000000ll,
+                               -3000000000ll, 0, INT64_MAX, INT64_MIN}));
+}
+
+TEST(Cast, IntConversions) {
+    EXPECT_EQ((runCast<int32_t, int8_t>(CastType::Int322Int8, DataType::Int32,
+                                        {1, -1, 300, -129})),
+              (vector<int8_t>{1, -1, 44, 127}));
+    EXPECT_EQ((runCast<int64_t, uint32_t>(CastType::Int642Uint32,
+                                          DataType::Int64,
+                                          {-1, 5, (1ll << 32) + 7})),
+              (vector<uint32_t>{UINT32_MAX, 5, 7}));
+    EXPECT_EQ((runCast<uint8_t, float>(CastType::Uint82Float, DataType::UInt8,
+                                       {0, 1, 255})),
+              (vector<float>{0.f, 1.f, 255.f}));
+    EXPECT_EQ((runCast<int32_t, float>(CastType::Int322Float, DataType::Int32,
+                                       {-7, 16777217, INT32_MIN})),
+              (vector<float>{-7.f, 16777216.f, -2147483648.f}));
+}
+
+TEST(Cast, Float16) {
+    vector<float> input{1.f,
+                        -2.f,
+                        65504.f,
+                        65520.f,          // rounds up to infinity
+                        1.f + 0x1.0p-11f, // tie, rounds to even
+                        1.f + 0x3.0p-11f, // tie, rounds to even
+                        0x1.0p-24f,       // smallest subnormal
+                        0x1.0p-25f,       // tie between 0 and 2^-24
+                        0x3.0p-26f,
+                        inf,
+                        -inf,
+                        nan};
+    auto half = runCast<float, uint16_t>(CastType::Float2Float16,
+                                         DataType::Float32, input);
+    EXPECT_EQ(half, (vector<uint16_t>{0x3c00, 0xc000, 0x7bff, 0x7c00, 0x3c00,
+                                      0x3c02, 0x0001, 0x0000, 0x0001, 0x7c00,
+                                      0xfc00, 0x7e00}));
+    auto back = runCast<uint16_t, float>(CastType::Float162Float,
+                                         DataType::Float16, half);
+    EXPECT_EQ(back[2], 65504.f);
+    EXPECT_EQ(back[6], 0x1.0p-24f);
+    EXPECT_TRUE(std::isnan(back[11]));
+}
+
+TEST(Cast, BFloat16) {
+    vector<float> input{1.f, 1.f + 0x1.0p-8f, 1.f + 0x3.0p-8f, -inf, nan,
+                        0x1.0p-130f};
+    auto bf16 = runCast<float, uint16_t>(CastType::Float2BFloat16,
+                                         DataType::Float32, input);
+    EXPECT_EQ(bf16, (vector<uint16_t>{0x3f80, 0x3f80, 0x3f82, 0xff80, 0x7fc0,
+                                      0x0008}));
+    auto back = runCast<uint16_t, float>(CastType::BFloat162Float,
+                                         DataType::BFloat16, bf16);
+    EXPECT_EQ(back[2], 1.f + 0x1.0p-6f);
+    EXPECT_EQ(back[5], 0x1.0p-130f);
+}
+
+// Every ISA table has to be bit-exact with the scalar conversions: all half
+// and bfloat16 patterns and a strided sweep over the float patterns.
+TEST(Cast, SimdMatchesScalar) {
+    const auto *scalar = getSimdKernels(CpuIsa::Scalar);
+    vector<uint16_t> halfs(1 << 16);
+    for (size_t i = 0; i < halfs.size(); ++i)
+        halfs[i] = uint16_t(i);
+    vector<float> floats;
+    for (uint64_t w = 0; w <= UINT32_MAX; w += 4099)
+        floats.emplace_back(fp32_from_bits(uint32_t(w)));
+    for (float f : {0.f, -0.f, 1.f + 0x1.0p-11f, 0x1.0p-25f, 65520.f, 3e9f,
+                    -2147483648.f, 2147483648.f, inf, nan})
+        floats.emplace_back(f);
+
+    auto bitsEqual = [](const vector<float> &a, const vector<float> &b) {
+        return std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+    };
+    for (auto isa : {CpuIsa::SSE4, CpuIsa::AVX2, CpuIsa::AVX512}) {
+        auto table = getSimdKernels(isa);
+        if (!table)
+            continue;
+        // Odd lengths so that the tails are exercised too.
+        size_t nh = halfs.size() - 3, nf = floats.size();
+        vector<float> expect(nh), out(nh);
+        scalar->f16ToF32(halfs.data(), expect.data(), nh);
+        table->f16ToF32(halfs.data(), out.data(), nh);
+        EXPECT_TRUE(bitsEqual(expect, out)) << cpu_isa_to_str(isa);
+        scalar->bf16ToF32(halfs.data(), expect.data(), nh);
+        table->bf16ToF32(halfs.data(), out.data(), nh);
+        EXPECT_TRUE(bitsEqual(expect, out)) << cpu_isa_to_str(isa);
+
+        vector<uint16_t> expectH(nf), outH(nf);
+        scalar->f32ToF16(floats.data(), expectH.data(), nf);
+        table->f32ToF16(floats.data(), outH.data(), nf);
+        EXPECT_EQ(expectH, outH) << cpu_isa_to_str(isa);
+        scalar->f32ToBf16(floats.data(), expectH.data(), nf);
+        table->f32ToBf16(floats.data(), outH.data(), nf);
+        EXPECT_EQ(expectH, outH) << cpu_isa_to_str(isa);
+
+        vector<int32_t> expectI(nf), outI(nf);
+        scalar->f32ToI32(floats.data(), expectI.data(), nf);
+        table->f32ToI32(floats.data(), outI.data(), nf);
+        EXPECT_EQ(expectI, outI) << cpu_isa_to_str(isa);
+        vector<float> expectF(nf), outF(nf);
+        scalar->i32ToF32(expectI.data(), expectF.data(), nf);
+        table->i32ToF32(expectI.data(), outF.data(), nf);
+        EXPECT_TRUE(bitsEqual(expectF, outF)) << cpu_isa_to_str(isa);
+    }
+}
+
+} // namespace infini
@@ -25,4 +25,50 @@ TEST(Concat, NativeCpu) {
                       6, 7, 8, 1, 1, 1, 9, 10, 11, 1, 1, 1}));
 }
 
+// Any dtype is copied by byte size; checked with 8-bit and 64-bit elements
+// on every axis, including one large enough to be split across threads.
+template <typename T>
+static void testConcatBytes(DataType dtype, const vector<Shape> &shapes,
+                            int dim) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    TensorVec inputs;
+    for (auto &shape : shapes)
+        inputs.emplace_back(g->addTensor(shape, dtype));
+    auto op = g->addOp<ConcatObj>(inputs, nullptr, dim);
+    g->dataMalloc();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        auto ptr = inputs[i]->getRawDataPtr<T *>();
+        for (size_t j = 0; j < inputs[i]->size(); ++j)
+            ptr[j] = T(i * 1000 + j);
+    }
+    runtime->run(g);
+
+    auto output = op->getOutput();
+    auto outDim = output->getDims();
+    auto out = output->getRawDataPtr<T *>();
+    size_t inner = 1;
+    for (size_t d = dim + 1; d < outDim.size(); ++d)
+        inner *= outDim[d];
+    for (size_t o = 0; o < output->size(); ++o) {
+        size_t index = o / inner % outDim[dim];
+        size_t outerIndex = o / inner / outDim[dim];
+        size_t i = 0;
+        while (index >= (size_t)shapes[i][dim])
+            index -= shapes[i++][dim];
+        size_t j = (outerIndex * shapes[i][dim] + index) * inner + o % inner;
+        ASSERT_EQ(out[o], T(i * 1000 + j)) << "dim " << dim << " at " << o;
+    }
+}
+
+TEST(Concat, AnyDataType) {
+    testConcatBytes<int8_t>(DataType::Int8, {{2, 3, 4}, {2, 1, 4}}, 1);
+    testConcatBytes<int8_t>(DataType::Int8, {{2, 3, 4}, {2, 3, 1}}, 2);
+    testConcatBytes<int64_t>(DataType::Int64, {{2, 3, 4}, {5, 3, 4}}, 0);
+    testConcatBytes<int64_t>(DataType::Int64,
+                             {{64, 100, 7}, {64, 3, 7}, {64, 200, 7}}, 1);
+    testConcatBytes<uint16_t>(DataType::Float16, {{2, 3, 4}, {2, 3, 5}}, 2);
+    testConcatBytes<uint16_t>(DataType::BFloat16, {{3, 4}, {2, 4}}, 0);
+}
+
 } // namespace infini
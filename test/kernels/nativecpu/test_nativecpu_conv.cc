@@ -0,0 +1,110 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/conv.h"
+#include "utils/data_generator.h"
+
+#include "test.h"
+
+namespace infini {
+
+struct ConvCase {
+    Shape x, w;
+    int ph, pw, sh, sw, dh, dw;
+    bool bias;
+};
+
+// Direct convolution in double; `b` may be null.
+static vector<double> reference(const ConvCase &p, const Shape &yDims,
+                                const float *x, const float *w,
+                                const float *b) {
+    const int n = p.x[0], c = p.x[1], h = p.x[2], wi = p.x[3];
+    const int f = p.w[0], cpg = p.w[1], r = p.w[2], s = p.w[3];
+    const int oh = yDims[2], ow = yDims[3], fpg = f / (c / cpg);
+    vector<double> y((size_t)n * f * oh * ow);
+    for (int in = 0; in < n; ++in)
+        for (int of = 0; of < f; ++of)
+            for (int oy = 0; oy < oh; ++oy)
+                for (int ox = 0; ox < ow; ++ox) {
+                    double acc = b ? b[of] : 0.;
+                    for (int ic = 0; ic < cpg; ++ic)
+                        for (int i = 0; i < r; ++i)
+                            for (int j = 0; j < s; ++j) {
+                                int iy = oy * p.sh - p.ph + i * p.dh;
+                                int ix = ox * p.sw - p.pw + j * p.dw;
+                                if (iy < 0 || iy >= h || ix < 0 || ix >= wi)
+                                    continue;
+                                int chan = of / fpg * cpg + ic;
+                                acc += double(x[((in * c + chan) * h + iy) *
+                                                    wi +
+                                                ix]) *
+                                       w[((of * cpg + ic) * r + i) * s + j];
+                            }
+                    y[((in * f + of) * oh + oy) * ow + ox] = acc;
+                }
+    return y;
+}
+
+static void check(const ConvCase &p) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(p.x, DataType::Float32);
+    auto w = g->addTensor(p.w, DataType::Float32);
+    auto b = p.bias ? g->addTensor({p.w[0]}, DataType::Float32) : nullptr;
+    auto op = g->addOp<ConvObj>(x, w, nullptr, p.ph, p.pw, p.sh, p.sw, p.dh,
+                                p.dw, b);
+    g->dataMalloc();
+    x->setData(RandomGenerator(-1, 1, 0));
+    w->setData(RandomGenerator(-1, 1, 1));
+    if (p.bias)
+        b->setData(RandomGenerator(-1, 1, 2));
+    runtime->run(g);
+
+    auto expect = reference(p, op->getOutput()->getDims(),
+                            x->getRawDataPtr<float *>(),
+                            w->getRawDataPtr<float *>(),
+                            p.bias ? b->getRawDataPtr<float *>() : nullptr);
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    const size_t k = (size_t)p.w[1] * p.w[2] * p.w[3];
+    for (size_t i = 0; i < expect.size(); ++i)
+        ASSERT_NEAR(out[i], expect[i], 2e-6 * k + 1e-5)
+            << vecToString(p.x) << " " << vecToString(p.w) << " at " << i;
+}
+
+TEST(Conv, General) {
+    check({{1, 3, 7, 8}, {4, 3, 3, 3}, 0, 0, 1, 1, 1, 1, false});
+    check({{2, 3, 9, 10}, {5, 3, 3, 3}, 1, 1, 2, 2, 1, 1, true});
+    check({{1, 4, 11, 9}, {6, 2, 3, 2}, 2, 1, 1, 2, 2, 3, true});
+    check({{1, 3, 12, 12}, {2, 3, 5, 5}, 2, 2, 3, 1, 1, 1, false});
+}
+
+// Enough columns for the unfolded copy to be split into row blocks.
+TEST(Conv, Im2colBlocks) {
+    check({{1, 16, 64, 130}, {8, 16, 3, 3}, 1, 1, 2, 1, 1, 1, true});
+}
+
+TEST(Conv, Pointwise) {
+    check({{2, 8, 5, 7}, {12, 8, 1, 1}, 0, 0, 1, 1, 1, 1, true});
+    check({{1, 8, 5, 7}, {6, 4, 1, 1}, 0, 0, 1, 1, 1, 1, false});
+    // Strided or padded 1x1 convolutions go through im2col.
+    check({{1, 8, 6, 7}, {4, 8, 1, 1}, 1, 0, 2, 2, 1, 1, true});
+}
+
+TEST(Conv, Depthwise) {
+    check({{2, 6, 10, 11}, {6, 1, 3, 3}, 1, 1, 1, 1, 1, 1, true});
+    check({{1, 4, 13, 12}, {4, 1, 5, 3}, 2, 1, 2, 3, 1, 1, false});
+    check({{1, 4, 9, 9}, {8, 1, 3, 3}, 2, 2, 1, 1, 2, 2, true});
+    check({{1, 32, 56, 56}, {32, 1, 3, 3}, 1, 1, 1, 1, 1, 1, true});
+}
+
+// 3x3 with stride 1 and at least 16 channels per group, with odd output
+// sizes for partial tiles.
+TEST(Conv, Winograd) {
+    check({{1, 16, 8, 8}, {16, 16, 3, 3}, 1, 1, 1, 1, 1, 1, false});
+    check({{2, 16, 11, 13}, {24, 16, 3, 3}, 1, 1, 1, 1, 1, 1, true});
+    check({{1, 20, 9, 7}, {17, 20, 3, 3}, 0, 2, 1, 1, 1, 1, true});
+    check({{1, 32, 10, 9}, {32, 16, 3, 3}, 1, 1, 1, 1, 1, 1, true});
+    // More tiles than one block.
+    check({{1, 32, 70, 70}, {32, 32, 3, 3}, 1, 1, 1, 1, 1, 1, true});
+}
+
+} // namespace infini
@@ -1,6 +1,9 @@
 #include "core/graph.h"
 #include "core/runtime.h"
+#include "kernels/cpu/broadcast.h"
 #include "operators/element_wise.h"
+#include "utils/float16.h"
+#include "utils/operator_utils.h"
 
 #include "test.h"
 
@@ -41,4 +44,148 @@ TEST(ElementWise, NativeCpu) {
         Shape{2, 1, 1}, ExpectOutput{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
 }
 
+TEST(ElementWise, BroadcastPlan) {
+    BroadcastPlan same({2, 3, 4}, {2, 3, 4}, {2, 3, 4});
+    EXPECT_EQ(same.kind, BroadcastPlan::Kind::SameShape);
+    EXPECT_EQ(same.rank, 1);
+    EXPECT_EQ(same.size, 24u);
+
+    BroadcastPlan scalar({2, 3, 4}, {1}, {2, 3, 4});
+    EXPECT_EQ(scalar.kind, BroadcastPlan::Kind::ScalarB);
+    EXPECT_EQ(scalar.rank, 1);
+
+    BroadcastPlan row({2, 1, 3, 4}, {3, 4}, {2, 1, 3, 4});
+    EXPECT_EQ(row.kind, BroadcastPlan::Kind::Row);
+    EXPECT_EQ(row.rank, 2);
+    EXPECT_EQ(row.dims[0], 2u);
+    EXPECT_EQ(row.dims[1], 12u);
+    EXPECT_EQ(row.strideB[0], 0u);
+
+    BroadcastPlan column({4, 1}, {4, 5}, {4, 5});
+    EXPECT_EQ(column.kind, BroadcastPlan::Kind::ColumnA);
+    EXPECT_EQ(column.strideA[0], 1u);
+    EXPECT_EQ(column.strideA[1], 0u);
+
+    BroadcastPlan general({2, 1, 4}, {3, 1}, {2, 3, 4});
+    EXPECT_EQ(general.kind, BroadcastPlan::Kind::ColumnB);
+    EXPECT_EQ(general.rank, 3);
+
+    // Runs started mid-way continue with the right offsets.
+    vector<size_t> offsetsB;
+    general.forEachRun(5, 24, [&](size_t oc, size_t oa, size_t ob,
+                                  size_t len) {
+        for (size_t i = 0; i < len; ++i)
+            offsetsB.push_back(ob + i * general.strideB[2]);
+    });
+    ASSERT_EQ(offsetsB.size(), 19u);
+    for (size_t i = 5; i < 24; ++i)
+        EXPECT_EQ(offsetsB[i - 5], i / 4 % 3);
+}
+
+// Compares every broadcast pattern against index-by-index evaluation.
+TEST(ElementWise, BroadcastMatchesReference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    vector<pair<Shape, Shape>> cases{
+        {{7, 5, 33}, {7, 5, 33}}, {{7, 5, 33}, {1}},
+        {{1}, {7, 5, 33}},        {{7, 5, 33}, {33}},
+        {{7, 5, 1}, {7, 5, 33}},  {{7, 1, 33}, {5, 1}},
+        {{2, 1, 3, 1, 5}, {4, 1, 6, 1}},
+        // Large enough to be split across threads.
+        {{64, 1, 300}, {20, 300}},
+        {{64, 20, 1}, {64, 20, 300}}};
+    for (auto &[shapeA, shapeB] : cases) {
+        for (auto isDiv : {false, true}) {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto a = g->addTensor(shapeA, DataType::Float32);
+            auto b = g->addTensor(shapeB, DataType::Float32);
+            Operator op;
+            if (isDiv)
+                op = g->addOp<DivObj>(a, b, nullptr);
+            else
+                op = g->addOp<SubObj>(a, b, nullptr);
+            g->dataMalloc();
+            a->setData(IncrementalGenerator());
+            b->setData(ValGenerator<3>());
+            auto pb = b->getRawDataPtr<float *>();
+            for (size_t i = 0; i < b->size(); ++i)
+                pb[i] += i;
+            runtime->run(g);
+
+            auto c = op->getOutput();
+            auto shapeC = c->getDims();
+            auto rank = shapeC.size();
+            auto align = [&](Shape s) {
+                s.insert(s.begin(), rank - s.size(), 1);
+                Shape stride(rank);
+                for (int i = rank - 1, p = 1; i >= 0; p *= s[i--])
+                    stride[i] = p;
+                return pair{s, stride};
+            };
+            auto [alignedA, strideA] = align(shapeA);
+            auto [alignedB, strideB] = align(shapeB);
+            auto pa = a->getRawDataPtr<float *>();
+            auto pc = c->getRawDataPtr<float *>();
+            for (size_t i = 0; i < c->size(); ++i) {
+                auto index = locate_index(i, shapeC);
+                float x = pa[delocate_index(index, alignedA, strideA)];
+                float y = pb[delocate_index(index, alignedB, strideB)];
+                ASSERT_EQ(pc[i], isDiv ? x / y : x - y) << vecToString(shapeA)
+                                                         << vecToString(shapeB);
+            }
+        }
+    }
+}
+
+// Float16 and BFloat16 compute in fp32 and round once, so they match the
+// rounded Float32 result on the decoded inputs exactly.
+template <class T>
+static void testElementWiseHalf(DataType dtype, const Shape &shape1,
+                                const Shape &shape2) {
+    const bool bf16 = dtype == DataType::BFloat16;
+    auto encode = [&](float f) {
+        return bf16 ? float_to_bfloat16(f) : float_to_float16(f);
+    };
+    auto decode = [&](uint16_t h) {
+        return bf16 ? bfloat16_to_float(h) : float16_to_float(h);
+    };
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto t1 = g->addTensor(shape1, dtype);
+    auto t2 = g->addTensor(shape2, dtype);
+    auto op = g->addOp<T>(t1, t2, nullptr);
+    g->dataMalloc();
+    for (Tensor t : {t1, t2})
+        for (size_t i = 0; i < t->size(); ++i)
+            t->getRawDataPtr<uint16_t *>()[i] =
+                encode(float(i % 29) * 0.37f - 5.f);
+    runtime->run(g);
+
+    Tensor out = op->getOutput();
+    BroadcastPlan plan(shape1, shape2, out->getDims());
+    auto a = t1->getRawDataPtr<uint16_t *>(), b = t2->getRawDataPtr<uint16_t *>();
+    auto c = out->getRawDataPtr<uint16_t *>();
+    plan.forEachRun(0, plan.size, [&](size_t oc, size_t oa, size_t ob,
+                                      size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            float x = decode(a[oa + (plan.strideA[plan.rank - 1] ? i : 0)]);
+            float y = decode(b[ob + (plan.strideB[plan.rank - 1] ? i : 0)]);
+            float expect = op->getOpType() == OpType::Add   ? x + y
+                           : op->getOpType() == OpType::Sub ? x - y
+                           : op->getOpType() == OpType::Mul ? x * y
+                                                            : x / y;
+            ASSERT_EQ(c[oc + i], encode(expect))
+                << dtype.toString() << " at " << oc + i;
+        }
+    });
+}
+
+TEST(ElementWise, NativeCpuHalf) {
+    for (auto dtype : {DataType::Float16, DataType::BFloat16}) {
+        testElementWiseHalf<AddObj>(dtype, {3, 700, 37}, {3, 700, 37});
+        testElementWiseHalf<SubObj>(dtype, {3, 700, 37}, {37});
+        testElementWiseHalf<MulObj>(dtype, {3, 1, 37}, {700, 1});
+        testElementWiseHalf<DivObj>(dtype, {1}, {5, 7});
+    }
+}
+
 } // namespace infini
@@ -0,0 +1,48 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/fused_element_wise.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Large enough for several blocks per chunk and several chunks, with a row
+// and a column broadcast input.
+TEST(FusedElementWise, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({3, 700, 37}, DataType::Float32);
+    auto bias = g->addTensor({37}, DataType::Float32);
+    auto scale = g->addTensor({700, 1}, DataType::Float32);
+    // sigmoid(clip((x + bias) * scale, -1, 2) - x)
+    vector<FusedStep> steps{
+        {OpType::Add, 3, 0, 1, 0, 0},
+        {OpType::Mul, 3, 3, 2, 0, 0},
+        {OpType::Clip, 3, 3, -1, -1.f, 2.f},
+        {OpType::Sub, 4, 3, 0, 0, 0},
+        {OpType::Sigmoid, 3, 4, -1, 0, 0},
+    };
+    auto op = g->addOp<FusedElementWiseObj>(TensorVec{x, bias, scale},
+                                            nullptr, steps, 5);
+    EXPECT_EQ(op->getOutput()->getDims(), (Shape{3, 700, 37}));
+    g->dataMalloc();
+    auto xs = x->getRawDataPtr<float *>();
+    auto bs = bias->getRawDataPtr<float *>();
+    auto ss = scale->getRawDataPtr<float *>();
+    for (size_t i = 0; i < x->size(); ++i)
+        xs[i] = float(i % 101) * 0.03f - 1.5f;
+    for (size_t i = 0; i < bias->size(); ++i)
+        bs[i] = float(i) * 0.1f - 2.f;
+    for (size_t i = 0; i < scale->size(); ++i)
+        ss[i] = float(i % 7) * 0.5f - 1.f;
+    runtime->run(g);
+
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    for (size_t i = 0; i < x->size(); ++i) {
+        double v = (double(xs[i]) + bs[i % 37]) * ss[i / 37 % 700];
+        v = std::min(2., std::max(-1., v)) - xs[i];
+        ASSERT_NEAR(out[i], 1 / (1 + std::exp(-v)), 1e-6) << i;
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,165 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/gather.h"
+#include "utils/data_generator.h"
+#include <cstring>
+
+#include "test.h"
+
+namespace infini {
+
+using Mode = EmbeddingBagObj::Mode;
+
+template <typename T> static void fill(Tensor t, const vector<T> &values) {
+    ASSERT_EQ(t->size(), values.size());
+    std::memcpy(t->getRawDataPtr<void *>(), values.data(),
+                values.size() * sizeof(T));
+}
+
+TEST(Gather, Axes) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    const Shape dims{3, 4, 5};
+    const vector<int64_t> idx{2, 0, 1, 1, 1, 0};
+    for (int axis = 0; axis < 3; ++axis) {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto data = g->addTensor(dims, DataType::Float32);
+        auto indices = g->addTensor({2, 3}, DataType::Int64);
+        auto op = g->addOp<GatherObj>(data, indices, nullptr, axis);
+        g->dataMalloc();
+        data->setData(RandomGenerator(-10, 10));
+        fill(indices, idx);
+        runtime->run(g);
+
+        auto in = data->getRawDataPtr<float *>();
+        const int outer = axis == 0 ? 1 : axis == 1 ? 3 : 12;
+        const int size = dims[axis];
+        const int inner = axis == 0 ? 20 : axis == 1 ? 5 : 1;
+        auto out = op->getOutput()->getRawDataPtr<float *>();
+        for (int o = 0; o < outer; ++o)
+            for (int i = 0; i < 6; ++i)
+                for (int k = 0; k < inner; ++k)
+                    ASSERT_EQ(out[(o * 6 + i) * inner + k],
+                              in[(o * size + idx[i]) * inner + k])
+                        << axis;
+    }
+}
+
+TEST(Gather, LargeInt32) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto data = g->addTensor({1000, 64}, DataType::Int32);
+    auto indices = g->addTensor({5000}, DataType::Int32);
+    auto op = g->addOp<GatherObj>(data, indices, nullptr);
+    g->dataMalloc();
+    vector<int32_t> in(data->size()), idx(5000);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = int32_t(i * 2654435761u);
+    for (size_t i = 0; i < idx.size(); ++i)
+        idx[i] = int32_t(i * 7919 % 2000) - 1000;
+    fill(data, in);
+    fill(indices, idx);
+    runtime->run(g);
+    auto out = op->getOutput()->getRawDataPtr<int32_t *>();
+    for (size_t i = 0; i < idx.size(); ++i) {
+        const size_t row = idx[i] < 0 ? idx[i] + 1000 : idx[i];
+        ASSERT_EQ(std::memcmp(out + i * 64, in.data() + row * 64,
+                              64 * sizeof(int32_t)),
+                  0)
+            << i;
+    }
+}
+
+TEST(Gather, OutOfRange) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto data = g->addTensor({4, 2}, DataType::Float32);
+    auto indices = g->addTensor({2}, DataType::Int64);
+    g->addOp<GatherObj>(data, indices, nullptr);
+    g->dataMalloc();
+    fill(indices, vector<int64_t>{1, 4});
+    EXPECT_THROW(runtime->run(g), Exception);
+}
+
+static void checkBags(Mode mode, bool useOffsets, DataType indexType) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    const int num = 500, dim = 70, bags = 64, len = 20;
+    const int n = bags * len;
+    // With offsets the bags grow from empty to about twice the mean length.
+    vector<int64_t> begin;
+    for (int b = 0; b < bags; ++b)
+        begin.emplace_back(useOffsets ? b * (b - 1) * len / (bags - 1)
+                                      : b * len);
+    auto weight = g->addTensor({num, dim}, DataType::Float32);
+    auto indices = g->addTensor(useOffsets ? Shape{n} : Shape{bags, len},
+                                indexType);
+    auto offsets =
+        useOffsets ? g->addTensor({bags}, indexType) : Tensor(nullptr);
+    auto op = g->addOp<EmbeddingBagObj>(weight, indices, offsets, nullptr,
+                                        mode);
+    g->dataMalloc();
+    weight->setData(RandomGenerator(-10, 10));
+    vector<int64_t> idx(n);
+    for (int i = 0; i < n; ++i)
+        idx[i] = int64_t(i * 7919 % (2 * num)) - num;
+    if (indexType == DataType::Int32) {
+        fill(indices, vector<int32_t>(idx.begin(), idx.end()));
+        if (useOffsets)
+            fill(offsets, vector<int32_t>(begin.begin(), begin.end()));
+    } else {
+        fill(indices, idx);
+        if (useOffsets)
+            fill(offsets, begin);
+    }
+    runtime->run(g);
+
+    begin.emplace_back(n);
+    auto w = weight->getRawDataPtr<float *>();
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    for (int b = 0; b < bags; ++b)
+        for (int k = 0; k < dim; ++k) {
+            double acc = mode == Mode::Max ? -INFINITY : 0.;
+            for (int i = begin[b]; i < begin[b + 1]; ++i) {
+                double v = w[(idx[i] < 0 ? idx[i] + num : idx[i]) * dim + k];
+                acc = mode == Mode::Max ? std::max(acc, v) : acc + v;
+            }
+            const int count = begin[b + 1] - begin[b];
+            if (count == 0)
+                acc = 0;
+            else if (mode == Mode::Mean)
+                acc /= count;
+            ASSERT_NEAR(out[b * dim + k], acc, 1e-4)
+                << int(mode) << " bag " << b << " column " << k;
+        }
+}
+
+TEST(EmbeddingBag, Offsets) {
+    for (Mode mode : {Mode::Sum, Mode::Mean, Mode::Max}) {
+        checkBags(mode, true, DataType::Int64);
+        checkBags(mode, true, DataType::Int32);
+    }
+}
+
+TEST(EmbeddingBag, FixedLength) {
+    for (Mode mode : {Mode::Sum, Mode::Mean, Mode::Max})
+        checkBags(mode, false, DataType::Int64);
+}
+
+TEST(EmbeddingBag, BadOffsets) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto weight = g->addTensor({4, 2}, DataType::Float32);
+    auto indices = g->addTensor({3}, DataType::Int64);
+    auto offsets = g->addTensor({2}, DataType::Int64);
+    g->addOp<EmbeddingBagObj>(weight, indices, offsets, nullptr);
+    g->dataMalloc();
+    fill(indices, vector<int64_t>{0, 1, 2});
+    fill(offsets, vector<int64_t>{0, 2});
+    EXPECT_NO_THROW(runtime->run(g));
+    fill(offsets, vector<int64_t>{1, 2});
+    EXPECT_THROW(runtime->run(g), Exception);
+    fill(offsets, vector<int64_t>{0, 4});
+    EXPECT_THROW(runtime->run(g), Exception);
+}
+
+} // namespace infini
@@ -0,0 +1,247 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "utils/float16.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Reference matmul on the broadcast batch, straight from the definition.
+static vector<float> matmulReference(const Tensor &A, const Tensor &B,
+                                     const Tensor &C, bool transA,
+                                     bool transB) {
+    auto shapeA = A->getDims(), shapeB = B->getDims(), shapeC = C->getDims();
+    int rankA = shapeA.size(), rankB = shapeB.size(), rankC = shapeC.size();
+    int m = shapeC[rankC - 2], n = shapeC[rankC - 1];
+    int k = transA ? shapeA[rankA - 2] : shapeA[rankA - 1];
+    auto a = A->getRawDataPtr<float *>(), b = B->getRawDataPtr<float *>();
+    size_t batch = C->size() / (m * n);
+    vector<float> ans(C->size());
+    for (size_t bc = 0; bc < batch; ++bc) {
+        size_t offA = 0, offB = 0, strideA = 1, strideB = 1, rest = bc;
+        for (int i = rankC - 3; i >= 0; --i) {
+            size_t idx = rest % shapeC[i];
+            rest /= shapeC[i];
+            int iA = i - (rankC - rankA), iB = i - (rankC - rankB);
+            if (iA >= 0) {
+                offA += (shapeA[iA] == 1 ? 0 : idx) * strideA;
+                strideA *= shapeA[iA];
+            }
+            if (iB >= 0) {
+                offB += (shapeB[iB] == 1 ? 0 : idx) * strideB;
+                strideB *= shapeB[iB];
+            }
+        }
+        const float *pa = a + offA * shapeA[rankA - 2] * shapeA[rankA - 1];
+        const float *pb = b + offB * shapeB[rankB - 2] * shapeB[rankB - 1];
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < n; ++j) {
+                double acc = 0;
+                for (int p = 0; p < k; ++p)
+                    acc += double(transA ? pa[p * m + i] : pa[i * k + p]) *
+                           (transB ? pb[j * k + p] : pb[p * n + j]);
+                ans[bc * m * n + i * n + j] = acc;
+            }
+    }
+    return ans;
+}
+
+static void testMatmulNativeCpu(const Shape &shapeA, const Shape &shapeB,
+                                bool transA, bool transB) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor(shapeA, DataType::Float32);
+    auto B = g->addTensor(shapeB, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr, transA, transB);
+    g->dataMalloc();
+    A->setData(RandomGenerator(-1, 1, 1));
+    B->setData(RandomGenerator(-1, 1, 2));
+
+    runtime->run(g);
+    auto C = op->getOutput();
+    auto ans = matmulReference(A, B, C, transA, transB);
+    auto out = C->getRawDataPtr<float *>();
+    for (size_t i = 0; i < ans.size(); ++i)
+        ASSERT_NEAR(out[i], ans[i], 1e-4 * (1 + std::fabs(ans[i])))
+            << "at " << i;
+}
+
+TEST(Matmul, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor({1, 2, 3}, DataType::Float32);
+    auto B = g->addTensor({1, 3, 2}, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr);
+    g->dataMalloc();
+    A->setData(IncrementalGenerator());
+    B->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(vector<float>{10, 13, 28, 40}));
+}
+
+TEST(Matmul, NativeCpuTranspose) {
+    testMatmulNativeCpu({7, 5}, {5, 9}, false, false);
+    testMatmulNativeCpu({5, 7}, {5, 9}, true, false);
+    testMatmulNativeCpu({7, 5}, {9, 5}, false, true);
+    testMatmulNativeCpu({5, 7}, {9, 5}, true, true);
+}
+
+TEST(Matmul, NativeCpuBroadcast) {
+    testMatmulNativeCpu({2, 3, 13, 17}, {17, 11}, false, false);
+    testMatmulNativeCpu({2, 1, 17, 13}, {3, 11, 17}, true, true);
+    testMatmulNativeCpu({1, 4, 9}, {3, 9, 6}, false, false);
+}
+
+TEST(Matmul, NativeCpuBlocked) {
+    // Larger than one cache block along every dimension, with ragged edges.
+    testMatmulNativeCpu({1100, 601}, {601, 307}, false, false);
+    testMatmulNativeCpu({601, 263}, {4200, 601}, true, true);
+}
+
+// act(A * B + bias + residual), with every part of the epilogue on both the
+// stacked and the per-batch paths; k spans several cache blocks.
+static void testMatmulEpilogue(const Shape &shapeA, const Shape &shapeB,
+                               OpType act) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor(shapeA, DataType::Float32);
+    auto B = g->addTensor(shapeB, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr);
+    auto C = op->getOutput();
+    auto bias = g->addTensor({1, C->getDims().back()}, DataType::Float32);
+    auto residual = g->addTensor(C->getDims(), DataType::Float32);
+    op->setBias(bias);
+    op->setResidual(residual);
+    op->setActivation(act, -0.5f, 0.5f);
+    g->dataMalloc();
+    A->setData(RandomGenerator(-1, 1, 1));
+    B->setData(RandomGenerator(-1, 1, 2));
+    bias->setData(RandomGenerator(-1, 1, 3));
+    residual->setData(RandomGenerator(-1, 1, 4));
+
+    runtime->run(g);
+    auto ans = matmulReference(A, B, C, false, false);
+    auto out = C->getRawDataPtr<float *>();
+    auto b = bias->getRawDataPtr<float *>();
+    auto r = residual->getRawDataPtr<float *>();
+    const size_t n = C->getDims().back();
+    for (size_t i = 0; i < ans.size(); ++i) {
+        double v = ans[i] + b[i % n] + r[i];
+        if (act == OpType::Relu)
+            v = std::max(v, 0.);
+        else if (act == OpType::Clip)
+            v = std::min(std::max(v, -0.5), 0.5);
+        else if (act == OpType::Gelu)
+            v = 0.5 * v * std::erfc(-v / std::sqrt(2.));
+        ASSERT_NEAR(out[i], v, 1e-4 * (1 + std::fabs(v)))
+            << act.toString() << " at " << i;
+    }
+}
+
+TEST(Matmul, NativeCpuEpilogue) {
+    for (auto act : {OpType::Relu, OpType::Clip, OpType::Gelu}) {
+        testMatmulEpilogue({3, 70, 601}, {601, 37}, act);
+        testMatmulEpilogue({2, 33, 19}, {2, 19, 21}, act);
+    }
+}
+
+// Int8 (or UInt8) A times Int8 B accumulates exactly into Int32; the
+// reference runs on Float32 copies of the operands. Values cover the whole
+// range of both types, including -128 and 255.
+static void testMatmulInt8(DataType typeA, const Shape &shapeA,
+                           const Shape &shapeB, bool transA, bool transB) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor(shapeA, typeA);
+    auto B = g->addTensor(shapeB, DataType::Int8);
+    auto Af = g->addTensor(shapeA, DataType::Float32);
+    auto Bf = g->addTensor(shapeB, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr, transA, transB);
+    auto ref = g->addOp<MatmulObj>(Af, Bf, nullptr, transA, transB);
+    ASSERT_EQ(op->getOutput()->getDType(), DataType::Int32);
+    g->dataMalloc();
+    uint32_t seed = 7;
+    for (auto [t, f] : {std::make_pair(A, Af), std::make_pair(B, Bf)}) {
+        const bool isUnsigned = t->getDType() == DataType::UInt8;
+        for (size_t i = 0; i < t->size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            uint8_t byte = seed >> 24;
+            t->getRawDataPtr<uint8_t *>()[i] = byte;
+            f->getRawDataPtr<float *>()[i] =
+                isUnsigned ? float(byte) : float(int8_t(byte));
+        }
+    }
+
+    runtime->run(g);
+    auto ans = matmulReference(Af, Bf, ref->getOutput(), transA, transB);
+    auto out = op->getOutput()->getRawDataPtr<int32_t *>();
+    for (size_t i = 0; i < ans.size(); ++i)
+        ASSERT_EQ(out[i], int32_t(ans[i])) << typeA.toString() << " at " << i;
+}
+
+TEST(Matmul, NativeCpuInt8) {
+    for (auto typeA : {DataType::Int8, DataType::UInt8}) {
+        testMatmulInt8(typeA, {7, 5}, {5, 9}, false, false);
+        testMatmulInt8(typeA, {5, 7}, {9, 5}, true, true);
+        testMatmulInt8(typeA, {2, 3, 13, 17}, {17, 11}, false, false);
+        testMatmulInt8(typeA, {2, 1, 17, 13}, {3, 11, 17}, true, true);
+        // Several k blocks, with k not a multiple of the groups of 4.
+        testMatmulInt8(typeA, {301, 1203}, {1203, 77}, false, false);
+        testMatmulInt8(typeA, {1203, 45}, {130, 1203}, true, true);
+    }
+}
+
+// Float16 and BFloat16 against the Float32 kernel on the same (decoded)
+// values: the fp32 accumulation leaves only the final rounding, plus the
+// summation order.
+static void testMatmulHalf(DataType dtype, const Shape &shapeA,
+                           const Shape &shapeB, bool transB) {
+    const bool bf16 = dtype == DataType::BFloat16;
+    auto decode = [&](uint16_t h) {
+        return bf16 ? bfloat16_to_float(h) : float16_to_float(h);
+    };
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    vector<vector<float>> results;
+    for (auto type : {dtype, DataType::Float32}) {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto A = g->addTensor(shapeA, type);
+        auto B = g->addTensor(shapeB, type);
+        auto op = g->addOp<MatmulObj>(A, B, nullptr, false, transB);
+        g->dataMalloc();
+        uint32_t seed = 1;
+        for (auto &t : {A, B})
+            for (size_t i = 0; i < t->size(); ++i) {
+                seed = seed * 1664525u + 1013904223u;
+                float v = float(seed >> 8) * 0x1p-23f - 1.f;
+                uint16_t h = bf16 ? float_to_bfloat16(v) : float_to_float16(v);
+                if (type == DataType::Float32)
+                    t->getRawDataPtr<float *>()[i] = decode(h);
+                else
+                    t->getRawDataPtr<uint16_t *>()[i] = h;
+            }
+        runtime->run(g);
+        auto C = op->getOutput();
+        vector<float> out(C->size());
+        for (size_t i = 0; i < out.size(); ++i)
+            out[i] = type == DataType::Float32
+                         ? C->getRawDataPtr<float *>()[i]
+                         : decode(C->getRawDataPtr<uint16_t *>()[i]);
+        results.emplace_back(out);
+    }
+    const float eps = bf16 ? 0x1p-8f : 0x1p-11f;
+    for (size_t i = 0; i < results[0].size(); ++i)
+        ASSERT_NEAR(results[0][i], results[1][i],
+                    eps * std::fabs(results[1][i]) + 1e-4f)
+            << dtype.toString() << " at " << i;
+}
+
+TEST(Matmul, NativeCpuHalf) {
+    for (auto dtype : {DataType::Float16, DataType::BFloat16}) {
+        testMatmulHalf(dtype, {2, 37, 601}, {601, 29}, false);
+        testMatmulHalf(dtype, {2, 13, 17}, {2, 11, 17}, true);
+    }
+}
+
+} // namespace infini
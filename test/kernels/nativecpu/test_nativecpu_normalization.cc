@@ -0,0 +1,90 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/normalization.h"
+#include "utils/data_generator.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Normalizes every row of `size` elements in double with the two-pass
+// formulas; `beta` may be null.
+static vector<double> reference(bool rms, const float *x, size_t n,
+                                const float *gamma, const float *beta,
+                                size_t size, float eps) {
+    vector<double> y(n);
+    for (size_t r = 0; r < n / size; ++r) {
+        const float *row = x + r * size;
+        double mean = 0, square = 0;
+        if (!rms) {
+            for (size_t i = 0; i < size; ++i)
+                mean += row[i];
+            mean /= size;
+        }
+        for (size_t i = 0; i < size; ++i)
+            square += (row[i] - mean) * (row[i] - mean);
+        const double inv = 1 / std::sqrt(square / size + eps);
+        for (size_t i = 0; i < size; ++i)
+            y[r * size + i] = (row[i] - mean) * inv * gamma[i] +
+                              (beta ? beta[i] : 0.);
+    }
+    return y;
+}
+
+static void check(bool rms, const Shape &dims, int axis, bool withBias,
+                  float offset = 0.f) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(dims, DataType::Float32);
+    const int realAxis = axis < 0 ? axis + int(dims.size()) : axis;
+    const Shape row(dims.begin() + realAxis, dims.end());
+    auto scale = g->addTensor(row, DataType::Float32);
+    auto bias = withBias ? g->addTensor(row, DataType::Float32) : nullptr;
+    const float eps = 1e-5f;
+    Operator op;
+    if (rms)
+        op = g->addOp<RMSNormObj>(x, scale, nullptr, axis, eps);
+    else
+        op = g->addOp<LayerNormObj>(x, scale, bias, nullptr, axis, eps);
+    g->dataMalloc();
+    x->setData(RandomGenerator(offset - 3, offset + 3, 0));
+    scale->setData(RandomGenerator(-2, 4, 1));
+    if (withBias)
+        bias->setData(RandomGenerator(-3, 3, 2));
+    runtime->run(g);
+
+    auto expect =
+        reference(rms, x->getRawDataPtr<float *>(), x->size(),
+                  scale->getRawDataPtr<float *>(),
+                  withBias ? bias->getRawDataPtr<float *>() : nullptr,
+                  scale->size(), eps);
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    for (size_t i = 0; i < expect.size(); ++i)
+        ASSERT_NEAR(out[i], expect[i], 2e-5 * (1 + std::abs(expect[i])))
+            << vecToString(dims) << " axis " << axis << " at " << i;
+}
+
+TEST(LayerNorm, Rows) {
+    check(false, {3, 5, 7}, -1, true);
+    check(false, {3, 5, 7}, 1, true);
+    check(false, {3, 5, 7}, 0, false);
+    check(false, {4, 33}, -1, false);
+    check(false, {6, 1}, -1, true);
+}
+
+// Enough rows for several threads, and rows long enough for the vector
+// loops; the offset makes the mean large next to the spread, which the
+// one-pass variance must cope with.
+TEST(LayerNorm, Large) {
+    check(false, {512, 768}, -1, true);
+    check(false, {16, 4099}, -1, true, 100.f);
+}
+
+TEST(RMSNorm, Rows) {
+    check(true, {3, 5, 7}, -1, false);
+    check(true, {3, 5, 7}, 1, false);
+    check(true, {4, 33}, -1, false, 2.f);
+    check(true, {512, 768}, -1, false);
+}
+
+} // namespace infini
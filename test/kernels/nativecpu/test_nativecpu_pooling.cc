@@ -0,0 +1,130 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/pooling.h"
+#include "utils/data_generator.h"
+
+#include "test.h"
+
+namespace infini {
+
+struct PoolCase {
+    Shape x;
+    int kh, kw, dh, dw, ph, pw, sh, sw;
+    bool ceilMode;
+};
+
+// Window by window, padding excluded from the averages, which are 0 for
+// windows without taps.
+static vector<double> reference(bool isMax, const PoolCase &p,
+                                const Shape &yDims, const float *x) {
+    const int n = p.x[0], c = p.x[1], h = p.x[2], w = p.x[3];
+    const int oh = yDims[2], ow = yDims[3];
+    vector<double> y((size_t)n * c * oh * ow);
+    for (int nc = 0; nc < n * c; ++nc)
+        for (int oy = 0; oy < oh; ++oy)
+            for (int ox = 0; ox < ow; ++ox) {
+                double acc = isMax ? -INFINITY : 0.;
+                int count = 0;
+                for (int i = 0; i < p.kh; ++i)
+                    for (int j = 0; j < p.kw; ++j) {
+                        int iy = oy * p.sh - p.ph + i * p.dh;
+                        int ix = ox * p.sw - p.pw + j * p.dw;
+                        if (iy < 0 || iy >= h || ix < 0 || ix >= w)
+                            continue;
+                        double v = x[((size_t)nc * h + iy) * w + ix];
+                        acc = isMax ? std::max(acc, v) : acc + v;
+                        ++count;
+                    }
+                y[((size_t)nc * oh + oy) * ow + ox] =
+                    isMax ? acc : count ? acc / count : 0.;
+            }
+    return y;
+}
+
+static void check(bool isMax, const PoolCase &p) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(p.x, DataType::Float32);
+    Operator op;
+    if (isMax)
+        op = g->addOp<MaxPoolObj>(x, nullptr, p.kh, p.kw, p.dh, p.dw, p.ph,
+                                  p.pw, p.sh, p.sw, p.ceilMode);
+    else
+        op = g->addOp<AvgPoolObj>(x, nullptr, p.kh, p.kw, p.dh, p.dw, p.ph,
+                                  p.pw, p.sh, p.sw, p.ceilMode);
+    g->dataMalloc();
+    x->setData(RandomGenerator(-10, 10));
+    runtime->run(g);
+    auto expect = reference(isMax, p, op->getOutput()->getDims(),
+                            x->getRawDataPtr<float *>());
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    for (size_t i = 0; i < expect.size(); ++i) {
+        if (isMax)
+            ASSERT_EQ(out[i], float(expect[i]))
+                << vecToString(p.x) << " at " << i;
+        else
+            ASSERT_NEAR(out[i], expect[i], 1e-5)
+                << vecToString(p.x) << " at " << i;
+    }
+}
+
+static const PoolCase cases[] = {
+    {{1, 1, 4, 4}, 2, 2, 1, 1, 0, 0, 2, 2, false},
+    {{2, 3, 10, 11}, 3, 3, 1, 1, 1, 1, 2, 2, false},
+    {{1, 20, 9, 13}, 3, 3, 1, 1, 1, 1, 1, 1, false},
+    {{1, 17, 12, 12}, 2, 3, 2, 1, 1, 1, 3, 2, true},
+    {{2, 5, 7, 8}, 3, 2, 1, 1, 1, 0, 2, 2, true},
+    {{1, 33, 112, 112}, 3, 3, 1, 1, 1, 1, 2, 2, false},
+    {{1, 16, 300, 300}, 5, 5, 1, 1, 2, 2, 1, 1, false}};
+
+TEST(Pooling, MaxPool) {
+    for (const auto &p : cases)
+        check(true, p);
+}
+
+TEST(Pooling, AveragePool) {
+    for (const auto &p : cases)
+        check(false, p);
+}
+
+TEST(Pooling, AveragePoolNoTaps) {
+    // With dilation 3 and padding 2, the taps of the second column fall
+    // at -1 and 2, both outside the two input columns.
+    check(false, {{1, 3, 3, 2}, 3, 2, 1, 3, 1, 2, 1, 1, false});
+}
+
+TEST(Pooling, MaxPoolNan) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({1, 2, 4, 4}, DataType::Float32);
+    auto op = g->addOp<MaxPoolObj>(x, nullptr, 2, 2, 1, 1, 0, 0, 2, 2);
+    g->dataMalloc();
+    x->setData(RandomGenerator(-10, 10));
+    x->getRawDataPtr<float *>()[5] = NAN;
+    runtime->run(g);
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    EXPECT_TRUE(std::isnan(out[0]));
+    for (int i = 1; i < 8; ++i)
+        EXPECT_FALSE(std::isnan(out[i])) << i;
+}
+
+TEST(Pooling, GlobalAveragePool) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 5, 13, 17}, DataType::Float32);
+    auto op = g->addOp<GlobalAvgPoolObj>(x, nullptr);
+    g->dataMalloc();
+    x->setData(RandomGenerator(-10, 10));
+    runtime->run(g);
+    auto in = x->getRawDataPtr<float *>();
+    auto out = op->getOutput()->getRawDataPtr<float *>();
+    const size_t plane = 13 * 17;
+    for (size_t i = 0; i < 10; ++i) {
+        double sum = 0;
+        for (size_t j = 0; j < plane; ++j)
+            sum += in[i * plane + j];
+        EXPECT_NEAR(out[i], sum / plane, 1e-5) << i;
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,130 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/quantize.h"
+#include <cstring>
+
+#include "test.h"
+
+namespace infini {
+
+template <typename T>
+static void copyIn(const Tensor &t, const vector<T> &values) {
+    ASSERT_EQ(t->size(), values.size());
+    std::memcpy(t->getRawDataPtr<void *>(), values.data(),
+                values.size() * sizeof(T));
+}
+
+template <typename T> static vector<T> copyOut(const Tensor &t) {
+    auto p = t->getRawDataPtr<T *>();
+    return vector<T>(p, p + t->size());
+}
+
+// Rounding is half to even and the result saturates; NaN maps to the zero
+// point.
+TEST(Quantize, PerTensor) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({10}, DataType::Float32);
+    auto scale = g->addTensor({}, DataType::Float32);
+    auto zeroPoint = g->addTensor({}, DataType::Int8);
+    auto q = g->addOp<QuantizeLinearObj>(x, scale, zeroPoint, nullptr);
+    auto dq = g->addOp<DequantizeLinearObj>(q->getOutput(), scale, zeroPoint,
+                                            nullptr);
+    g->dataMalloc();
+    copyIn<float>(x, {0.f, 1.f, 3.f, 5.f, -3.f, -5.f, 1000.f, -1000.f, 7.2f,
+                      NAN});
+    copyIn<float>(scale, {2.f});
+    copyIn<int8_t>(zeroPoint, {3});
+    runtime->run(g);
+
+    EXPECT_EQ(copyOut<int8_t>(q->getOutput()),
+              (vector<int8_t>{3, 3, 5, 5, 1, 1, 127, -128, 7, 3}));
+    EXPECT_EQ(copyOut<float>(dq->getOutput()),
+              (vector<float>{0, 0, 4, 4, -4, -4, 248, -262, 8, 0}));
+}
+
+// One scale and zero point per channel of axis 1, over a tensor large enough
+// for several parallel chunks.
+TEST(Quantize, PerChannel) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    const int outer = 3, channels = 5, inner = 4001;
+    auto x = g->addTensor({outer, channels, inner}, DataType::Float32);
+    auto scale = g->addTensor({channels}, DataType::Float32);
+    auto zeroPoint = g->addTensor({channels}, DataType::UInt8);
+    auto q = g->addOp<QuantizeLinearObj>(x, scale, zeroPoint, nullptr);
+    auto dq = g->addOp<DequantizeLinearObj>(q->getOutput(), scale, zeroPoint,
+                                            nullptr);
+    g->dataMalloc();
+    vector<float> in(x->size());
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = float(int(i % 601) - 300) * 0.37f;
+    copyIn(x, in);
+    const vector<float> s{0.5f, 1.f, 2.f, 3.f, 4.f};
+    const vector<uint8_t> z{128, 0, 100, 255, 7};
+    copyIn(scale, s);
+    copyIn(zeroPoint, z);
+    runtime->run(g);
+
+    auto out = copyOut<uint8_t>(q->getOutput());
+    auto back = copyOut<float>(dq->getOutput());
+    for (size_t i = 0; i < in.size(); ++i) {
+        const size_t c = i / inner % channels;
+        float v = std::nearbyint(in[i] / s[c]) + z[c];
+        auto expect = uint8_t(std::min(255.f, std::max(0.f, v)));
+        ASSERT_EQ(out[i], expect) << "at " << i;
+        ASSERT_EQ(back[i], (float(expect) - z[c]) * s[c]) << "at " << i;
+    }
+}
+
+// Quantized weights and activations, an Int32 product and a per-channel
+// dequantization with scale = scaleA * scaleB[n] give back the Float32
+// product up to the quantization error.
+TEST(Quantize, QuantizedMatmul) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    const int m = 37, k = 203, n = 19;
+    auto a = g->addTensor({m, k}, DataType::Float32);
+    auto b = g->addTensor({n, k}, DataType::Float32);
+    auto scaleA = g->addTensor({1}, DataType::Float32);
+    auto scaleB = g->addTensor({n}, DataType::Float32);
+    auto scaleC = g->addTensor({n}, DataType::Float32);
+    auto qa = g->addOp<QuantizeLinearObj>(a, scaleA, nullptr, nullptr);
+    auto qb = g->addOp<QuantizeLinearObj>(b, scaleB, nullptr, nullptr, 0);
+    auto mm = g->addOp<MatmulObj>(qa->getOutput(), qb->getOutput(), nullptr,
+                                  false, true);
+    auto dq = g->addOp<DequantizeLinearObj>(mm->getOutput(), scaleC, nullptr,
+                                            nullptr, -1);
+    auto ref = g->addOp<MatmulObj>(a, b, nullptr, false, true);
+    g->dataMalloc();
+    a->setData(RandomGenerator(-1, 1, 1));
+    b->setData(RandomGenerator(-1, 1, 2));
+    vector<float> sb(n), sc(n);
+    for (int j = 0; j < n; ++j) {
+        sb[j] = (1.f + j) / 127.f;
+        sc[j] = sb[j] / 127.f;
+    }
+    copyIn<float>(scaleA, {1.f / 127.f});
+    copyIn(scaleB, sb);
+    copyIn(scaleC, sc);
+    // Row j of B lies in [-(1 + j), 1 + j], so that each channel uses its
+    // whole range.
+    auto pb = b->getRawDataPtr<float *>();
+    for (int j = 0; j < n; ++j)
+        for (int p = 0; p < k; ++p)
+            pb[j * k + p] *= 1.f + j;
+    runtime->run(g);
+
+    auto out = copyOut<float>(dq->getOutput());
+    auto expect = copyOut<float>(ref->getOutput());
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) {
+            // Each product is off by at most half a step of both operands.
+            double tolerance = k * 0.5 * (sb[j] + (1 + j) / 127.);
+            ASSERT_NEAR(out[i * n + j], expect[i * n + j], tolerance)
+                << "at " << i << ", " << j;
+        }
+}
+
+} // namespace infini
@@ -0,0 +1,156 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/reduce.h"
+#include "utils/data_generator.h"
+#include <cstring>
+
+#include "test.h"
+
+namespace infini {
+
+static Operator addReduce(const Graph &g, OpType type, const Tensor &x,
+                          const vector<int> &axes) {
+    if (type == OpType::ReduceSum)
+        return g->addOp<ReduceSumObj>(x, nullptr, axes);
+    if (type == OpType::ReduceMean)
+        return g->addOp<ReduceMeanObj>(x, nullptr, axes);
+    if (type == OpType::ReduceMax)
+        return g->addOp<ReduceMaxObj>(x, nullptr, axes);
+    return g->addOp<ReduceMinObj>(x, nullptr, axes);
+}
+
+// Runs a Reduce of `type` with keepdims over `in` and returns the output.
+static vector<float> runReduce(OpType type, const Shape &dims,
+                               const vector<int> &axes,
+                               const vector<float> &in) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(dims, DataType::Float32);
+    auto op = addReduce(g, type, x, axes);
+    g->dataMalloc();
+    std::memcpy(x->getRawDataPtr<void *>(), in.data(),
+                in.size() * sizeof(float));
+    runtime->run(g);
+    auto p = op->getOutput()->getRawDataPtr<float *>();
+    return vector<float>(p, p + op->getOutput()->size());
+}
+
+// Reduces in double, walking the input once and mapping every element to its
+// output index.
+static vector<double> reference(OpType type, const Shape &dims,
+                                const vector<int> &axes,
+                                const vector<float> &in) {
+    Shape outDims = dims;
+    for (int axis : axes)
+        outDims[axis] = 1;
+    size_t outSize = 1;
+    for (int d : outDims)
+        outSize *= d;
+    const bool sum = type == OpType::ReduceSum || type == OpType::ReduceMean;
+    vector<double> out(outSize, sum                        ? 0.
+                                : type == OpType::ReduceMax ? -INFINITY
+                                                            : INFINITY);
+    vector<int> index(dims.size(), 0);
+    for (size_t i = 0; i < in.size(); ++i) {
+        size_t o = 0;
+        for (size_t d = 0; d < dims.size(); ++d)
+            o = o * outDims[d] + (outDims[d] == 1 ? 0 : index[d]);
+        double v = in[i];
+        if (sum)
+            out[o] += v;
+        else if (type == OpType::ReduceMax)
+            out[o] = std::max(out[o], v);
+        else
+            out[o] = std::min(out[o], v);
+        for (int d = int(dims.size()) - 1; d >= 0 && ++index[d] == dims[d];
+             --d)
+            index[d] = 0;
+    }
+    if (type == OpType::ReduceMean)
+        for (auto &v : out)
+            v /= double(in.size() / outSize);
+    return out;
+}
+
+static void check(OpType type, const Shape &dims, const vector<int> &axes) {
+    size_t n = 1;
+    for (int d : dims)
+        n *= d;
+    vector<float> in(n);
+    RandomGenerator(-10, 10)(in.data(), n, DataType::Float32);
+    auto out = runReduce(type, dims, axes, in);
+    auto expect = reference(type, dims, axes, in);
+    ASSERT_EQ(out.size(), expect.size());
+    const bool exact = type == OpType::ReduceMax || type == OpType::ReduceMin;
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (exact)
+            ASSERT_EQ(out[i], float(expect[i])) << "at " << i;
+        else
+            ASSERT_NEAR(out[i], expect[i], 1e-5 * n / out.size() + 1e-4)
+                << type.toString() << " " << vecToString(dims) << " "
+                << vecToString(axes) << " at " << i;
+    }
+}
+
+static const OpType reduceTypes[] = {OpType::ReduceSum, OpType::ReduceMean,
+                                     OpType::ReduceMax, OpType::ReduceMin};
+
+TEST(Reduce, Axes) {
+    for (auto type : reduceTypes) {
+        check(type, {3, 5, 7}, {2});
+        check(type, {3, 5, 7}, {0});
+        check(type, {3, 5, 7}, {1});
+        check(type, {3, 5, 7}, {0, 2});
+        check(type, {4, 1, 6, 2, 5}, {1, 2, 4});
+        check(type, {3, 5, 7}, {0, 1, 2});
+        check(type, {3, 1, 7}, {1});
+    }
+}
+
+// Large enough for chunked rows, blocked columns and row groups.
+TEST(Reduce, Large) {
+    for (auto type : reduceTypes) {
+        check(type, {1000, 1000}, {0, 1});
+        check(type, {3, 100003}, {1});
+        check(type, {20000, 3}, {0});
+        check(type, {2, 1000, 5000}, {1});
+    }
+}
+
+TEST(Reduce, NanPropagates) {
+    for (OpType type : {OpType::ReduceMax, OpType::ReduceMin}) {
+        for (size_t pos : {0, 5, 17, 40000}) {
+            vector<float> in(50000);
+            RandomGenerator(-10, 10)(in.data(), in.size(), DataType::Float32);
+            in[pos] = NAN;
+            auto out = runReduce(type, {50000}, {0}, in);
+            EXPECT_TRUE(std::isnan(out[0])) << type.toString() << " " << pos;
+            auto cols = runReduce(type, {5000, 10}, {0}, in);
+            EXPECT_TRUE(std::isnan(cols[pos % 10]));
+            EXPECT_FALSE(std::isnan(cols[(pos + 1) % 10]));
+        }
+    }
+}
+
+// The partial results depend only on the shape, so the sums do not change
+// with the number of threads.
+TEST(Reduce, Deterministic) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    const vector<std::pair<Shape, vector<int>>> cases = {
+        {{1, 1 << 20}, {1}}, {{1 << 16, 16}, {0}}, {{4, 4096, 64}, {1}}};
+    for (const auto &[dims, axes] : cases) {
+        size_t n = 1;
+        for (int d : dims)
+            n *= d;
+        vector<float> in(n);
+        RandomGenerator(-10, 10)(in.data(), n, DataType::Float32);
+        runtime->setThreads(1, 1);
+        auto one = runReduce(OpType::ReduceSum, dims, axes, in);
+        runtime->setThreads(1);
+        auto many = runReduce(OpType::ReduceSum, dims, axes, in);
+        EXPECT_EQ(0, std::memcmp(one.data(), many.data(),
+                                 one.size() * sizeof(float)));
+    }
+}
+
+} // namespace infini
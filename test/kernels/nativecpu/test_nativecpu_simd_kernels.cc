@@ -0,0 +1,318 @@
+#include "core/runtime.h"
+#include "kernels/cpu/simd_kernels.h"
+#include <cstring>
+
+#include "test.h"
+
+namespace infini {
+
+// Every ISA table the host can run is checked against the scalar table.
+static vector<const SimdKernels *> availableTables() {
+    vector<const SimdKernels *> ret;
+    for (auto isa : {CpuIsa::SSE4, CpuIsa::AVX2, CpuIsa::AVX512})
+        if (auto table = getSimdKernels(isa))
+            ret.emplace_back(table);
+    return ret;
+}
+
+static vector<float> randomVector(size_t n, unsigned seed) {
+    vector<float> ret(n);
+    RandomGenerator(-4, 4, seed)(ret.data(), n, DataType::Float32);
+    return ret;
+}
+
+TEST(SimdKernels, Dispatch) {
+    const auto &cpu = CpuFeatures::getInstance();
+    const auto &table = getSimdKernels();
+    EXPECT_EQ(table.isa, cpu.getIsa());
+    EXPECT_NE(getSimdKernels(CpuIsa::Scalar), nullptr);
+    EXPECT_TRUE(cpu.supports(CpuIsa::Scalar));
+    EXPECT_TRUE(cpu.supports(cpu.getIsa()));
+    // Every level needs the features of the one below.
+    if (cpu.supports(CpuIsa::SSE4)) {
+        EXPECT_TRUE(cpu.hasSse41() && cpu.hasSse42());
+    }
+    if (cpu.supports(CpuIsa::AVX2)) {
+        EXPECT_TRUE(cpu.supports(CpuIsa::SSE4));
+        EXPECT_TRUE(cpu.hasAvx2() && cpu.hasFma() && cpu.hasF16c());
+    }
+    if (cpu.supports(CpuIsa::AVX512)) {
+        EXPECT_TRUE(cpu.supports(CpuIsa::AVX2));
+        EXPECT_TRUE(cpu.hasAvx512f() && cpu.hasAvx512bw() &&
+                    cpu.hasAvx512dq() && cpu.hasAvx512vl());
+    }
+    EXPECT_GT(cpu.getL1CacheSize(), 0u);
+    EXPECT_GE(cpu.getL2CacheSize(), cpu.getL1CacheSize());
+}
+
+TEST(SimdKernels, ElementWise) {
+    const auto *scalar = getSimdKernels(CpuIsa::Scalar);
+    for (size_t n : {0, 1, 7, 16, 37, 100}) {
+        auto a = randomVector(n, 1), b = randomVector(n, 2);
+        for (size_t i = 0; i < n; i += 5)
+            a[i] = std::numeric_limits<float>::quiet_NaN();
+        for (auto table : availableTables()) {
+            auto same = [&](const vector<float> &out,
+                            const vector<float> &expect) {
+                for (size_t i = 0; i < n; ++i)
+                    EXPECT_TRUE(out[i] == expect[i] ||
+                                (std::isnan(out[i]) && std::isnan(expect[i])))
+                        << cpu_isa_to_str(table->isa) << " at " << i;
+            };
+            for (auto [ref, kernels] :
+                 vector<pair<BinaryKernels<float>, BinaryKernels<float>>>{
+                     {scalar->add, table->add},
+                     {scalar->sub, table->sub},
+                     {scalar->mul, table->mul},
+                     {scalar->div, table->div}}) {
+                vector<float> expect(n), out(n);
+                ref.vv(a.data(), b.data(), expect.data(), n);
+                kernels.vv(a.data(), b.data(), out.data(), n);
+                same(out, expect);
+                ref.vs(a.data(), 0.7f, expect.data(), n);
+                kernels.vs(a.data(), 0.7f, out.data(), n);
+                same(out, expect);
+                ref.sv(b.data(), -1.3f, expect.data(), n);
+                kernels.sv(b.data(), -1.3f, out.data(), n);
+                same(out, expect);
+            }
+            vector<float> expect(n), out(n);
+            scalar->relu(a.data(), expect.data(), n);
+            table->relu(a.data(), out.data(), n);
+            EXPECT_EQ(out, expect) << cpu_isa_to_str(table->isa);
+            scalar->clip(a.data(), expect.data(), n, -1.f, 2.f);
+            table->clip(a.data(), out.data(), n, -1.f, 2.f);
+            for (size_t i = 0; i < n; ++i)
+                EXPECT_TRUE(out[i] == expect[i] ||
+                            (std::isnan(out[i]) && std::isnan(expect[i])))
+                    << cpu_isa_to_str(table->isa) << " at " << i;
+        }
+    }
+}
+
+TEST(SimdKernels, ElementWiseUInt32) {
+    const auto *scalar = getSimdKernels(CpuIsa::Scalar);
+    for (size_t n : {0, 1, 7, 16, 37, 100}) {
+        vector<uint32_t> a(n), b(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = uint32_t(i * 2654435761u);
+            b[i] = uint32_t(i * 40503u + 1);
+        }
+        for (auto table : availableTables()) {
+            for (auto [ref, kernels] :
+                 vector<pair<BinaryKernels<uint32_t>, BinaryKernels<uint32_t>>>{
+                     {scalar->addU32, table->addU32},
+                     {scalar->subU32, table->subU32},
+                     {scalar->mulU32, table->mulU32},
+                     {scalar->divU32, table->divU32}}) {
+                vector<uint32_t> expect(n), out(n);
+                ref.vv(a.data(), b.data(), expect.data(), n);
+                kernels.vv(a.data(), b.data(), out.data(), n);
+                EXPECT_EQ(out, expect) << cpu_isa_to_str(table->isa);
+                ref.vs(a.data(), 7u, expect.data(), n);
+                kernels.vs(a.data(), 7u, out.data(), n);
+                EXPECT_EQ(out, expect) << cpu_isa_to_str(table->isa);
+                ref.sv(b.data(), 100000u, expect.data(), n);
+                kernels.sv(b.data(), 100000u, out.data(), n);
+                EXPECT_EQ(out, expect) << cpu_isa_to_str(table->isa);
+            }
+        }
+    }
+}
+
+// Max and min match the scalar folds exactly, NaN included; the sums are
+// reassociated across the vector lanes.
+TEST(SimdKernels, Reduce) {
+    const auto *scalar = getSimdKernels(CpuIsa::Scalar);
+    for (size_t n : {0, 1, 7, 16, 37, 100, 1001}) {
+        auto a = randomVector(n, 3), b = randomVector(n, 4);
+        for (auto table : availableTables()) {
+            for (auto [ref, kernels] :
+                 vector<pair<ReduceKernels, ReduceKernels>>{
+                     {scalar->reduceSum, table->reduceSum},
+                     {scalar->reduceMax, table->reduceMax},
+                     {scalar->reduceMin, table->reduceMin}}) {
+                const bool exact = ref.all != scalar->reduceSum.all;
+                float expect = ref.all(a.data(), n);
+                float out = kernels.all(a.data(), n);
+                if (exact)
+                    EXPECT_EQ(out, expect) << cpu_isa_to_str(table->isa);
+                else
+                    EXPECT_NEAR(out, expect, 1e-4 * n)
+                        << cpu_isa_to_str(table->isa);
+                vector<float> accExpect = b, acc = b;
+                ref.accumulate(accExpect.data(), a.data(), n);
+                kernels.accumulate(acc.data(), a.data(), n);
+                EXPECT_EQ(acc, accExpect) << cpu_isa_to_str(table->isa);
+                if (exact && n > 5) {
+                    auto c = a;
+                    c[n - 5] = std::numeric_limits<float>::quiet_NaN();
+                    EXPECT_TRUE(std::isnan(kernels.all(c.data(), n)))
+                        << cpu_isa_to_str(table->isa);
+                }
+            }
+        }
+    }
+}
+
+TEST(SimdKernels, Softmax) {
+    const auto *scalar = getSimdKernels(CpuIsa::Scalar);
+    const float lowest = -std::numeric_limits<float>::max();
+    for (size_t n : {1, 7, 16, 37, 100, 1001}) {
+        auto a = randomVector(n, 5);
+        for (size_t i = 0; i < n; i += 4)
+            a[i] = a[i] * 20.f;
+        if (n > 1)
+            a[n / 2] = -INFINITY;
+        for (auto table : availableTables()) {
+            vector<float> expect(n), out(n);
+            scalar->softmax.row(a.data(), expect.data(), n);
+            table->softmax.row(a.data(), out.data(), n);
+            for (size_t i = 0; i < n; ++i)
+                EXPECT_NEAR(out[i], expect[i], 1e-6f + 1e-5f * expect[i])
+                    << cpu_isa_to_str(table->isa) << " at " << i;
+
+            vector<float> m(n, lowest), s(n, 0.f), mExpect = m, sExpect = s;
+            for (unsigned r = 0; r < 5; ++r) {
+                auto x = randomVector(n, 10 + r);
+                scalar->softmax.foldColumns(mExpect.data(), sExpect.data(),
+                                            x.data(), n);
+                table->softmax.foldColumns(m.data(), s.data(), x.data(), n);
+            }
+            EXPECT_EQ(m, mExpect) << cpu_isa_to_str(table->isa);
+            for (size_t i = 0; i < n; ++i)
+                EXPECT_NEAR(s[i], sExpect[i], 1e-5f * sExpect[i])
+                    << cpu_isa_to_str(table->isa) << " at " << i;
+            scalar->softmax.scaleColumns(a.data(), m.data(), s.data(),
+                                         expect.data(), n);
+            table->softmax.scaleColumns(a.data(), m.data(), s.data(),
+                                        out.data(), n);
+            for (size_t i = 0; i < n; ++i)
+                EXPECT_NEAR(out[i], expect[i], 1e-5f * std::abs(expect[i]))
+                    << cpu_isa_to_str(table->isa) << " at " << i;
+        }
+    }
+}
+
+TEST(SimdKernels, Norm) {
+    const auto *scalar = getSimdKernels(CpuIsa::Scalar);
+    for (size_t n : {0, 1, 7, 16, 37, 100, 1001}) {
+        auto a = randomVector(n, 6), gamma = randomVector(n, 7),
+             beta = randomVector(n, 8);
+        for (auto &v : a)
+            v += 10.f;
+        for (auto table : availableTables()) {
+            float mean, var, meanExpect, varExpect;
+            scalar->norm.meanVariance(a.data(), n, &meanExpect, &varExpect);
+            table->norm.meanVariance(a.data(), n, &mean, &var);
+            EXPECT_NEAR(mean, meanExpect, 1e-5f) << cpu_isa_to_str(table->isa);
+            EXPECT_NEAR(var, varExpect, 1e-5f) << cpu_isa_to_str(table->isa);
+            EXPECT_NEAR(table->norm.sumSquares(a.data(), n),
+                        scalar->norm.sumSquares(a.data(), n), 1e-5f * n * 100)
+                << cpu_isa_to_str(table->isa);
+            for (const float *b : vector<const float *>{beta.data(), nullptr}) {
+                vector<float> expect(n), out(n);
+                scalar->norm.normalize(a.data(), 10.f, 0.5f, gamma.data(), b,
+                                       expect.data(), n);
+                table->norm.normalize(a.data(), 10.f, 0.5f, gamma.data(), b,
+                                      out.data(), n);
+                for (size_t i = 0; i < n; ++i)
+                    EXPECT_NEAR(out[i], expect[i], 1e-6f)
+                        << cpu_isa_to_str(table->isa) << " at " << i;
+            }
+        }
+    }
+}
+
+TEST(SimdKernels, Transpose32) {
+    const size_t rows = 29, cols = 21, lds = 24, ldd = 33;
+    vector<uint32_t> src(rows * lds);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = uint32_t(i * 2654435761u);
+    vector<uint32_t> expect(cols * ldd, 0);
+    getSimdKernels(CpuIsa::Scalar)
+        ->transpose32(src.data(), lds, expect.data(), ldd, rows, cols);
+    for (auto table : availableTables()) {
+        vector<uint32_t> out(cols * ldd, 0);
+        table->transpose32(src.data(), lds, out.data(), ldd, rows, cols);
+        EXPECT_EQ(out, expect) << cpu_isa_to_str(table->isa);
+    }
+}
+
+TEST(SimdKernels, StreamCopy) {
+    vector<char> src(1000);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = char(i * 7);
+    for (auto table : availableTables())
+        for (size_t offset : {0, 1, 13, 31})
+            for (size_t bytes : {0, 5, 40, 200, 937}) {
+                vector<char> dst(1000 + 64, 0), expect(1000 + 64, 0);
+                std::memcpy(expect.data() + offset, src.data() + 3, bytes);
+                table->streamCopy(dst.data() + offset, src.data() + 3, bytes);
+                EXPECT_EQ(dst, expect) << cpu_isa_to_str(table->isa);
+            }
+}
+
+TEST(SimdKernels, GemmMicroKernel) {
+    const int kc = 37;
+    for (auto table : availableTables()) {
+        const int mr = table->sgemm.mr, nr = table->sgemm.nr, ldc = nr + 3;
+        auto a = randomVector(mr * kc, 3), b = randomVector(kc * nr, 4);
+        auto c = randomVector(mr * ldc, 5);
+        for (bool accumulate : {false, true}) {
+            auto out = c;
+            table->sgemm.kernel(kc, a.data(), b.data(), out.data(), ldc,
+                                accumulate);
+            for (int i = 0; i < mr; ++i)
+                for (int j = 0; j < nr; ++j) {
+                    double acc = accumulate ? c[i * ldc + j] : 0;
+                    for (int p = 0; p < kc; ++p)
+                        acc += double(a[p * mr + i]) * b[p * nr + j];
+                    EXPECT_NEAR(out[i * ldc + j], acc, 1e-3)
+                        << cpu_isa_to_str(table->isa);
+                }
+            // Padding columns of C are left alone.
+            for (int i = 0; i < mr; ++i)
+                for (int j = nr; j < ldc; ++j)
+                    EXPECT_EQ(out[i * ldc + j], c[i * ldc + j]);
+        }
+    }
+}
+
+// Includes the VNNI kernels on hosts that have them; extreme bytes check
+// that nothing saturates.
+TEST(SimdKernels, GemmU8S8MicroKernel) {
+    const int kq = 37;
+    for (auto table : availableTables()) {
+        const auto &desc = table->u8s8gemm;
+        const int mr = desc.mr, nr = desc.nr, ldc = nr + 3;
+        vector<uint8_t> a(4 * mr * kq);
+        vector<int8_t> b(4 * kq * nr);
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = i % 3 ? uint8_t(i * 2654435761u >> 24) : 255;
+        for (size_t i = 0; i < b.size(); ++i)
+            b[i] = i % 3 ? int8_t(i * 40503u >> 8) : -128;
+        vector<int32_t> c(mr * ldc);
+        for (size_t i = 0; i < c.size(); ++i)
+            c[i] = int32_t(i * 7919) - 50000;
+        for (bool accumulate : {false, true}) {
+            auto out = c;
+            desc.kernel(kq, a.data(), b.data(), out.data(), ldc, accumulate);
+            for (int i = 0; i < mr; ++i)
+                for (int j = 0; j < nr; ++j) {
+                    int32_t acc = accumulate ? c[i * ldc + j] : 0;
+                    for (int q = 0; q < kq; ++q)
+                        for (int p = 0; p < 4; ++p)
+                            acc += int32_t(a[(q * mr + i) * 4 + p]) *
+                                   b[(q * nr + j) * 4 + p];
+                    EXPECT_EQ(out[i * ldc + j], acc)
+                        << cpu_isa_to_str(table->isa);
+                }
+            for (int i = 0; i < mr; ++i)
+                for (int j = nr; j < ldc; ++j)
+                    EXPECT_EQ(out[i * ldc + j], c[i * ldc + j]);
+        }
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,130 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/softmax.h"
+#include "utils/data_generator.h"
+#include <cstring>
+
+#include "test.h"
+
+namespace infini {
+
+static vector<float> runSoftmax(const Shape &dims, int axis,
+                                const vector<float> &in) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(dims, DataType::Float32);
+    auto op = g->addOp<SoftmaxObj>(x, nullptr, axis);
+    g->dataMalloc();
+    std::memcpy(x->getRawDataPtr<void *>(), in.data(),
+                in.size() * sizeof(float));
+    runtime->run(g);
+    auto p = op->getOutput()->getRawDataPtr<float *>();
+    return vector<float>(p, p + op->getOutput()->size());
+}
+
+// Softmax in double with the max subtracted first.
+static vector<double> reference(const Shape &dims, int axis,
+                                const vector<float> &in) {
+    size_t outer = 1, inner = 1;
+    for (int i = 0; i < axis; ++i)
+        outer *= dims[i];
+    for (size_t i = axis + 1; i < dims.size(); ++i)
+        inner *= dims[i];
+    const size_t size = dims[axis];
+    vector<double> out(in.size());
+    for (size_t o = 0; o < outer; ++o)
+        for (size_t j = 0; j < inner; ++j) {
+            auto at = [&](size_t r) { return (o * size + r) * inner + j; };
+            double max = -INFINITY, sum = 0;
+            for (size_t r = 0; r < size; ++r)
+                max = std::max(max, double(in[at(r)]));
+            for (size_t r = 0; r < size; ++r)
+                sum += std::exp(in[at(r)] - max);
+            for (size_t r = 0; r < size; ++r)
+                out[at(r)] = std::exp(in[at(r)] - max) / sum;
+        }
+    return out;
+}
+
+static void check(const Shape &dims, int axis, const vector<float> &in) {
+    auto out = runSoftmax(dims, axis, in);
+    auto expect = reference(dims, axis, in);
+    for (size_t i = 0; i < out.size(); ++i)
+        ASSERT_NEAR(out[i], expect[i], 1e-6 + 1e-5 * expect[i])
+            << vecToString(dims) << " axis " << axis << " at " << i;
+}
+
+static void check(const Shape &dims, int axis) {
+    size_t n = 1;
+    for (int d : dims)
+        n *= d;
+    vector<float> in(n);
+    RandomGenerator(-10, 10)(in.data(), n, DataType::Float32);
+    check(dims, axis, in);
+}
+
+TEST(Softmax, Axes) {
+    for (int axis = 0; axis < 3; ++axis) {
+        check({3, 5, 7}, axis);
+        check({2, 17, 33}, axis);
+    }
+    check({1, 1}, 1);
+    check({4, 1}, 1);
+    check({4, 1}, 0);
+}
+
+// Long rows, many short rows and blocked columns, over several threads.
+TEST(Softmax, Large) {
+    check({3, 100003}, 1);
+    check({20000, 10}, 1);
+    check({4, 300, 1500}, 1);
+    check({2000, 64}, 0);
+}
+
+// Inputs far from 0 must not overflow the sum of exponentials, and -inf
+// entries, as produced by attention masks, get a probability of 0.
+TEST(Softmax, ExtremeValues) {
+    vector<float> in(40);
+    RandomGenerator(-1000, 1000)(in.data(), in.size(), DataType::Float32);
+    check({2, 20}, 1, in);
+    for (size_t i = 0; i < 40; i += 3)
+        in[i] = -INFINITY;
+    check({2, 20}, 1, in);
+    check({20, 2}, 0, in);
+    auto out = runSoftmax({2, 20}, 1, in);
+    for (size_t i = 0; i < 40; i += 3)
+        EXPECT_EQ(out[i], 0.f);
+
+    // A row that is entirely masked, or holds a NaN, is NaN as in the
+    // reference.
+    vector<float> nanRows = {-INFINITY, -INFINITY, -INFINITY, 1.f, NAN, 2.f};
+    out = runSoftmax({2, 3}, 1, nanRows);
+    for (float v : out)
+        EXPECT_TRUE(std::isnan(v));
+}
+
+// A softmax over an intermediate tensor writes over it.
+TEST(Softmax, InPlace) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    const Shape dims{8, 7, 300};
+    auto a = g->addTensor(dims, DataType::Float32);
+    auto b = g->addTensor(dims, DataType::Float32);
+    auto add = g->addOp<AddObj>(a, b, nullptr);
+    auto softmax = g->addOp<SoftmaxObj>(add->getOutput(), nullptr, 1);
+    g->dataMalloc();
+    EXPECT_EQ(softmax->getOutput()->getRawDataPtr<void *>(),
+              add->getOutput()->getRawDataPtr<void *>());
+    a->setData(RandomGenerator(-10, 10));
+    b->setData(ZeroGenerator());
+    auto pa = a->getRawDataPtr<float *>();
+    const vector<float> in(pa, pa + a->size());
+    runtime->run(g);
+    auto expect = reference(dims, 1, in);
+    auto out = softmax->getOutput()->getRawDataPtr<float *>();
+    for (size_t i = 0; i < expect.size(); ++i)
+        ASSERT_NEAR(out[i], expect[i], 1e-6 + 1e-5 * expect[i]) << i;
+}
+
+} // namespace infini
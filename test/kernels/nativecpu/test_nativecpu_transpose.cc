@@ -24,4 +24,58 @@ TEST(Transpose, NativeCpu) {
                                                           8, 9, 10, 11, 20, 21, 22, 23}));
 }
 
+// Index-by-index reference over merged, swapped, copied and large cases.
+TEST(Transpose, MatchesReference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    vector<pair<Shape, vector<int>>> cases{
+        {{5, 7}, {1, 0}},
+        {{3, 1, 67, 130}, {0, 1, 3, 2}},
+        {{2, 3, 4, 5}, {0, 2, 3, 1}},
+        {{2, 3, 4, 5}, {3, 2, 1, 0}},
+        {{2, 3, 4, 5}, {1, 0, 2, 3}},
+        {{2, 3, 4, 5}, {0, 1, 2, 3}},
+        {{1, 1, 1}, {2, 0, 1}},
+        {{16, 9, 8, 33}, {2, 0, 3, 1}},
+        {{4, 300, 200}, {0, 2, 1}}};
+    for (auto &[shape, permute] : cases) {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto input = g->addTensor(shape, DataType::Float32);
+        auto op = g->addOp<TransposeObj>(input, nullptr, permute);
+        g->dataMalloc();
+        input->setData(IncrementalGenerator());
+        runtime->run(g);
+
+        auto in = input->getRawDataPtr<float *>();
+        auto out = op->getOutput()->getRawDataPtr<float *>();
+        const int rank = shape.size();
+        vector<size_t> stride(rank);
+        for (int d = rank - 1, p = 1; d >= 0; p *= shape[d--])
+            stride[d] = p;
+        for (size_t o = 0; o < input->size(); ++o) {
+            size_t rest = o, offset = 0;
+            for (int j = rank - 1; j >= 0; --j) {
+                offset += rest % shape[permute[j]] * stride[permute[j]];
+                rest /= shape[permute[j]];
+            }
+            ASSERT_EQ(out[o], in[offset])
+                << vecToString(shape) << vecToString(permute) << " at " << o;
+        }
+    }
+}
+
+// Empty tensors, including a zero-sized innermost dim, are a no-op.
+TEST(Transpose, Empty) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    for (auto &permute : {vector<int>{1, 0, 2}, vector<int>{0, 2, 1}}) {
+        for (auto &shape : {Shape{2, 3, 0}, Shape{2, 0, 3}}) {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto input = g->addTensor(shape, DataType::Float32);
+            auto op = g->addOp<TransposeObj>(input, nullptr, permute);
+            g->dataMalloc();
+            EXPECT_EQ(op->getOutput()->size(), 0u);
+            EXPECT_NO_THROW(runtime->run(g));
+        }
+    }
+}
+
 } // namespace infini
@@ -0,0 +1,177 @@
+#include "core/execution_plan.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "kernels/cpu/simd_kernels.h"
+#include "operators/unary.h"
+#include "utils/data_generator.h"
+#include "utils/float16.h"
+#include <cfloat>
+#include <cstring>
+
+#include "test.h"
+
+namespace infini {
+
+template <class T>
+static void testUnary(const vector<float> &input,
+                      const std::function<double(double)> &reference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({(int)input.size()}, DataType::Float32);
+    auto op = g->addOp<T>(i, nullptr);
+    g->dataMalloc();
+    std::memcpy(i->getRawDataPtr<float *>(), input.data(),
+                input.size() * sizeof(float));
+    runtime->run(g);
+    auto out = op->getOutput()->template getRawDataPtr<float *>();
+    for (size_t k = 0; k < input.size(); ++k)
+        EXPECT_NEAR(out[k], reference(input[k]),
+                    1e-6 * std::max(1., std::abs(reference(input[k]))))
+            << op->getOpType().toString() << "(" << input[k] << ")";
+}
+
+TEST(Unary, Activations) {
+    // Long enough for the vector loops and a tail.
+    vector<float> input;
+    for (int k = -40; k <= 40; ++k)
+        input.emplace_back(k * 0.23f);
+    testUnary<ExpObj>(input, [](double x) { return std::exp(x); });
+    testUnary<SigmoidObj>(input,
+                          [](double x) { return 1 / (1 + std::exp(-x)); });
+    testUnary<TanhObj>(input, [](double x) { return std::tanh(x); });
+    testUnary<GeluObj>(input, [](double x) {
+        return 0.5 * x * std::erfc(-x / std::sqrt(2.));
+    });
+    testUnary<SiluObj>(input, [](double x) { return x / (1 + std::exp(-x)); });
+    testUnary<ErfObj>(input, [](double x) { return std::erf(x); });
+}
+
+// Enough elements for several parallel chunks, with one bound missing, run
+// directly and through a compiled plan.
+template <typename T> static void testClipLarge(DataType dtype) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({100003}, dtype);
+    auto lower = g->addOp<ClipObj>(i, nullptr, 3.f, std::nullopt);
+    auto both = g->addOp<ClipObj>(i, nullptr, 2.f, 7.f);
+    g->dataMalloc();
+    i->setData(RandomGenerator(0, 10));
+    const T *x = i->getRawDataPtr<T *>();
+    for (bool compiled : {false, true}) {
+        if (compiled) {
+            for (const Tensor &y : {lower->getOutput(), both->getOutput()})
+                std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+            runtime->run(runtime->compile(g));
+        } else
+            runtime->run(g);
+        auto y1 = lower->getOutput()->getRawDataPtr<T *>();
+        auto y2 = both->getOutput()->getRawDataPtr<T *>();
+        for (size_t k = 0; k < i->size(); ++k) {
+            ASSERT_EQ(y1[k], std::max(x[k], T(3))) << k;
+            ASSERT_EQ(y2[k], std::min(std::max(x[k], T(2)), T(7))) << k;
+        }
+    }
+}
+
+TEST(Unary, ClipLarge) {
+    testClipLarge<float>(DataType::Float32);
+    testClipLarge<uint32_t>(DataType::UInt32);
+}
+
+// Distance in units of the last place of the float nearest to `expect`.
+static double ulpError(float out, double expect) {
+    int exponent;
+    std::frexp(float(expect), &exponent);
+    return std::abs(out - expect) / std::ldexp(1., exponent - 24);
+}
+
+// Every ISA table stays within the bounds documented in
+// kernels/cpu/simd_math.h over a sweep of all float bit patterns.
+TEST(Unary, SimdMaxUlpError) {
+    struct Case {
+        const char *name;
+        UnaryF32Kernel SimdKernels::*kernel;
+        std::function<double(double)> reference;
+        double maxUlp;
+    };
+    vector<Case> cases{
+        {"exp", &SimdKernels::exp, [](double x) { return std::exp(x); }, 1.5},
+        {"sigmoid", &SimdKernels::sigmoid,
+         [](double x) { return 1 / (1 + std::exp(-x)); }, 2.5},
+        {"silu", &SimdKernels::silu,
+         [](double x) { return x / (1 + std::exp(-x)); }, 3},
+        {"tanh", &SimdKernels::tanh, [](double x) { return std::tanh(x); },
+         1.5},
+        {"erf", &SimdKernels::erf, [](double x) { return std::erf(x); }, 3},
+        {"gelu", &SimdKernels::gelu,
+         [](double x) { return 0.5 * x * std::erfc(-x / std::sqrt(2.)); }, 7},
+    };
+    vector<float> input;
+    for (uint64_t w = 0; w <= UINT32_MAX; w += 1021)
+        input.emplace_back(fp32_from_bits(uint32_t(w)));
+    vector<float> output(input.size());
+    for (auto isa : {CpuIsa::SSE4, CpuIsa::AVX2, CpuIsa::AVX512}) {
+        auto table = getSimdKernels(isa);
+        if (!table)
+            continue;
+        for (auto &c : cases) {
+            (table->*c.kernel)(input.data(), output.data(), input.size());
+            double worst = 0;
+            float worstInput = 0;
+            for (size_t k = 0; k < input.size(); ++k) {
+                double expect = c.reference(input[k]);
+                if (std::isnan(expect)) {
+                    EXPECT_TRUE(std::isnan(output[k]))
+                        << c.name << "(" << input[k] << ")";
+                    continue;
+                }
+                if (std::abs(expect) < FLT_MIN || std::abs(expect) > FLT_MAX)
+                    continue;
+                double error = ulpError(output[k], expect);
+                if (error > worst)
+                    worst = error, worstInput = input[k];
+            }
+            EXPECT_LE(worst, c.maxUlp) << cpu_isa_to_str(isa) << " " << c.name
+                                       << " at " << worstInput;
+        }
+    }
+}
+
+// Float16 and BFloat16 run the Float32 loop on the decoded values and round
+// its result once.
+TEST(Unary, NativeCpuHalf) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    const auto &simd = getSimdKernels();
+    for (auto dtype : {DataType::Float16, DataType::BFloat16}) {
+        auto half = getHalfConversions(simd, dtype);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto i = g->addTensor({3, 7001}, dtype);
+        auto gelu = g->addOp<GeluObj>(i, nullptr);
+        auto clip = g->addOp<ClipObj>(i, nullptr, -1.f, 2.f);
+        g->dataMalloc();
+        auto x = i->getRawDataPtr<uint16_t *>();
+        for (size_t k = 0; k < i->size(); ++k) {
+            float v = float(k % 97) * 0.1f - 5.f;
+            x[k] = dtype == DataType::Float16 ? float_to_float16(v)
+                                              : float_to_bfloat16(v);
+        }
+        runtime->run(g);
+
+        vector<float> in(i->size()), expect(i->size());
+        vector<uint16_t> rounded(i->size());
+        half.toF32(x, in.data(), in.size());
+        simd.gelu(in.data(), expect.data(), in.size());
+        half.fromF32(expect.data(), rounded.data(), in.size());
+        auto y = gelu->getOutput()->getRawDataPtr<uint16_t *>();
+        for (size_t k = 0; k < in.size(); ++k)
+            ASSERT_EQ(y[k], rounded[k]) << dtype.toString() << " at " << k;
+
+        simd.clip(in.data(), expect.data(), in.size(), -1.f, 2.f);
+        half.fromF32(expect.data(), rounded.data(), in.size());
+        y = clip->getOutput()->getRawDataPtr<uint16_t *>();
+        for (size_t k = 0; k < in.size(); ++k)
+            ASSERT_EQ(y[k], rounded[k]) << dtype.toString() << " at " << k;
+    }
+}
+
+} // namespace infini
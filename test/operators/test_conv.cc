@@ -0,0 +1,42 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/conv.h"
+#include "test.h"
+
+namespace infini {
+TEST(Conv, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 4, 9, 10}, DataType::Float32);
+    {
+        auto w = g->addTensor({6, 4, 3, 3}, DataType::Float32);
+        auto op = g->addOp<ConvObj>(x, w, nullptr, 1, 1);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 6, 9, 10}));
+        EXPECT_EQ(op->getNumGroups(), 1);
+    }
+    {
+        auto w = g->addTensor({6, 2, 3, 3}, DataType::Float32);
+        auto bias = g->addTensor({6}, DataType::Float32);
+        auto op = g->addOp<ConvObj>(x, w, nullptr, 0, 1, 2, 3, 1, 2, bias);
+        // (9 - 3) / 2 + 1 and (10 + 2 - 5) / 3 + 1
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 6, 4, 3}));
+        EXPECT_EQ(op->getNumGroups(), 2);
+        EXPECT_EQ(op->getBias(), bias);
+    }
+    {
+        auto w = g->addTensor({8, 1, 5, 5}, DataType::Float32);
+        auto op = g->addOp<ConvObj>(x, w, nullptr, 2, 2);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 8, 9, 10}));
+        EXPECT_EQ(op->getNumGroups(), 4);
+    }
+    // F has to be a multiple of the groups, and C of the weight channels.
+    auto bad = g->addTensor({6, 3, 3, 3}, DataType::Float32);
+    EXPECT_THROW(g->addOp<ConvObj>(x, bad, nullptr), Exception);
+    auto badGroups = g->addTensor({3, 2, 1, 1}, DataType::Float32);
+    EXPECT_THROW(g->addOp<ConvObj>(x, badGroups, nullptr), Exception);
+    // A kernel larger than the input is rejected whatever the stride.
+    auto small = g->addTensor({1, 4, 2, 2}, DataType::Float32);
+    auto w = g->addTensor({6, 4, 3, 3}, DataType::Float32);
+    EXPECT_THROW(g->addOp<ConvObj>(small, w, nullptr, 0, 0, 2, 2), Exception);
+}
+} // namespace infini
@@ -0,0 +1,51 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/gather.h"
+#include "test.h"
+
+namespace infini {
+TEST(Gather, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto data = g->addTensor({3, 4, 5}, DataType::Float32);
+    auto indices = g->addTensor({2, 6}, DataType::Int64);
+    {
+        auto op = g->addOp<GatherObj>(data, indices, nullptr);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 6, 4, 5}));
+        EXPECT_EQ(op->getOutput()->getDType(), DataType::Float32);
+    }
+    {
+        auto op = g->addOp<GatherObj>(data, indices, nullptr, -2);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{3, 2, 6, 5}));
+    }
+    {
+        auto scalar = g->addTensor({}, DataType::Int32);
+        auto op = g->addOp<GatherObj>(data, scalar, nullptr, 2);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{3, 4}));
+    }
+    auto floats = g->addTensor({2}, DataType::Float32);
+    EXPECT_THROW(g->addOp<GatherObj>(data, floats, nullptr), Exception);
+}
+
+TEST(EmbeddingBag, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto weight = g->addTensor({100, 16}, DataType::Float32);
+    {
+        auto indices = g->addTensor({10}, DataType::Int64);
+        auto offsets = g->addTensor({3}, DataType::Int64);
+        auto op = g->addOp<EmbeddingBagObj>(weight, indices, offsets, nullptr);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{3, 16}));
+    }
+    {
+        auto indices = g->addTensor({4, 5}, DataType::Int32);
+        auto op = g->addOp<EmbeddingBagObj>(weight, indices, nullptr, nullptr,
+                                            EmbeddingBagObj::Mode::Max);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{4, 16}));
+    }
+    // Bags of equal length need 2-D indices, offsets 1-D ones.
+    auto flat = g->addTensor({10}, DataType::Int32);
+    EXPECT_THROW(g->addOp<EmbeddingBagObj>(weight, flat, nullptr, nullptr),
+                 Exception);
+}
+} // namespace infini
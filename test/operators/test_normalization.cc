@@ -0,0 +1,31 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/normalization.h"
+#include "test.h"
+
+namespace infini {
+TEST(Normalization, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 3, 4}, DataType::Float32);
+    auto scale = g->addTensor({4}, DataType::Float32);
+    auto rowScale = g->addTensor({3, 4}, DataType::Float32);
+    auto ln = g->addOp<LayerNormObj>(x, scale, scale, nullptr);
+    EXPECT_EQ(ln->getAxis(), 2);
+    EXPECT_EQ(ln->getOutput()->getDims(), (Shape{2, 3, 4}));
+    EXPECT_EQ(ln->getBias(), scale);
+
+    auto ln1 = g->addOp<LayerNormObj>(x, rowScale, nullptr, nullptr, -2);
+    EXPECT_EQ(ln1->getAxis(), 1);
+    EXPECT_EQ(ln1->getBias(), nullptr);
+
+    auto rms = g->addOp<RMSNormObj>(x, scale, nullptr);
+    EXPECT_EQ(rms->getOpType(), OpType::RMSNormalization);
+    EXPECT_EQ(rms->getOutput()->getDims(), (Shape{2, 3, 4}));
+
+    // The scale has to match the normalized dimensions.
+    EXPECT_THROW(g->addOp<LayerNormObj>(x, scale, nullptr, nullptr, 1),
+                 Exception);
+    EXPECT_THROW(g->addOp<RMSNormObj>(x, rowScale, nullptr), Exception);
+}
+} // namespace infini
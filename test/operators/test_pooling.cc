@@ -0,0 +1,38 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/pooling.h"
+#include "test.h"
+
+namespace infini {
+TEST(Pooling, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 3, 10, 11}, DataType::Float32);
+    {
+        auto op = g->addOp<MaxPoolObj>(x, nullptr, 3, 3, 1, 1, 1, 1, 2, 2);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 5, 6}));
+    }
+    {
+        // (10 - 2) / 3 + 1 = 3 rows, or 4 rounding up; (11 - 5) / 2 + 1.
+        auto op = g->addOp<AvgPoolObj>(x, nullptr, 2, 3, 1, 2, 0, 0, 3, 2);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 3, 4}));
+        auto ceil =
+            g->addOp<AvgPoolObj>(x, nullptr, 2, 3, 1, 2, 0, 0, 3, 2, true);
+        EXPECT_EQ(ceil->getOutput()->getDims(), (Shape{2, 3, 4, 4}));
+    }
+    {
+        // Rounding up would start the last window in the right padding.
+        auto y = g->addTensor({1, 1, 4, 4}, DataType::Float32);
+        auto op = g->addOp<MaxPoolObj>(y, nullptr, 2, 2, 1, 1, 1, 1, 2, 2,
+                                       true);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{1, 1, 3, 3}));
+    }
+    {
+        auto op = g->addOp<GlobalAvgPoolObj>(x, nullptr);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 1, 1}));
+    }
+    // Padding as large as the window is rejected.
+    EXPECT_THROW(g->addOp<MaxPoolObj>(x, nullptr, 2, 2, 1, 1, 2, 0, 1, 1),
+                 Exception);
+}
+} // namespace infini
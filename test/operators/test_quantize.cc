@@ -0,0 +1,42 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/quantize.h"
+#include "test.h"
+
+namespace infini {
+TEST(Quantize, ShapeAndTypeInfer) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 3, 4}, DataType::Float32);
+    auto scale = g->addTensor({1}, DataType::Float32);
+    auto channelScale = g->addTensor({3}, DataType::Float32);
+    auto zeroPoint = g->addTensor({3}, DataType::UInt8);
+
+    auto q = g->addOp<QuantizeLinearObj>(x, scale, nullptr, nullptr);
+    EXPECT_EQ(q->getOutput()->getDims(), (Shape{2, 3, 4}));
+    EXPECT_EQ(q->getOutput()->getDType(), DataType::Int8);
+    EXPECT_FALSE(q->isPerChannel());
+
+    auto qc = g->addOp<QuantizeLinearObj>(x, channelScale, zeroPoint, nullptr,
+                                          -2);
+    EXPECT_EQ(qc->getOutput()->getDType(), DataType::UInt8);
+    EXPECT_TRUE(qc->isPerChannel());
+    EXPECT_EQ(qc->getAxis(), 1);
+
+    auto dq = g->addOp<DequantizeLinearObj>(qc->getOutput(), channelScale,
+                                            zeroPoint, nullptr);
+    EXPECT_EQ(dq->getOutput()->getDims(), (Shape{2, 3, 4}));
+    EXPECT_EQ(dq->getOutput()->getDType(), DataType::Float32);
+}
+
+TEST(Quantize, MatmulInt8Type) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor({5, 7}, DataType::UInt8);
+    auto b = g->addTensor({7, 3}, DataType::Int8);
+    auto op = g->addOp<MatmulObj>(a, b, nullptr);
+    EXPECT_EQ(op->getOutput()->getDims(), (Shape{5, 3}));
+    EXPECT_EQ(op->getOutput()->getDType(), DataType::Int32);
+}
+} // namespace infini
@@ -0,0 +1,32 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/reduce.h"
+#include "test.h"
+
+namespace infini {
+TEST(Reduce, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 3, 4, 5}, DataType::Float32);
+    {
+        auto op = g->addOp<ReduceSumObj>(x, nullptr, vector<int>{1, -1});
+        EXPECT_EQ(op->getAxes(), (vector<int>{1, 3}));
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 1, 4, 1}));
+    }
+    {
+        auto op =
+            g->addOp<ReduceMeanObj>(x, nullptr, vector<int>{3, 1, -3}, false);
+        EXPECT_EQ(op->getAxes(), (vector<int>{1, 3}));
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 4}));
+    }
+    {
+        auto op = g->addOp<ReduceMaxObj>(x, nullptr, std::nullopt);
+        EXPECT_EQ(op->getAxes(), (vector<int>{0, 1, 2, 3}));
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{1, 1, 1, 1}));
+    }
+    {
+        auto op = g->addOp<ReduceMinObj>(x, nullptr, std::nullopt, false);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{}));
+    }
+}
+} // namespace infini
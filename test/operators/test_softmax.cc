@@ -0,0 +1,17 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/softmax.h"
+#include "test.h"
+
+namespace infini {
+TEST(Softmax, ShapeInference) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({2, 3, 4}, DataType::Float32);
+    auto op = g->addOp<SoftmaxObj>(x, nullptr);
+    EXPECT_EQ(op->getAxis(), 2);
+    EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+    EXPECT_EQ(g->addOp<SoftmaxObj>(x, nullptr, -3)->getAxis(), 0);
+    EXPECT_EQ(g->addOp<SoftmaxObj>(x, nullptr, 1)->getAxis(), 1);
+}
+} // namespace infini